@@ -74,11 +74,9 @@ bool AdvancedScheduleAnalytics::advancedAcademicAnalytics(int scheduleId) {
   displayProgressAnimation("Initializing academic performance analyzer", 8);
 
   // Load schedule data with enhanced error handling
-  string scheduleFilename = "data/schedule_" + to_string(scheduleId) + ".csv";
-  ifstream scheduleFile(scheduleFilename);
-  if (!scheduleFile.is_open()) {
-    cout << BRIGHT_RED
-         << "ERROR: Could not access schedule file: " << scheduleFilename
+  vector<ConflictContext::LessonInfo> scheduledLessons;
+  if (!collectScheduleLessons(scheduleId, scheduledLessons)) {
+    cout << BRIGHT_RED << "ERROR: Could not access schedule " << scheduleId
          << RESET << endl;
     cout << BRIGHT_YELLOW
          << "Please ensure the schedule exists and is readable." << RESET
@@ -99,42 +97,27 @@ bool AdvancedScheduleAnalytics::advancedAcademicAnalytics(int scheduleId) {
   map<int, double> courseGrades;            // Store actual grades input by user
   map<int, set<string>> courseLessonTypes;  // Track lesson types per course
 
-  string line;
-  getline(scheduleFile, line);  // Skip header
-
-  while (getline(scheduleFile, line)) {
-    if (line.empty()) continue;
-
-    vector<string> fields = parseCSVLine(line);
-    if (fields.size() >= 10) {
-      try {
-        int courseId = stoi(fields[2]);
-        string lessonType = fields[1];
-        string teacher = fields[8];
-
-        // Add course if not already present
-        if (find(courseIds.begin(), courseIds.end(), courseId) ==
-            courseIds.end()) {
-          courseIds.push_back(courseId);
-          metrics.coursesCount++;
-        }
+  for (const ConflictContext::LessonInfo& lesson : scheduledLessons) {
+    int courseId = lesson.courseId;
+    const string& teacher = lesson.instructor;
 
-        // Track all lesson types for this course
-        courseLessonTypes[courseId].insert(lessonType);
+    // Add course if not already present
+    if (find(courseIds.begin(), courseIds.end(), courseId) ==
+        courseIds.end()) {
+      courseIds.push_back(courseId);
+      metrics.coursesCount++;
+    }
 
-        // Collect all instructors for this course
-        if (find(courseInstructors[courseId].begin(),
-                 courseInstructors[courseId].end(),
-                 teacher) == courseInstructors[courseId].end()) {
-          courseInstructors[courseId].push_back(teacher);
-        }
+    // Track all lesson types for this course
+    courseLessonTypes[courseId].insert(lesson.lessonType);
 
-      } catch (const exception&) {
-        continue;  // Skip malformed entries
-      }
+    // Collect all instructors for this course
+    if (find(courseInstructors[courseId].begin(),
+             courseInstructors[courseId].end(),
+             teacher) == courseInstructors[courseId].end()) {
+      courseInstructors[courseId].push_back(teacher);
     }
   }
-  scheduleFile.close();
 
   // Use course data already loaded by ScheduleManager through setDataReferences
   // Extract course names and credits for courses in the schedule
@@ -1,5 +1,6 @@
 #include "AdvancedScheduleAnalytics.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <fstream>
@@ -43,7 +44,12 @@ const string BG_CYAN = "\033[46m";
  * @brief Minimal constructor - the 3 main functions are in separate files
  */
 AdvancedScheduleAnalytics::AdvancedScheduleAnalytics()
-    : courses_ptr(nullptr), schedules_ptr(nullptr), courseLessons_ptr(nullptr) {
+    : courses_ptr(nullptr),
+      schedules_ptr(nullptr),
+      lessonTable_ptr(nullptr),
+      courseLessons_ptr(nullptr),
+      lessonIndex_ptr(nullptr),
+      compatibility_ptr(nullptr) {
   // Basic initialization only
   cout << BRIGHT_GREEN << "[SYSTEM] Advanced Analytics Engine ready" << RESET
        << endl;
@@ -54,10 +60,17 @@ AdvancedScheduleAnalytics::AdvancedScheduleAnalytics()
  */
 AdvancedScheduleAnalytics::AdvancedScheduleAnalytics(
     const vector<Course>& courses, const vector<Schedule>& schedules,
-    const map<int, vector<shared_ptr<Lesson>>>& courseLessons)
+    const LessonTable& lessonTable,
+    const map<int, vector<LessonRef>>& courseLessons,
+    const CourseLessonIndex& lessonIndex,
+    const SectionCompatibility& compatibility)
     : courses_ptr(&courses),
       schedules_ptr(&schedules),
-      courseLessons_ptr(&courseLessons) {
+      lessonTable_ptr(&lessonTable),
+      courseLessons_ptr(&courseLessons),
+      lessonIndex_ptr(&lessonIndex),
+      compatibility_ptr(&compatibility) {
+  catalogChanged();
   cout << BRIGHT_GREEN
        << "[SYSTEM] Advanced Analytics Engine initialized with data" << RESET
        << endl;
@@ -68,13 +81,18 @@ AdvancedScheduleAnalytics::AdvancedScheduleAnalytics(
  */
 void AdvancedScheduleAnalytics::setDataReferences(
     const vector<Course>& courses, const vector<Schedule>& schedules,
-    const map<int, vector<shared_ptr<Lesson>>>& courseLessons,
-    AddLessonFunction addCallback, RemoveLessonFunction removeCallback,
-    CreateScheduleFunction createCallback,
+    const LessonTable& lessonTable,
+    const map<int, vector<LessonRef>>& courseLessons,
+    const CourseLessonIndex& lessonIndex,
+    const SectionCompatibility& compatibility, AddLessonFunction addCallback,
+    RemoveLessonFunction removeCallback, CreateScheduleFunction createCallback,
     ReloadSystemDataFunction reloadCallback) {
   courses_ptr = &courses;
   schedules_ptr = &schedules;
+  lessonTable_ptr = &lessonTable;
   courseLessons_ptr = &courseLessons;
+  lessonIndex_ptr = &lessonIndex;
+  compatibility_ptr = &compatibility;
   addLessonCallback = addCallback;
   removeLessonCallback = removeCallback;
   createScheduleCallback = createCallback;
@@ -85,43 +103,64 @@ void AdvancedScheduleAnalytics::setDataReferences(
   for (const Course& course : courses) {
     courseCache[course.getCourseId()] = course;
   }
+  catalogChanged();
 }
 
-/**
- * @brief Destructor - Clean up async tasks
- */
-AdvancedScheduleAnalytics::~AdvancedScheduleAnalytics() {
-  // Wait for any pending async tasks to complete
-  for (auto& task : asyncTasks) {
-    if (task.valid()) {
-      task.wait();
-    }
+void AdvancedScheduleAnalytics::catalogChanged() {
+  if (!courses_ptr) return;  // Before setDataReferences()
+  vector<int> courseIds;
+  courseIds.reserve(courses_ptr->size());
+  for (const Course& course : *courses_ptr) {
+    courseIds.push_back(course.getCourseId());
   }
+  feasibilityCache.reset(courseIds);
 }
 
-vector<string> AdvancedScheduleAnalytics::parseCSVLine(
-    const string& line) const {
-  vector<string> result;
-  stringstream ss(line);
-  string field;
-  bool inQuotes = false;
-  string currentField;
-
-  for (char c : line) {
-    if (c == '"') {
-      inQuotes = !inQuotes;
-    } else if (c == ',' && !inQuotes) {
-      result.push_back(currentField);
-      currentField.clear();
-    } else {
-      currentField += c;
-    }
+void AdvancedScheduleAnalytics::feasibilityCacheReport(bool clear) {
+  FeasibilityCache::Stats stats = feasibilityCache.stats();
+  size_t answered = stats.hits + stats.proofHits;
+  size_t lookups = answered + stats.misses;
+
+  cout << "\n"
+       << BRIGHT_CYAN << BOLD << "FEASIBILITY CACHE" << RESET << endl;
+  cout << BRIGHT_WHITE << "  Lookups:        " << RESET << BRIGHT_YELLOW
+       << lookups << RESET << endl;
+  cout << BRIGHT_WHITE << "  Hits:           " << RESET << BRIGHT_GREEN
+       << stats.hits << RESET << " schedulable sets" << endl;
+  cout << BRIGHT_WHITE << "  Proof hits:     " << RESET << BRIGHT_GREEN
+       << stats.proofHits << RESET
+       << " sets containing a known unschedulable core" << endl;
+  cout << BRIGHT_WHITE << "  Misses:         " << RESET << BRIGHT_RED
+       << stats.misses << RESET << endl;
+  cout << BRIGHT_WHITE << "  Hit rate:       " << RESET << BRIGHT_YELLOW
+       << fixed << setprecision(1)
+       << (lookups ? 100.0 * answered / lookups : 0.0) << "%" << RESET
+       << endl;
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+  cout << BRIGHT_WHITE << "  Stored:         " << RESET << stats.entries
+       << " schedulable sets, " << stats.cores << " unschedulable cores"
+       << endl;
+  if (stats.full > 0 || stats.uncacheable > 0) {
+    cout << BRIGHT_WHITE << "  Not cached:     " << RESET << stats.full
+         << " (cache full), " << stats.uncacheable << " (unknown course)"
+         << endl;
   }
-  result.push_back(currentField);
+  cout << BRIGHT_WHITE << "  Invalidations:  " << RESET << stats.invalidations
+       << endl;
 
-  return result;
+  if (clear) {
+    feasibilityCache.invalidate();
+    feasibilityCache.resetStats();
+    cout << GREEN << "Feasibility cache cleared." << RESET << endl;
+  }
 }
 
+/**
+ * @brief Destructor - optimizerPool joins its threads
+ */
+AdvancedScheduleAnalytics::~AdvancedScheduleAnalytics() {}
+
 void AdvancedScheduleAnalytics::displayProgressAnimation(
     const string& operation, int steps) const {
   cout << BRIGHT_BLUE << operation << RESET << " ";
@@ -135,26 +174,6 @@ void AdvancedScheduleAnalytics::displayProgressAnimation(
 
 // =================== UTILITY METHODS FOR SEPARATED FILES ===================
 
-int AdvancedScheduleAnalytics::timeStringToMinutes(
-    const string& timeStr) const {
-  if (timeStr.empty()) return 0;
-
-  stringstream ss(timeStr);
-  string hourStr, minuteStr;
-
-  if (getline(ss, hourStr, ':') && getline(ss, minuteStr)) {
-    try {
-      int hours = stoi(hourStr);
-      int minutes = stoi(minuteStr);
-      return hours * 60 + minutes;
-    } catch (const exception&) {
-      return 0;
-    }
-  }
-
-  return 0;
-}
-
 string AdvancedScheduleAnalytics::minutesToTimeString(int minutes) const {
   int hours = minutes / 60;
   int mins = minutes % 60;
@@ -162,72 +181,21 @@ string AdvancedScheduleAnalytics::minutesToTimeString(int minutes) const {
          (mins < 10 ? "0" : "") + to_string(mins);
 }
 
-void AdvancedScheduleAnalytics::TimeSlotMatrix::setTimeSlot(int day, int hour,
-                                                            int minute,
-                                                            int duration) {
-  if (day < 0 || day >= DAYS_PER_WEEK) return;
-
-  int startSlot = (hour * 60 + minute) / 15;  // 15-minute slots
-  int endSlot = startSlot + (duration / 15);
-
-  for (int slot = startSlot; slot < endSlot && slot < 64; slot++) {
-    timeMatrix[day] |= (1ULL << slot);
-  }
-}
-
-bool AdvancedScheduleAnalytics::TimeSlotMatrix::hasConflict(
-    int day, int hour, int minute, int duration) const {
-  if (day < 0 || day >= DAYS_PER_WEEK) return false;
-
-  int startSlot = (hour * 60 + minute) / 15;
-  int endSlot = startSlot + (duration / 15);
-
-  for (int slot = startSlot; slot < endSlot && slot < 64; slot++) {
-    if (timeMatrix[day] & (1ULL << slot)) {
-      return true;
-    }
-  }
-
-  return false;
-}
-
-double AdvancedScheduleAnalytics::TimeSlotMatrix::getUtilizationRatio() const {
-  int totalSlots = 0;
-  int usedSlots = 0;
-
-  for (int day = 0; day < DAYS_PER_WEEK; day++) {
-    totalSlots += 64;  // 64 slots per day (16 hours * 4 slots per hour)
-
-    // Count set bits manually (cross-platform solution)
-    uint64_t bits = timeMatrix[day];
-    int count = 0;
-    while (bits) {
-      count += bits & 1;
-      bits >>= 1;
-    }
-    usedSlots += count;
-  }
-
-  return totalSlots > 0 ? static_cast<double>(usedSlots) / totalSlots : 0.0;
-}
-
-vector<shared_ptr<Lesson>> AdvancedScheduleAnalytics::loadLessonsForCourse(
+const vector<LessonRef>& AdvancedScheduleAnalytics::loadLessonsForCourse(
     int courseId, const string& lessonType) const {
-  vector<shared_ptr<Lesson>> lessons;
+  static const vector<LessonRef> none;
 
-  if (!courseLessons_ptr) return lessons;
+  if (!courseLessons_ptr || !lessonIndex_ptr) return none;
 
-  auto courseIt = courseLessons_ptr->find(courseId);
-  if (courseIt != courseLessons_ptr->end()) {
-    for (const auto& lesson : courseIt->second) {
-      if (lesson &&
-          (lessonType.empty() || lesson->getLessonType() == lessonType)) {
-        lessons.push_back(lesson);
-      }
-    }
+  if (lessonType.empty()) {
+    auto courseIt = courseLessons_ptr->find(courseId);
+    return courseIt != courseLessons_ptr->end() ? courseIt->second : none;
   }
 
-  return lessons;
+  // Split by type once at catalog load
+  LessonTable::Kind kind;
+  if (!LessonTable::parseKind(lessonType, kind)) return none;
+  return lessonIndex_ptr->groups(courseId, kind);
 }
 
 bool AdvancedScheduleAnalytics::tryAddCompleteCourse(int scheduleId,
@@ -245,7 +213,7 @@ bool AdvancedScheduleAnalytics::tryAddCompleteCourse(int scheduleId,
   int successCount = 0;
 
   for (const string& lessonType : lessonTypes) {
-    vector<shared_ptr<Lesson>> lessons =
+    const vector<LessonRef>& lessons =
         loadLessonsForCourse(courseId, lessonType);
     if (!lessons.empty()) {
       bool typeAdded = false;
@@ -297,7 +265,7 @@ bool AdvancedScheduleAnalytics::tryAddCompleteCourseBulletproof(
   vector<string> lessonTypes = {"lectures", "tutorials", "labs"};
 
   for (const string& lessonType : lessonTypes) {
-    vector<shared_ptr<Lesson>> lessons =
+    const vector<LessonRef>& lessons =
         loadLessonsForCourse(courseId, lessonType);
     if (!lessons.empty()) {
       totalAttempts++;
@@ -357,6 +325,103 @@ bool AdvancedScheduleAnalytics::tryAddCompleteCourseBulletproof(
   return successCount > 0;
 }
 
+const Schedule* AdvancedScheduleAnalytics::findSchedule(int scheduleId) const {
+  if (!schedules_ptr) return nullptr;
+  auto scheduleIt = find_if(schedules_ptr->begin(), schedules_ptr->end(),
+                            [scheduleId](const Schedule& schedule) {
+                              return schedule.getScheduleId() == scheduleId;
+                            });
+  return scheduleIt != schedules_ptr->end() ? &*scheduleIt : nullptr;
+}
+
+bool AdvancedScheduleAnalytics::collectScheduleLessons(
+    int scheduleId, vector<ConflictContext::LessonInfo>& lessons) const {
+  const Schedule* schedule = findSchedule(scheduleId);
+  if (!schedule || !lessonTable_ptr) return false;
+
+  const LessonTable& table = *lessonTable_ptr;
+  for (LessonRef ref : schedule->getLessons()) {
+    lessons.push_back(ConflictContext::LessonInfo(
+        table.courseId(ref), "", table.lessonType(ref), table.groupId(ref),
+        table.daySymbol(ref), table.startTime(ref),
+        table.durationMinutes(ref) / 60, table.classroomSymbol(ref),
+        table.buildingSymbol(ref), table.teacherSymbol(ref)));
+    lessons.back().lesson = ref;
+  }
+  return true;
+}
+
+vector<AdvancedScheduleAnalytics::ConflictContext>
+AdvancedScheduleAnalytics::detectConflicts(
+    const vector<ConflictContext::LessonInfo>& lessons) const {
+  vector<ConflictContext> conflicts;
+  if (!lessonTable_ptr) return conflicts;
+
+  vector<LessonRef> refs;
+  refs.reserve(lessons.size());
+  for (const ConflictContext::LessonInfo& info : lessons) {
+    refs.push_back(info.lesson);
+  }
+
+  for (const LessonConflict& found :
+       ConflictDetector::findAll(*lessonTable_ptr, refs)) {
+    const ConflictContext::LessonInfo& lesson1 = lessons[found.first];
+    const ConflictContext::LessonInfo& lesson2 = lessons[found.second];
+    int overlapMinutes = found.overlapMinutes;
+
+    // Calculate conflict severity (0.0 to 1.0)
+    double severity =
+        static_cast<double>(overlapMinutes) /
+        max(lessonTable_ptr->durationMinutes(lesson1.lesson),
+            lessonTable_ptr->durationMinutes(lesson2.lesson));
+
+    ConflictContext conflict(lesson1, lesson2, overlapMinutes, severity);
+    conflict.isResolvable = true;  // Handle ANY duration conflicts
+
+    // Resolution strategies based on conflict characteristics
+    conflict.resolutionStrategies.push_back("Advanced group substitution");
+    conflict.resolutionStrategies.push_back(
+        "Intelligent time slot optimization");
+    if (lesson1.classroom != lesson2.classroom) {
+      conflict.resolutionStrategies.push_back(
+          "Multi-room spatial reallocation");
+    }
+    if (overlapMinutes >= 120) {  // 2+ hour conflicts
+      conflict.resolutionStrategies.push_back("Deep schedule restructuring");
+      conflict.resolutionStrategies.push_back("Course priority rebalancing");
+    }
+    if (overlapMinutes >= 180) {  // 3+ hour conflicts
+      conflict.resolutionStrategies.push_back(
+          "Alternative course recommendation");
+      conflict.resolutionStrategies.push_back("Cross-semester optimization");
+    }
+
+    conflicts.push_back(conflict);
+  }
+  return conflicts;
+}
+
+bool AdvancedScheduleAnalytics::lessonsOverlap(LessonRef first,
+                                               LessonRef second) const {
+  if (compatibility_ptr && compatibility_ptr->covers(first) &&
+      compatibility_ptr->covers(second)) {
+    return compatibility_ptr->clash(first, second);
+  }
+
+  // A lesson kept only by a saved schedule: compare the times
+  const LessonTable& table = *lessonTable_ptr;
+  int start1 = table.startMinute(first);
+  int start2 = table.startMinute(second);
+  int end1 = start1 + table.durationMinutes(first);
+  int end2 = start2 + table.durationMinutes(second);
+  if (table.dayIndex(first) != table.dayIndex(second) ||
+      start1 == LessonTable::NO_START || start2 == LessonTable::NO_START ||
+      start1 == end1 || start2 == end2) {
+    return false;
+  }
+  return start1 < end2 && start2 < end1;
+}
+
 bool AdvancedScheduleAnalytics::tryDirectLessonAddition(int scheduleId,
                                                         int courseId) const {
   // Direct CSV file approach when callbacks fail
@@ -372,30 +437,26 @@ bool AdvancedScheduleAnalytics::tryDirectLessonAddition(int scheduleId,
     string lessonFilename =
         "data/" + to_string(courseId) + "_" + lessonType + ".csv";
 
-    ifstream lessonFile(lessonFilename);
-    if (!lessonFile.is_open()) {
+    CsvReader lessonFile(lessonFilename);
+    if (!lessonFile.isOpen()) {
       continue;  // Skip if lesson file doesn't exist
     }
 
     // Read the lesson file
-    string line;
-    getline(lessonFile, line);  // Skip header
+    lessonFile.nextRow();  // Skip header
 
     bool foundLesson = false;
-    while (getline(lessonFile, line) && !foundLesson) {
-      if (line.empty()) continue;
-
-      vector<string> fields = parseCSVLine(line);
-      if (fields.size() >= 8) {
+    while (!foundLesson && lessonFile.nextRow()) {
+      if (lessonFile.fieldCount() >= 8) {
         // Format:
         // courseId,day,startTime,duration,classroom,building,teacher,groupId
-        string day = fields[1];
-        string startTime = fields[2];
-        string duration = fields[3];
-        string classroom = fields[4];
-        string building = fields[5];
-        string teacher = fields[6];
-        string groupId = fields[7];
+        string day = lessonFile[1].str();
+        string startTime = lessonFile[2].str();
+        string duration = lessonFile[3].str();
+        string classroom = lessonFile[4].str();
+        string building = lessonFile[5].str();
+        string teacher = lessonFile[6].str();
+        string groupId = lessonFile[7].str();
 
         // Create lesson type name
         string lessonTypeName =
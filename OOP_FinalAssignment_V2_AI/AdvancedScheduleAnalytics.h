@@ -2,12 +2,12 @@
 #define ADVANCED_SCHEDULE_ANALYTICS_H
 
 #include <chrono>
-#include <cstring>
 #include <fstream>
 #include <functional>
 #include <future>
 #include <map>
 #include <memory>
+#include <random>
 #include <set>
 #include <string>
 #include <thread>
@@ -16,12 +16,23 @@
 #include <utility>
 #include <vector>
 
+#include "ConflictDetector.h"
 #include "Course.h"
+#include "CourseLessonIndex.h"
+#include "CsvReader.h"
+#include "FeasibilityCache.h"
 #include "Lab.h"
 #include "Lecture.h"
 #include "Lesson.h"
+#include "LessonTable.h"
+#include "ParetoFront.h"
 #include "Schedule.h"
+#include "SchedulePreferences.h"
+#include "SearchBudget.h"
+#include "SectionCompatibility.h"
+#include "TopSchedules.h"
 #include "Tutorial.h"
+#include "WorkerPool.h"
 
 using namespace std;
 
@@ -31,6 +42,9 @@ typedef function<bool(int, int, const string&)> RemoveLessonFunction;
 typedef function<int()>
     CreateScheduleFunction;  // Returns actual created schedule ID
 typedef function<void()> ReloadSystemDataFunction;
+// New best schedule of an anytime run: score, lessons, ms since the start
+typedef function<void(double, const vector<LessonRef>&, double)>
+    ScheduleImprovedFunction;
 
 /**
  * @class AdvancedScheduleAnalytics
@@ -60,19 +74,20 @@ class AdvancedScheduleAnalytics {
       string courseName;
       string lessonType;
       string groupId;
-      string day;
+      Symbol day;
       string startTime;
       int duration;
-      string classroom;
-      string building;
-      string instructor;
+      Symbol classroom;
+      Symbol building;
+      Symbol instructor;
       double creditWeight;
       int priority;
+      LessonRef lesson = 0;  // Row in the lesson table
 
       LessonInfo() = default;
       LessonInfo(int cId, const string& cName, const string& lType,
-                 const string& gId, const string& d, const string& st, int dur,
-                 const string& cls, const string& bld, const string& inst,
+                 const string& gId, Symbol d, const string& st, int dur,
+                 Symbol cls, Symbol bld, Symbol inst,
                  double cw = 0.0, int pri = 0)
           : courseId(cId),
             courseName(cName),
@@ -115,7 +130,7 @@ class AdvancedScheduleAnalytics {
     double conflictProbability;
     double workloadBalance;
     double instructorDiversity;
-    map<string, vector<shared_ptr<Lesson>>> scheduleMap;
+    map<string, vector<LessonRef>> scheduleMap;
     vector<string> constraints;
 
     OptimizationCandidate()
@@ -234,30 +249,14 @@ class AdvancedScheduleAnalytics {
         : courseId(0), currentRisk(0), improvementPotential(0) {}
   };
 
-  /**
-   * @struct TimeSlotMatrix
-   * @brief Optimized time slot representation using bit manipulation
-   */
-  struct TimeSlotMatrix {
-    static constexpr int DAYS_PER_WEEK = 7;
-    static constexpr int HOURS_PER_DAY = 24;
-    static constexpr int MINUTES_PER_HOUR = 60;
-
-    // Bit matrix for O(1) conflict detection
-    uint64_t timeMatrix[DAYS_PER_WEEK];  // Each bit = 15-minute slot
-
-    TimeSlotMatrix() { memset(timeMatrix, 0, sizeof(timeMatrix)); }
-
-    void setTimeSlot(int day, int hour, int minute, int duration);
-    bool hasConflict(int day, int hour, int minute, int duration) const;
-    double getUtilizationRatio() const;
-  };
-
   // =================== DATA ACCESS ===================
 
   mutable const vector<Course>* courses_ptr;
   mutable const vector<Schedule>* schedules_ptr;
-  mutable const map<int, vector<shared_ptr<Lesson>>>* courseLessons_ptr;
+  mutable const LessonTable* lessonTable_ptr;
+  mutable const map<int, vector<LessonRef>>* courseLessons_ptr;
+  mutable const CourseLessonIndex* lessonIndex_ptr;
+  mutable const SectionCompatibility* compatibility_ptr;
 
   // Function pointers for ScheduleManager operations
   mutable AddLessonFunction addLessonCallback;
@@ -267,23 +266,26 @@ class AdvancedScheduleAnalytics {
 
   // =================== PERFORMANCE OPTIMIZATION ===================
 
-  mutable unordered_map<string, vector<shared_ptr<Lesson>>> lessonCache;
+  mutable unordered_map<string, vector<LessonRef>> lessonCache;
   mutable unordered_map<int, Course> courseCache;
   mutable unordered_map<string, ConflictContext> conflictCache;
 
-  // Thread pool for asynchronous operations
-  mutable vector<future<void>> asyncTasks;
+  // Thread pool for candidate evaluation
+  mutable WorkerPool optimizerPool;
+
+  // Student time preferences, compiled against the loaded catalog
+  SchedulePreferences preferences;
+
+  // Solver answers by course set, for the current catalog and preferences
+  mutable FeasibilityCache feasibilityCache;
 
   // =================== ALGORITHM IMPLEMENTATIONS ===================
 
   // =================== UTILITY FUNCTIONS ===================
 
-  int timeStringToMinutes(const string& timeStr) const;
   string minutesToTimeString(int minutes) const;
 
-  vector<string> parseCSVLine(const string& line) const;
-
-  vector<shared_ptr<Lesson>> loadLessonsForCourse(
+  const vector<LessonRef>& loadLessonsForCourse(
       int courseId, const string& lessonType) const;
 
   double calculateQualityScore(const OptimizationCandidate& candidate) const;
@@ -376,12 +378,21 @@ class AdvancedScheduleAnalytics {
   double calculateTotalCredits(const vector<int>& courseIds) const;
 
  public:
+  /**
+   * @brief Default wall-clock budget of the advisor searches; a catalog
+   *        can hold hundreds of thousands of course sets
+   */
+  static const int ADVISOR_SEARCH_MS = 2000;
+
   /**
    * @brief Constructor - Initialize analytics engine with data access
    */
   AdvancedScheduleAnalytics(
       const vector<Course>& courses, const vector<Schedule>& schedules,
-      const map<int, vector<shared_ptr<Lesson>>>& courseLessons);
+      const LessonTable& lessonTable,
+      const map<int, vector<LessonRef>>& courseLessons,
+      const CourseLessonIndex& lessonIndex,
+      const SectionCompatibility& compatibility);
 
   /**
    * @brief Default constructor for when data is set later
@@ -393,12 +404,32 @@ class AdvancedScheduleAnalytics {
    */
   void setDataReferences(
       const vector<Course>& courses, const vector<Schedule>& schedules,
-      const map<int, vector<shared_ptr<Lesson>>>& courseLessons,
+      const LessonTable& lessonTable,
+      const map<int, vector<LessonRef>>& courseLessons,
+      const CourseLessonIndex& lessonIndex,
+      const SectionCompatibility& compatibility,
       AddLessonFunction addCallback = nullptr,
       RemoveLessonFunction removeCallback = nullptr,
       CreateScheduleFunction createCallback = nullptr,
       ReloadSystemDataFunction reloadCallback = nullptr);
 
+  /**
+   * @brief Renumber the courses for the feasibility cache and drop its
+   *        answers; call whenever the catalog is rebuilt
+   */
+  void catalogChanged();
+
+  /**
+   * @brief Print the feasibility cache's hit and miss counts
+   * @param clear Drop every cached answer and zero the counts afterwards
+   */
+  void feasibilityCacheReport(bool clear);
+
+  /** @brief The feasibility cache's counters, for benchmarks */
+  FeasibilityCache::Stats feasibilityCacheStats() const {
+    return feasibilityCache.stats();
+  }
+
   /**
    * @brief Destructor - Clean up async tasks and caches
    */
@@ -420,12 +451,17 @@ class AdvancedScheduleAnalytics {
    * - Real-time optimization recommendations
    *
    * @param scheduleId Schedule to analyze
+   * @param budgetMs Time allowed for automatic resolution once confirmed;
+   *        0 keeps the fixed three rounds, otherwise rounds continue (at
+   *        most 20) until the time runs out or a round fixes nothing
+   * @param cancel Stops the resolution rounds early; may be null
    * @return true if analysis completed successfully, false on error
    *
    * @complexity O(n log n) where n is number of lessons
    * @thread_safety Safe for concurrent read operations
    */
-  bool intelligentConflictResolution(int scheduleId);
+  bool intelligentConflictResolution(int scheduleId, double budgetMs = 0,
+                                     const CancellationToken* cancel = nullptr);
 
   /**
    * @brief Function 2: AI-Powered Optimal Schedule Generation
@@ -441,15 +477,112 @@ class AdvancedScheduleAnalytics {
    * - Predictive conflict avoidance
    * - Quality scoring with weighted preferences
    *
+   * Anytime mode: given a time budget or a cancellation token, every
+   * candidate is solved and scored with ScheduleQuality until the budget
+   * runs out, each better schedule is published as it is found, and the
+   * best one when the search stops is the one created.
+   *
    * @param targetCredits Target credit hours for the schedule
    * @param tolerance Acceptable deviation from target credits
+   * @param budgetMs Wall-clock budget; 0 with no token takes the first
+   *        schedulable candidate instead
+   * @param cancel Stops the anytime search early; may be null
+   * @param onImprove Told of each new best (on a pool thread); may be null
    * @return true if optimal schedule generated, false otherwise
    *
    * @complexity O(g * p * n) where g=generations, p=population, n=courses
    * @thread_safety Uses async operations for performance
    */
-  bool aiOptimalScheduleGeneration(double targetCredits,
-                                   double tolerance = 1.0);
+  bool aiOptimalScheduleGeneration(
+      double targetCredits, double tolerance = 1.0, double budgetMs = 0,
+      const CancellationToken* cancel = nullptr,
+      ScheduleImprovedFunction onImprove = nullptr);
+
+  /**
+   * @brief The best conflict-free schedules with distinct course sets, as
+   *        in-memory records; no schedule is created or written
+   *
+   * Every set of 2 to 6 courses within tolerance of the target is built in
+   * CreditSubsets order when a pool thread reaches it, solved, and scored
+   * with ScheduleQuality. TopSchedules keeps the best `count` whose course
+   * sets are at least minDistance (Jaccard) apart, so memory stays O(count)
+   * however many sets the catalog has.
+   *
+   * @param budgetMs Wall-clock budget, 0 for no limit (every set)
+   * @param cancel Stops the search early; may be null
+   * @param explored Receives how many course sets were solved; may be null
+   * @return The options, best first
+   */
+  vector<TopSchedules::Option> findTopSchedules(
+      double targetCredits, double tolerance, size_t count,
+      double minDistance, double budgetMs = ADVISOR_SEARCH_MS,
+      const CancellationToken* cancel = nullptr,
+      size_t* explored = nullptr) const;
+
+  /**
+   * @brief Set the time preferences the optimizer and findTopSchedules()
+   *        honour, e.g. "after=10:00 off=Friday max=6 gaps"
+   * @return false (and the old preferences stay) if the spec is invalid
+   *
+   * The spec is compiled into slot masks once, here; see
+   * SchedulePreferences.
+   */
+  bool setPreferences(const string& spec);
+
+  /** @brief Drop every preference */
+  void clearPreferences();
+
+  /** @brief The current preferences in setPreferences() form */
+  string describePreferences() const;
+
+  /**
+   * @brief Print findTopSchedules() for advisors to compare side by side
+   * @return false if no schedulable option was found
+   */
+  bool topScheduleComparison(double targetCredits, size_t count,
+                             double minDistance, double tolerance = 1.0,
+                             double budgetMs = ADVISOR_SEARCH_MS) const;
+
+  /**
+   * @brief Every trade-off between credit fit, compactness, free days and
+   *        early starts, in one search; no schedule is created or written
+   *
+   * The same course sets as findTopSchedules() are solved on the worker
+   * pool, but instead of collapsing the measurements into one score each
+   * schedule is offered to a ParetoFront. The result holds every schedule
+   * no other one beats on all four objectives, so a caller can offer any
+   * trade-off without searching again.
+   *
+   * @param budgetMs Wall-clock budget, 0 for no limit (every set)
+   * @param cancel Stops the search early; may be null
+   * @param explored Receives how many course sets were solved; may be null
+   * @return The front, lowest credit deviation first
+   */
+  vector<ParetoFront::Point> findParetoFront(
+      double targetCredits, double tolerance,
+      double budgetMs = ADVISOR_SEARCH_MS,
+      const CancellationToken* cancel = nullptr,
+      size_t* explored = nullptr) const;
+
+  /**
+   * @brief Print findParetoFront() as a table of trade-offs
+   * @return false if no schedulable option was found
+   */
+  bool paretoFrontComparison(double targetCredits, double tolerance = 1.0,
+                             double budgetMs = ADVISOR_SEARCH_MS) const;
+
+  /**
+   * @brief Schedule every student of a requests file in one run
+   *
+   * Unlike aiOptimalScheduleGeneration(), nothing goes through the schedule
+   * callbacks: each student's required courses are solved under their own
+   * preferences on the worker pool, sharing the loaded catalog, and the
+   * results are streamed to one CSV. See BulkScheduler for both formats.
+   *
+   * @return false if a file could not be opened or written
+   */
+  bool bulkScheduleGeneration(const string& requestsPath,
+                              const string& resultsPath) const;
 
   /**
    * @brief Function 3: Advanced Academic Performance Analytics
@@ -490,6 +623,53 @@ class AdvancedScheduleAnalytics {
    * @return true if at least one lesson was added, false otherwise
    */
   bool tryDirectLessonAddition(int scheduleId, int courseId) const;
+
+  /**
+   * @brief Lessons of a loaded schedule in conflict-analysis form
+   * @param lessons Receives one entry per lesson, durations in hours
+   * @return false if no schedule has this ID
+   */
+  bool collectScheduleLessons(
+      int scheduleId, vector<ConflictContext::LessonInfo>& lessons) const;
+
+  /** @return The loaded schedule with this ID, or nullptr */
+  const Schedule* findSchedule(int scheduleId) const;
+
+  /**
+   * @brief Every overlapping pair of collected lessons, with its resolution
+   *        strategies, in day and time order
+   */
+  vector<ConflictContext> detectConflicts(
+      const vector<ConflictContext::LessonInfo>& lessons) const;
+
+  /**
+   * @brief True if two lessons share any minute of the same day; a bit test
+   *        when both are catalog sections
+   */
+  bool lessonsOverlap(LessonRef first, LessonRef second) const;
+
+  /**
+   * @struct CourseCombination
+   * @brief A candidate course set for the optimizer
+   */
+  struct CourseCombination {
+    vector<int> courses;  // Positions in the loaded course list
+    double credits = 0;
+  };
+
+  /**
+   * @brief Course sets of 2 to 6 courses whose credits are within tolerance
+   *        of the target, at most 500, fewest courses first
+   * @param setsInRange Receives how many such sets the catalog has
+   *
+   * The sets are counted with CreditSubsets; when there are at most 500
+   * all of them are returned, otherwise a uniform sample. Works on the
+   * loaded course list only: no Course is copied and nothing is read from
+   * disk.
+   */
+  vector<CourseCombination> sampleCourseCombinations(
+      double targetCredits, double tolerance, mt19937& random,
+      double& setsInRange) const;
 };
 
 #endif  // ADVANCED_SCHEDULE_ANALYTICS_H
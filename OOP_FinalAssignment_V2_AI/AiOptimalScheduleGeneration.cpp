@@ -3,36 +3,18 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <vector>
 
 #include "AdvancedScheduleAnalytics.h"
-
-// Helper structures for conflict detection (from working function)
-struct ScheduledLesson {
-  int scheduleId;
-  string lessonType;
-  int courseId;
-  string day;
-  string startTime;
-  int duration;
-  string classroom;
-  string building;
-  string teacher;
-  string groupId;
-};
-
-struct TimeSlot {
-  string day;
-  string startTime;
-  int duration;
-  string classroom;
-  string building;
-  string teacher;
-  string groupId;
-};
+#include "BulkScheduler.h"
+#include "CandidateSearch.h"
+#include "CreditSubsets.h"
+#include "ScheduleQuality.h"
 
 // Colors for beautiful output
 const string RESET = "\033[0m";
@@ -45,57 +27,25 @@ const string BRIGHT_MAGENTA = "\033[95m";
 const string BRIGHT_CYAN = "\033[96m";
 const string BRIGHT_WHITE = "\033[97m";
 
-// Helper functions (from working function)
-int timeToMinutes(const string& timeStr) {
-  if (timeStr.empty()) return -1;
-
-  size_t colonPos = timeStr.find(':');
-  if (colonPos == string::npos) return -1;
+namespace {
 
-  try {
-    int hours = stoi(timeStr.substr(0, colonPos));
-    int minutes = stoi(timeStr.substr(colonPos + 1));
-    return hours * 60 + minutes;
-  } catch (const exception&) {
-    return -1;
-  }
+// Course sets are ranked by doubles, exact only up to 2^53 (and size_t may
+// be narrower); no budget gets that far, so the rest are left out
+size_t rankLimit(double count) {
+  double limit = min(9007199254740992.0,
+                     static_cast<double>(numeric_limits<size_t>::max()));
+  return static_cast<size_t>(min(count, limit));
 }
 
-vector<string> parseCSVLine(const string& line) {
-  vector<string> fields;
-  stringstream ss(line);
-  string field;
-
-  while (getline(ss, field, ',')) {
-    // Remove leading/trailing whitespace
-    field.erase(0, field.find_first_not_of(" \t"));
-    field.erase(field.find_last_not_of(" \t") + 1);
-    fields.push_back(field);
-  }
-
-  return fields;
-}
-
-bool checkTimeConflict(const TimeSlot& newLesson,
-                       const vector<ScheduledLesson>& existingLessons) {
-  for (const ScheduledLesson& existing : existingLessons) {
-    if (existing.day != newLesson.day) continue;
-
-    int existingStart = timeToMinutes(existing.startTime);
-    int existingEnd = existingStart + (existing.duration * 60);
-    int newStart = timeToMinutes(newLesson.startTime);
-    int newEnd = newStart + (newLesson.duration * 60);
-
-    // Check for overlap
-    if ((newStart < existingEnd) && (existingStart < newEnd)) {
-      return true;  // Conflict found
-    }
-  }
-  return false;  // No conflict
-}
+}  // namespace
 
 bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
-    double targetCredits, double tolerance) {
+    double targetCredits, double tolerance, double budgetMs,
+    const CancellationToken* cancel, ScheduleImprovedFunction onImprove) {
+  // The budget covers the whole run, sampling included
+  SearchBudget budget(budgetMs, cancel);
+  bool anytime = budget.limitMs() > 0 || cancel;
+
   if (tolerance <= 0) {
     tolerance = 0.15;
   }
@@ -122,6 +72,16 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
   cout << BRIGHT_WHITE << "Strategy: " << RESET << BRIGHT_GREEN
        << "Intelligent Course Selection with Conflict-Free Groups" << RESET
        << endl;
+  if (preferences.active()) {
+    cout << BRIGHT_WHITE << "Preferences: " << RESET << BRIGHT_MAGENTA
+         << describePreferences() << RESET << endl;
+  }
+  if (anytime) {
+    cout << BRIGHT_WHITE << "Mode: " << RESET << BRIGHT_MAGENTA
+         << "Anytime search";
+    if (budget.limitMs() > 0) cout << ", " << budget.limitMs() << " ms budget";
+    cout << RESET << endl;
+  }
 
   cout << "\n"
        << BRIGHT_CYAN
@@ -156,66 +116,27 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
   }
 
   // Get available courses from the loaded course data
-  if (!courses_ptr || courses_ptr->empty()) {
+  if (!courses_ptr || courses_ptr->empty() || !lessonTable_ptr ||
+      !lessonIndex_ptr || !compatibility_ptr) {
     cout << BRIGHT_RED << "ERROR: Could not load course data!" << RESET << endl;
     return false;
   }
 
-  vector<Course> allCourses =
+  const vector<Course>& allCourses =
       *courses_ptr;  // Use the courses loaded by ScheduleManager
 
   // INTELLIGENT ALGORITHM: Find best course combination with MULTIPLE ATTEMPTS
   // (like working function)
-  vector<Course> bestCombination;
-  double bestCredits = 0;
+  CourseCombination bestCombination;
   bool foundOptimal = false;
-  vector<vector<Course>> candidateCombinations;
-  map<int, vector<string>> courseGroupsAdded;
 
   // SMART ALGORITHM: Use random sampling instead of exhaustive search to avoid
   // combinatorial explosion
-
   random_device rd;
   mt19937 gen(rd());
-
-  // Try different course counts with MORE samples to find working combinations
-  for (int numCourses = 2; numCourses <= min(6, (int)allCourses.size());
-       numCourses++) {
-    int maxSamples =
-        min(5000, (int)allCourses.size() * 100);  // INCREASED samples to 5000
-    int sampleCount = 0;
-
-    for (int sample = 0; sample < maxSamples && sampleCount < 500;
-         sample++) {  // INCREASED candidates to 500
-      vector<Course> combination;
-      double totalCredits = 0;
-
-      // Randomly select numCourses different courses
-      vector<int> courseIndices;
-      for (int i = 0; i < (int)allCourses.size(); i++) {
-        courseIndices.push_back(i);
-      }
-      shuffle(courseIndices.begin(), courseIndices.end(), gen);
-
-      for (int i = 0; i < numCourses && i < (int)courseIndices.size(); i++) {
-        combination.push_back(allCourses[courseIndices[i]]);
-        totalCredits += allCourses[courseIndices[i]].getCredits();
-      }
-
-      // Check if credits are in target range
-      if (totalCredits >= targetCredits - tolerance &&
-          totalCredits <= targetCredits + tolerance) {
-        candidateCombinations.push_back(combination);
-        sampleCount++;
-      }
-    }
-
-    // If we found enough candidates, don't need to try more course counts
-    if (candidateCombinations.size() >=
-        500) {  // INCREASED threshold to 500 for better guarantees
-      break;
-    }
-  }
+  double setsInRange = 0;
+  vector<CourseCombination> candidateCombinations =
+      sampleCourseCombinations(targetCredits, tolerance, gen, setsInRange);
 
   // NOW TEST EACH COMBINATION TO FIND THE ONE THAT ACTUALLY WORKS (UP TO 500)
   size_t maxCombinationsToTest = min((size_t)500, candidateCombinations.size());
@@ -235,217 +156,92 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
     return false;
   }
 
-  // Track optimization statistics
-  int totalSamples = 0;
-  int candidatesFound = static_cast<int>(candidateCombinations.size());
-  int courseCombinations = 0;
-
+  // Exact group choice: one group of every lesson type each course offers,
+  // or a proof that the combination cannot avoid overlaps. The candidates
+  // are solved across the pool; the first schedulable one in sampling order
+  // wins, as it would in a sequential scan.
+  vector<vector<int>> candidateCourseIds(maxCombinationsToTest);
   for (size_t testIndex = 0; testIndex < maxCombinationsToTest; testIndex++) {
-    vector<Course> testCombination = candidateCombinations[testIndex];
-    double testCredits = 0;
-    for (const Course& course : testCombination) {
-      testCredits += course.getCredits();
+    for (int course : candidateCombinations[testIndex].courses) {
+      candidateCourseIds[testIndex].push_back(allCourses[course].getCourseId());
     }
+  }
 
-    courseCombinations++;
-
-    // Test this combination using IN-MEMORY conflict tracking (no CSV files)
-    vector<ScheduledLesson>
-        inMemorySchedule;  // Track lessons in memory instead of CSV
-    bool combinationWorked = true;
-    map<int, vector<string>> tempGroupsAdded;
-
-    for (const Course& course : testCombination) {
-      int courseId = course.getCourseId();
-      bool lectureAdded = false, labAdded = false, tutorialAdded = false;
-
-      // Try to add lecture - TRY ALL AVAILABLE GROUPS
-      string lectureFile = "data/" + to_string(courseId) + "_lectures.csv";
-      ifstream lectureCSV(lectureFile);
-      if (lectureCSV.is_open()) {
-        string line;
-        bool isFirstLine = true;
-
-        while (getline(lectureCSV, line)) {
-          if (isFirstLine) {
-            isFirstLine = false;
-            continue;
-          }
-
-          if (line.empty()) continue;
-
-          vector<string> fields = parseCSVLine(line);
-          if (fields.size() >= 8) {
-            TimeSlot timeSlot;
-            timeSlot.day = fields[1];
-            timeSlot.startTime = fields[2];
-            timeSlot.duration = stoi(fields[3]);
-            timeSlot.classroom = fields[4];
-            timeSlot.building = fields[5];
-            timeSlot.teacher = fields[6];
-            timeSlot.groupId = fields[7];
-
-            if (!checkTimeConflict(timeSlot, inMemorySchedule)) {
-              // Add to in-memory schedule instead of CSV
-              ScheduledLesson lesson;
-              lesson.scheduleId = newScheduleId;
-              lesson.lessonType = "Lecture";
-              lesson.courseId = courseId;
-              lesson.day = timeSlot.day;
-              lesson.startTime = timeSlot.startTime;
-              lesson.duration = timeSlot.duration;
-              lesson.classroom = timeSlot.classroom;
-              lesson.building = timeSlot.building;
-              lesson.teacher = timeSlot.teacher;
-              lesson.groupId = timeSlot.groupId;
-
-              inMemorySchedule.push_back(lesson);
-              tempGroupsAdded[courseId].push_back(timeSlot.groupId);
-              lectureAdded = true;
-              break;  // Found working group, stop searching
-            }
-          }
-        }
-        lectureCSV.close();
-      }
-
-      if (!lectureAdded) {
-        combinationWorked = false;
-        break;  // This combination won't work
-      }
-
-      // Try to add lab - TRY ALL AVAILABLE GROUPS
-      string labFile = "data/" + to_string(courseId) + "_labs.csv";
-      ifstream labCSV(labFile);
-      if (labCSV.is_open()) {
-        string line;
-        bool isFirstLine = true;
-
-        while (getline(labCSV, line)) {
-          if (isFirstLine) {
-            isFirstLine = false;
-            continue;
-          }
-
-          if (line.empty()) continue;
-
-          vector<string> fields = parseCSVLine(line);
-          if (fields.size() >= 8) {
-            TimeSlot timeSlot;
-            timeSlot.day = fields[1];
-            timeSlot.startTime = fields[2];
-            timeSlot.duration = stoi(fields[3]);
-            timeSlot.classroom = fields[4];
-            timeSlot.building = fields[5];
-            timeSlot.teacher = fields[6];
-            timeSlot.groupId = fields[7];
-
-            if (!checkTimeConflict(timeSlot, inMemorySchedule)) {
-              // Add to in-memory schedule instead of CSV
-              ScheduledLesson lesson;
-              lesson.scheduleId = newScheduleId;
-              lesson.lessonType = "Lab";
-              lesson.courseId = courseId;
-              lesson.day = timeSlot.day;
-              lesson.startTime = timeSlot.startTime;
-              lesson.duration = timeSlot.duration;
-              lesson.classroom = timeSlot.classroom;
-              lesson.building = timeSlot.building;
-              lesson.teacher = timeSlot.teacher;
-              lesson.groupId = timeSlot.groupId;
-
-              inMemorySchedule.push_back(lesson);
-              tempGroupsAdded[courseId].push_back(timeSlot.groupId);
-              labAdded = true;
-              break;  // Found working group, stop searching
-            }
-          }
-        }
-        labCSV.close();
-      }
-
-      if (!labAdded) {
-        combinationWorked = false;
-        break;
-      }
-
-      // Try to add tutorial - TRY ALL AVAILABLE GROUPS
-      string tutorialFile = "data/" + to_string(courseId) + "_tutorials.csv";
-      ifstream tutorialCSV(tutorialFile);
-      if (tutorialCSV.is_open()) {
-        string line;
-        bool isFirstLine = true;
-
-        while (getline(tutorialCSV, line)) {
-          if (isFirstLine) {
-            isFirstLine = false;
-            continue;
-          }
-
-          if (line.empty()) continue;
-
-          vector<string> fields = parseCSVLine(line);
-          if (fields.size() >= 8) {
-            TimeSlot timeSlot;
-            timeSlot.day = fields[1];
-            timeSlot.startTime = fields[2];
-            timeSlot.duration = stoi(fields[3]);
-            timeSlot.classroom = fields[4];
-            timeSlot.building = fields[5];
-            timeSlot.teacher = fields[6];
-            timeSlot.groupId = fields[7];
-
-            if (!checkTimeConflict(timeSlot, inMemorySchedule)) {
-              // Add to in-memory schedule instead of CSV
-              ScheduledLesson lesson;
-              lesson.scheduleId = newScheduleId;
-              lesson.lessonType = "Tutorial";
-              lesson.courseId = courseId;
-              lesson.day = timeSlot.day;
-              lesson.startTime = timeSlot.startTime;
-              lesson.duration = timeSlot.duration;
-              lesson.classroom = timeSlot.classroom;
-              lesson.building = timeSlot.building;
-              lesson.teacher = timeSlot.teacher;
-              lesson.groupId = timeSlot.groupId;
-
-              inMemorySchedule.push_back(lesson);
-              tempGroupsAdded[courseId].push_back(timeSlot.groupId);
-              tutorialAdded = true;
-              break;  // Found working group, stop searching
-            }
-          }
-        }
-        tutorialCSV.close();
-      }
+  CandidateSearch search(*lessonIndex_ptr, *compatibility_ptr, optimizerPool,
+                         &preferences, &feasibilityCache);
+  vector<LessonRef> bestAssignment;
+  size_t found;
+  if (anytime) {
+    // Anytime: score every schedulable candidate and publish each new best
+    // until the budget runs out
+    ScheduleQuality quality(*lessonTable_ptr, targetCredits, &preferences);
+    auto score = [&](size_t candidate, const vector<LessonRef>& lessons) {
+      return quality.score(lessons, candidateCombinations[candidate].credits);
+    };
+    auto improved = [&](size_t candidate, double value,
+                        const vector<LessonRef>& lessons, double elapsed) {
+      cout << BRIGHT_CYAN << "  [" << fixed << setprecision(2) << setw(8)
+           << elapsed << " ms] " << RESET << "New best: candidate "
+           << BRIGHT_YELLOW << (candidate + 1) << RESET << ", score "
+           << BRIGHT_GREEN << setprecision(3) << value << RESET << ", "
+           << setprecision(1) << candidateCombinations[candidate].credits
+           << " credits" << endl;
+      cout.unsetf(ios::floatfield);
+      cout << setprecision(6);
+      if (onImprove) onImprove(value, lessons, elapsed);
+    };
+    found = search.findBest(candidateCourseIds, score, budget, improved,
+                            bestAssignment);
+    cout << BRIGHT_WHITE << "Anytime search solved " << BRIGHT_YELLOW
+         << search.candidatesSolved() << "/" << maxCombinationsToTest << RESET
+         << BRIGHT_WHITE << " candidates in " << fixed << setprecision(2)
+         << budget.elapsedMs() << " ms ("
+         << (budget.cancelled()
+                 ? "cancelled"
+                 : search.candidatesSolved() < maxCombinationsToTest
+                       ? "budget spent"
+                       : "complete")
+         << ")" << RESET << endl;
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+  } else {
+    found = search.findFirst(candidateCourseIds, bestAssignment);
+  }
+  size_t searchNodes = search.nodesVisited();
 
-      if (!tutorialAdded) {
-        combinationWorked = false;
-        break;
+  // Track optimization statistics
+  int candidatesFound = static_cast<int>(candidateCombinations.size());
+  int courseCombinations = static_cast<int>(
+      anytime ? search.candidatesSolved()
+              : found == CandidateSearch::NOT_FOUND ? maxCombinationsToTest
+                                                    : found + 1);
+
+  if (found != CandidateSearch::NOT_FOUND) {
+    // Now that we found a working combination, add it to the REAL schedule
+    // using callbacks
+    for (LessonRef lesson : bestAssignment) {
+      if (addLessonCallback) {
+        addLessonCallback(newScheduleId, lessonTable_ptr->courseId(lesson),
+                          lessonTable_ptr->groupId(lesson));
       }
     }
 
-    if (combinationWorked) {
-      // Now that we found a working combination, add it to the REAL schedule
-      // using callbacks
-      for (const ScheduledLesson& lesson : inMemorySchedule) {
-        if (addLessonCallback) {
-          addLessonCallback(newScheduleId, lesson.courseId, lesson.groupId);
-        }
-      }
-
-      // Set the final results
-      bestCombination = testCombination;
-      bestCredits = testCredits;
-      courseGroupsAdded = tempGroupsAdded;
-      foundOptimal = true;
-      break;  // Found our optimal combination - stop testing
-    } else {
-      // inMemorySchedule automatically gets cleared on next iteration
-    }
+    // Set the final results
+    bestCombination = candidateCombinations[found];
+    foundOptimal = true;
   }
 
   // FINAL VALIDATION AND SUCCESS REPORTING
+  if (!foundOptimal && anytime &&
+      search.candidatesSolved() < maxCombinationsToTest) {
+    cout << BRIGHT_RED
+         << "OPTIMIZATION STOPPED: No schedulable combination found before "
+            "the search was stopped"
+         << RESET << endl;
+    cout << BRIGHT_YELLOW << "RECOMMENDATION: " << RESET << BRIGHT_WHITE
+         << "Allow a larger time budget" << RESET << endl;
+    return false;
+  }
   if (!foundOptimal) {
     cout << BRIGHT_RED
          << "OPTIMIZATION FAILED: No combination could be scheduled without "
@@ -489,9 +285,11 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
        << targetCredits << RESET << " (+/-" << tolerance << ")" << endl;
   cout << BRIGHT_WHITE << "  - Tested course combinations from 2 to 6 courses"
        << RESET << endl;
-  cout << BRIGHT_WHITE
-       << "  - Used random sampling (up to 2000 samples per course count)"
-       << RESET << endl;
+  cout << BRIGHT_WHITE << "  - Counted " << BRIGHT_YELLOW
+       << static_cast<long long>(setsInRange) << RESET
+       << " course sets in range by credit DP ("
+       << (setsInRange <= candidatesFound ? "testing all" : "uniform sample")
+       << ")" << endl;
   cout << BRIGHT_WHITE << "  - Generated " << BRIGHT_GREEN << candidatesFound
        << RESET << " candidate combinations within credit range" << endl;
 
@@ -501,43 +299,44 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
        << "/" << maxCombinationsToTest << RESET
        << " combinations for schedulability" << endl;
   cout << BRIGHT_WHITE
-       << "  - Used in-memory conflict detection (3 lessons per course: "
-          "lecture + lab + tutorial)"
-       << RESET << endl;
+       << "  - Used exact group search (one group per lesson type, "
+       << searchNodes << " groups tried)" << RESET << endl;
   cout << BRIGHT_WHITE
        << "  - Applied real-time conflict resolution across all time slots"
        << RESET << endl;
   cout << BRIGHT_WHITE << "  - Found optimal solution on attempt "
-       << BRIGHT_GREEN << courseCombinations << RESET << endl;
+       << BRIGHT_GREEN << (found + 1) << RESET << endl;
 
   cout << "\n"
        << BRIGHT_CYAN << "PHASE 4 - SCHEDULE CREATION:" << RESET << endl;
   cout << BRIGHT_WHITE << "  - Created Schedule ID: " << BRIGHT_YELLOW
        << newScheduleId << RESET << endl;
   cout << BRIGHT_WHITE << "  - Added " << BRIGHT_GREEN
-       << (bestCombination.size() * 3) << RESET << " lessons (3 per course)"
-       << endl;
+       << bestAssignment.size() << RESET
+       << " lessons (one group per lesson type)" << endl;
   cout << BRIGHT_WHITE
        << "  - Applied optimal group selections for zero conflicts" << RESET
        << endl;
-  cout << BRIGHT_WHITE << "  - Achieved " << BRIGHT_GREEN << bestCredits
-       << RESET << " credits (target: " << targetCredits << ")" << endl;
+  cout << BRIGHT_WHITE << "  - Achieved " << BRIGHT_GREEN
+       << bestCombination.credits << RESET << " credits (target: "
+       << targetCredits << ")" << endl;
 
   cout << "\n"
        << BRIGHT_BLUE << "=== OPTIMAL SCHEDULE RESULTS ===" << RESET << endl;
   cout << BRIGHT_WHITE << "Final Credits: " << RESET << BRIGHT_GREEN
-       << bestCredits << RESET << " (target: " << targetCredits << ")" << endl;
+       << bestCombination.credits << RESET << " (target: " << targetCredits
+       << ")" << endl;
   cout << BRIGHT_WHITE << "Courses Selected: " << RESET << BRIGHT_CYAN
-       << bestCombination.size() << RESET << endl;
+       << bestCombination.courses.size() << RESET << endl;
   cout << BRIGHT_WHITE << "Total Lessons: " << RESET << BRIGHT_CYAN
-       << (bestCombination.size() * 3) << RESET
-       << " (lecture + lab + tutorial per course)" << endl;
+       << bestAssignment.size() << RESET
+       << " (every lesson type of each course)" << endl;
   cout << BRIGHT_WHITE << "Conflicts Found: " << RESET << BRIGHT_GREEN << "ZERO"
        << RESET << " (fully optimized)" << endl;
 
   cout << "\n" << BRIGHT_WHITE << "Selected Courses:" << RESET << endl;
-  for (size_t i = 0; i < bestCombination.size(); i++) {
-    const Course& course = bestCombination[i];
+  for (size_t i = 0; i < bestCombination.courses.size(); i++) {
+    const Course& course = allCourses[bestCombination.courses[i]];
     cout << BRIGHT_CYAN << "  " << (i + 1) << ". " << BRIGHT_YELLOW
          << course.getCourseId() << RESET << " - " << course.getName() << " ("
          << BRIGHT_GREEN << course.getCredits() << RESET << " credits)" << endl;
@@ -557,3 +356,423 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(
        << RESET << endl;
   return true;
 }
+
+bool AdvancedScheduleAnalytics::setPreferences(const string& spec) {
+  SchedulePreferences::Spec parsed;
+  string error;
+  if (!SchedulePreferences::parse(spec, parsed, error)) {
+    cout << BRIGHT_RED << "ERROR: " << error << RESET << endl;
+    return false;
+  }
+  if (!lessonTable_ptr || !compatibility_ptr) {
+    cout << BRIGHT_RED << "ERROR: Could not load course data!" << RESET << endl;
+    return false;
+  }
+
+  // The compatibility matrix covers exactly the catalog sections
+  preferences.compile(parsed, *lessonTable_ptr, compatibility_ptr->size());
+  feasibilityCache.invalidate();  // Answers were for the old preferences
+  size_t allowed = 0;
+  for (size_t section = 0; section < compatibility_ptr->size(); section++) {
+    if (preferences.allowed(static_cast<LessonRef>(section))) allowed++;
+  }
+  cout << BRIGHT_GREEN << "Preferences set: " << RESET << BRIGHT_MAGENTA
+       << describePreferences() << RESET << " (" << allowed << "/"
+       << compatibility_ptr->size() << " sections allowed)" << endl;
+  return true;
+}
+
+void AdvancedScheduleAnalytics::clearPreferences() {
+  preferences.clear();
+  feasibilityCache.invalidate();
+}
+
+string AdvancedScheduleAnalytics::describePreferences() const {
+  return SchedulePreferences::describe(preferences.spec());
+}
+
+vector<TopSchedules::Option> AdvancedScheduleAnalytics::findTopSchedules(
+    double targetCredits, double tolerance, size_t count, double minDistance,
+    double budgetMs, const CancellationToken* cancel, size_t* explored) const {
+  SearchBudget budget(budgetMs, cancel);
+  if (explored) *explored = 0;
+  if (!courses_ptr || !lessonTable_ptr || !lessonIndex_ptr ||
+      !compatibility_ptr) {
+    return vector<TopSchedules::Option>();
+  }
+
+  const vector<Course>& allCourses = *courses_ptr;
+  vector<double> credits;
+  unordered_map<int, double> creditsById;  // Only read by the pool threads
+  credits.reserve(allCourses.size());
+  for (const Course& course : allCourses) {
+    credits.push_back(course.getCredits());
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+  CreditSubsets subsets(credits, targetCredits, tolerance, 2, 6);
+  ScheduleQuality quality(*lessonTable_ptr, targetCredits, &preferences);
+  TopSchedules top(count, minDistance);
+  mutex topMutex;
+
+  // Sets are unranked from the DP table on demand, never stored
+  auto candidate = [&](size_t rank, vector<int>& courseIds) {
+    for (int course : subsets.at(static_cast<double>(rank))) {
+      courseIds.push_back(allCourses[course].getCourseId());
+    }
+    sort(courseIds.begin(), courseIds.end());
+  };
+  auto solution = [&](size_t rank, const vector<int>& courseIds,
+                      const vector<LessonRef>& lessons) {
+    double total = 0;
+    for (int courseId : courseIds) total += creditsById.at(courseId);
+    double value = quality.score(lessons, total);
+
+    lock_guard<mutex> lock(topMutex);
+    if (!top.admits(value, rank)) return;
+    TopSchedules::Option option;
+    option.candidate = rank;
+    option.courseIds = courseIds;
+    option.lessons = lessons;
+    option.credits = total;
+    option.score = value;
+    top.offer(option);
+  };
+
+  CandidateSearch search(*lessonIndex_ptr, *compatibility_ptr, optimizerPool,
+                         &preferences, &feasibilityCache);
+  search.solveEach(rankLimit(subsets.count()), candidate, budget, solution);
+  if (explored) *explored = search.candidatesSolved();
+  return top.sorted();
+}
+
+bool AdvancedScheduleAnalytics::topScheduleComparison(double targetCredits,
+                                                      size_t count,
+                                                      double minDistance,
+                                                      double tolerance,
+                                                      double budgetMs) const {
+  cout << "\n";
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_BLUE << "|                  " << BOLD << BRIGHT_WHITE
+       << "TOP DIVERSE SCHEDULE OPTIONS FOR ADVISORS" << RESET << BRIGHT_BLUE
+       << "                |" << RESET << endl;
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_WHITE << "Target Credits: " << RESET << BRIGHT_YELLOW
+       << targetCredits << RESET << " (+/-" << BRIGHT_YELLOW << tolerance
+       << RESET << ")" << endl;
+  if (preferences.active()) {
+    cout << BRIGHT_WHITE << "Preferences: " << RESET << BRIGHT_MAGENTA
+         << describePreferences() << RESET << endl;
+  }
+  cout << BRIGHT_WHITE << "Options: " << RESET << BRIGHT_YELLOW << count
+       << RESET << ", at least " << BRIGHT_YELLOW << minDistance << RESET
+       << " Jaccard distance apart" << endl;
+
+  auto start = chrono::steady_clock::now();
+  size_t explored = 0;
+  vector<TopSchedules::Option> options = findTopSchedules(
+      targetCredits, tolerance, count, minDistance, budgetMs, nullptr,
+      &explored);
+  double elapsed =
+      chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+          .count();
+
+  cout << BRIGHT_WHITE << "Explored " << BRIGHT_YELLOW << explored << RESET
+       << BRIGHT_WHITE << " course sets in " << fixed << setprecision(2)
+       << elapsed << " ms" << RESET << endl;
+
+  if (options.empty()) {
+    cout << BRIGHT_RED << "No conflict-free schedule found for "
+         << targetCredits << " credits." << RESET << endl;
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    return false;
+  }
+
+  ScheduleQuality quality(*lessonTable_ptr, targetCredits, &preferences);
+  for (size_t i = 0; i < options.size(); i++) {
+    const TopSchedules::Option& option = options[i];
+    ScheduleQuality::Metrics metrics =
+        quality.measure(option.lessons, option.credits);
+    cout << "\n"
+         << BRIGHT_CYAN << "Option " << (i + 1) << RESET << ": score "
+         << BRIGHT_GREEN << setprecision(3) << option.score << RESET << ", "
+         << setprecision(1) << option.credits << " credits, "
+         << metrics.daysUsed << " days, " << metrics.gapMinutes
+         << " min of gaps" << endl;
+
+    // Each course with the groups the solver chose for it
+    for (int courseId : option.courseIds) {
+      cout << "    " << BRIGHT_YELLOW << courseId << RESET;
+      for (LessonRef lesson : option.lessons) {
+        if (lessonTable_ptr->courseId(lesson) == courseId) {
+          cout << " " << lessonTable_ptr->groupId(lesson);
+        }
+      }
+      cout << endl;
+    }
+  }
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+  return true;
+}
+
+vector<ParetoFront::Point> AdvancedScheduleAnalytics::findParetoFront(
+    double targetCredits, double tolerance, double budgetMs,
+    const CancellationToken* cancel, size_t* explored) const {
+  SearchBudget budget(budgetMs, cancel);
+  if (explored) *explored = 0;
+  if (!courses_ptr || !lessonTable_ptr || !lessonIndex_ptr ||
+      !compatibility_ptr) {
+    return vector<ParetoFront::Point>();
+  }
+
+  const vector<Course>& allCourses = *courses_ptr;
+  vector<double> credits;
+  unordered_map<int, double> creditsById;  // Only read by the pool threads
+  credits.reserve(allCourses.size());
+  for (const Course& course : allCourses) {
+    credits.push_back(course.getCredits());
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+  CreditSubsets subsets(credits, targetCredits, tolerance, 2, 6);
+  ScheduleQuality quality(*lessonTable_ptr, targetCredits, &preferences);
+  ParetoFront front;
+  mutex frontMutex;
+
+  auto candidate = [&](size_t rank, vector<int>& courseIds) {
+    for (int course : subsets.at(static_cast<double>(rank))) {
+      courseIds.push_back(allCourses[course].getCourseId());
+    }
+    sort(courseIds.begin(), courseIds.end());
+  };
+  auto solution = [&](size_t rank, const vector<int>& courseIds,
+                      const vector<LessonRef>& lessons) {
+    double total = 0;
+    for (int courseId : courseIds) total += creditsById.at(courseId);
+    ScheduleQuality::Metrics metrics = quality.measure(lessons, total);
+    double objectives[ParetoFront::OBJECTIVES];
+    objectives[ParetoFront::CREDIT_DEVIATION] = metrics.creditDeviation;
+    objectives[ParetoFront::IDLE_MINUTES] = metrics.gapMinutes;
+    objectives[ParetoFront::DAYS_USED] = metrics.daysUsed;
+    objectives[ParetoFront::EARLY_STARTS] = metrics.earlyStarts;
+
+    lock_guard<mutex> lock(frontMutex);
+    if (!front.admits(objectives, rank)) return;
+    ParetoFront::Point point;
+    point.candidate = rank;
+    point.courseIds = courseIds;
+    point.lessons = lessons;
+    point.credits = total;
+    copy(objectives, objectives + ParetoFront::OBJECTIVES, point.objectives);
+    front.offer(point);
+  };
+
+  CandidateSearch search(*lessonIndex_ptr, *compatibility_ptr, optimizerPool,
+                         &preferences, &feasibilityCache);
+  search.solveEach(rankLimit(subsets.count()), candidate, budget, solution);
+  if (explored) *explored = search.candidatesSolved();
+  return front.points();
+}
+
+bool AdvancedScheduleAnalytics::paretoFrontComparison(double targetCredits,
+                                                      double tolerance,
+                                                      double budgetMs) const {
+  cout << "\n";
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_BLUE << "|                   " << BOLD << BRIGHT_WHITE
+       << "PARETO FRONT OF SCHEDULE TRADE-OFFS" << RESET << BRIGHT_BLUE
+       << "                    |" << RESET << endl;
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_WHITE << "Target Credits: " << RESET << BRIGHT_YELLOW
+       << targetCredits << RESET << " (+/-" << BRIGHT_YELLOW << tolerance
+       << RESET << ")" << endl;
+  if (preferences.active()) {
+    cout << BRIGHT_WHITE << "Preferences: " << RESET << BRIGHT_MAGENTA
+         << describePreferences() << RESET << endl;
+  }
+
+  auto start = chrono::steady_clock::now();
+  size_t explored = 0;
+  vector<ParetoFront::Point> front =
+      findParetoFront(targetCredits, tolerance, budgetMs, nullptr, &explored);
+  double elapsed =
+      chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+          .count();
+
+  cout << BRIGHT_WHITE << "Explored " << BRIGHT_YELLOW << explored << RESET
+       << BRIGHT_WHITE << " course sets in " << fixed << setprecision(2)
+       << elapsed << " ms" << RESET << endl;
+
+  if (front.empty()) {
+    cout << BRIGHT_RED << "No conflict-free schedule found for "
+         << targetCredits << " credits." << RESET << endl;
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    return false;
+  }
+
+  cout << BRIGHT_WHITE << front.size() << " schedules; none is beaten on "
+       << "every objective by another" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(5) << "#" << setw(9)
+       << "Credits" << setw(8) << "Off by" << setw(10) << "Idle (h)"
+       << setw(11) << "Free days" << setw(14) << "Early starts" << "Courses"
+       << RESET << endl;
+  cout << BRIGHT_BLUE << string(76, '-') << RESET << endl;
+
+  // The first row best on each objective, for quick picks
+  size_t best[ParetoFront::OBJECTIVES] = {0, 0, 0, 0};
+  for (size_t i = 0; i < front.size(); i++) {
+    const ParetoFront::Point& point = front[i];
+    for (int objective = 0; objective < ParetoFront::OBJECTIVES;
+         objective++) {
+      if (point.objectives[objective] <
+          front[best[objective]].objectives[objective]) {
+        best[objective] = i;
+      }
+    }
+    ostringstream courseList;
+    for (size_t c = 0; c < point.courseIds.size(); c++) {
+      courseList << (c ? " " : "") << point.courseIds[c];
+    }
+    cout << BRIGHT_CYAN << setw(5) << (i + 1) << RESET << setprecision(1)
+         << setw(9) << point.credits << setw(8)
+         << point.objectives[ParetoFront::CREDIT_DEVIATION] << setw(10)
+         << point.objectives[ParetoFront::IDLE_MINUTES] / 60.0 << setw(11)
+         << static_cast<int>(7 - point.objectives[ParetoFront::DAYS_USED])
+         << setw(14)
+         << static_cast<int>(point.objectives[ParetoFront::EARLY_STARTS])
+         << BRIGHT_YELLOW << courseList.str() << RESET << endl;
+  }
+  cout << right;
+
+  cout << "\n"
+       << BRIGHT_WHITE << "Best fit: " << RESET << BRIGHT_GREEN << "#"
+       << best[ParetoFront::CREDIT_DEVIATION] + 1 << RESET
+       << BRIGHT_WHITE << "  Compact: " << RESET << BRIGHT_GREEN << "#"
+       << best[ParetoFront::IDLE_MINUTES] + 1 << RESET << BRIGHT_WHITE
+       << "  Free days: " << RESET << BRIGHT_GREEN << "#"
+       << best[ParetoFront::DAYS_USED] + 1 << RESET << BRIGHT_WHITE
+       << "  Late start: " << RESET << BRIGHT_GREEN << "#"
+       << best[ParetoFront::EARLY_STARTS] + 1 << RESET << endl;
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+  return true;
+}
+
+bool AdvancedScheduleAnalytics::bulkScheduleGeneration(
+    const string& requestsPath, const string& resultsPath) const {
+  if (!courses_ptr || !lessonTable_ptr || !lessonIndex_ptr ||
+      !compatibility_ptr) {
+    cout << BRIGHT_RED << "Catalog is not loaded." << RESET << endl;
+    return false;
+  }
+
+  cout << "\n";
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_BLUE << "|                  " << BOLD << BRIGHT_WHITE
+       << "BULK MULTI-STUDENT SCHEDULE GENERATION" << RESET << BRIGHT_BLUE
+       << "                  |" << RESET << endl;
+  cout << BRIGHT_BLUE
+       << "===================================================================="
+          "========"
+       << RESET << endl;
+  cout << BRIGHT_WHITE << "Requests: " << RESET << BRIGHT_YELLOW
+       << requestsPath << RESET << BRIGHT_WHITE << "  Results: " << RESET
+       << BRIGHT_YELLOW << resultsPath << RESET << endl;
+
+  BulkScheduler scheduler(*courses_ptr, *lessonTable_ptr, *lessonIndex_ptr,
+                          *compatibility_ptr, optimizerPool);
+  BulkScheduler::Summary summary;
+  string error;
+  if (!scheduler.run(requestsPath, resultsPath, summary, error)) {
+    cout << BRIGHT_RED << "Bulk generation failed: " << error << RESET
+         << endl;
+    return false;
+  }
+
+  cout << BRIGHT_WHITE << "Students:       " << RESET << BRIGHT_YELLOW
+       << summary.students << RESET << endl;
+  cout << BRIGHT_WHITE << "Scheduled:      " << RESET << BRIGHT_GREEN
+       << summary.scheduled << RESET << endl;
+  cout << BRIGHT_WHITE << "Unschedulable:  " << RESET << BRIGHT_RED
+       << summary.unschedulable << RESET << endl;
+  cout << BRIGHT_WHITE << "Invalid rows:   " << RESET << BRIGHT_RED
+       << summary.invalid << RESET << endl;
+  cout << BRIGHT_WHITE << "Time:           " << RESET << fixed
+       << setprecision(2) << summary.elapsedMs << " ms on "
+       << optimizerPool.size() << " threads" << endl;
+  cout << BRIGHT_WHITE << "Throughput:     " << RESET << BRIGHT_GREEN
+       << setprecision(0) << summary.studentsPerSecond() << " students/sec"
+       << RESET << endl;
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+  return true;
+}
+
+vector<AdvancedScheduleAnalytics::CourseCombination>
+AdvancedScheduleAnalytics::sampleCourseCombinations(double targetCredits,
+                                                    double tolerance,
+                                                    mt19937& random,
+                                                    double& setsInRange) const {
+  const size_t MAX_COMBINATIONS = 500;
+  const vector<Course>& allCourses = *courses_ptr;
+  vector<double> credits;
+  credits.reserve(allCourses.size());
+  for (const Course& course : allCourses) {
+    credits.push_back(course.getCredits());
+  }
+
+  CreditSubsets subsets(credits, targetCredits, tolerance, 2, 6);
+  setsInRange = subsets.count();
+
+  // Few enough to test them all; otherwise a uniform sample without repeats
+  vector<vector<int>> sets;
+  if (setsInRange <= MAX_COMBINATIONS) {
+    subsets.enumerate(sets, MAX_COMBINATIONS);
+  } else {
+    set<vector<int>> seen;
+    for (size_t draw = 0;
+         draw < 20 * MAX_COMBINATIONS && sets.size() < MAX_COMBINATIONS;
+         draw++) {
+      vector<int> drawn = subsets.sample(random);
+      if (seen.insert(drawn).second) sets.push_back(move(drawn));
+    }
+  }
+
+  // Fewest courses first, as before; random order within a size
+  shuffle(sets.begin(), sets.end(), random);
+  stable_sort(sets.begin(), sets.end(),
+              [](const vector<int>& a, const vector<int>& b) {
+                return a.size() < b.size();
+              });
+
+  vector<CourseCombination> combinations;
+  for (vector<int>& courses : sets) {
+    CourseCombination combination;
+    for (int course : courses) combination.credits += credits[course];
+    // Credits off the half-credit grid were rounded for the DP
+    if (combination.credits < targetCredits - tolerance - 1e-9 ||
+        combination.credits > targetCredits + tolerance + 1e-9) {
+      continue;
+    }
+    combination.courses = move(courses);
+    combinations.push_back(move(combination));
+  }
+  return combinations;
+}
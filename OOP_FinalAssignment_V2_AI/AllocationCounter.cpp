@@ -0,0 +1,70 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+#ifdef BENCHMARK_ALLOCATIONS
+
+namespace {
+atomic<size_t> heapAllocations(0);
+atomic<size_t> liveBytes(0);
+
+// Keeps the returned pointer aligned like malloc's
+const size_t HEADER_SIZE = alignof(max_align_t);
+}  // namespace
+
+bool heapCountingEnabled() { return true; }
+
+size_t heapAllocationCount() {
+  return heapAllocations.load(memory_order_relaxed);
+}
+
+size_t heapLiveBytes() { return liveBytes.load(memory_order_relaxed); }
+
+void* operator new(size_t size) {
+  heapAllocations.fetch_add(1, memory_order_relaxed);
+  char* block = static_cast<char*>(malloc(size + HEADER_SIZE));
+  if (!block) throw bad_alloc();
+  *reinterpret_cast<size_t*>(block) = size;
+  liveBytes.fetch_add(size, memory_order_relaxed);
+  return block + HEADER_SIZE;
+}
+
+void operator delete(void* pointer) noexcept {
+  if (!pointer) return;
+  char* block = static_cast<char*>(pointer) - HEADER_SIZE;
+  liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block),
+                      memory_order_relaxed);
+  free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  operator delete(pointer);
+}
+
+// The library's nothrow forms may not route through the replaced operator
+// new, and every block must carry the size header
+void* operator new(size_t size, const nothrow_t&) noexcept {
+  try {
+    return operator new(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* pointer, const nothrow_t&) noexcept {
+  operator delete(pointer);
+}
+
+#else  // BENCHMARK_ALLOCATIONS
+
+bool heapCountingEnabled() { return false; }
+
+size_t heapAllocationCount() { return 0; }
+
+size_t heapLiveBytes() { return 0; }
+
+#endif  // BENCHMARK_ALLOCATIONS
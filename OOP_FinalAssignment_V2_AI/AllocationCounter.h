@@ -0,0 +1,30 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * Heap counters for the benchmarks.
+ *
+ * Counting means replacing the global allocation functions, which is the
+ * only portable way to see every heap allocation but costs every
+ * allocation in the program a size header and two atomic updates. So it
+ * is compiled in only when BENCHMARK_ALLOCATIONS is defined, for benchmark
+ * builds; in the product the counters below always return 0.
+ */
+
+/** @brief True in a BENCHMARK_ALLOCATIONS build */
+bool heapCountingEnabled();
+
+/** @brief Number of global operator new calls since program start */
+size_t heapAllocationCount();
+
+/**
+ * @brief Bytes requested through operator new and not yet deleted
+ *
+ * Each block carries a small size header so operator delete can subtract
+ * it again; allocator overhead beyond the header is not included.
+ */
+size_t heapLiveBytes();
+
+#endif  // ALLOCATION_COUNTER_H
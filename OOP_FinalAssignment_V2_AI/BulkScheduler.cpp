@@ -0,0 +1,159 @@
+#include "BulkScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "CsvReader.h"
+#include "SchedulePreferences.h"
+#include "ScheduleQuality.h"
+#include "SectionSolver.h"
+
+const size_t BulkScheduler::BLOCK;
+
+BulkScheduler::BulkScheduler(const vector<Course>& courses,
+                             const LessonTable& lessonTable,
+                             const CourseLessonIndex& lessonIndex,
+                             const SectionCompatibility& compatibility,
+                             WorkerPool& pool)
+    : lessonTable(&lessonTable),
+      lessonIndex(&lessonIndex),
+      compatibility(&compatibility),
+      pool(&pool) {
+  for (const Course& course : courses) {
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+}
+
+bool BulkScheduler::run(const string& requestsPath,
+                        const string& resultsPath, Summary& summary,
+                        string& error) {
+  summary = Summary();
+  auto start = chrono::steady_clock::now();
+
+  CsvReader reader(requestsPath);
+  if (!reader.isOpen()) {
+    error = "cannot open " + requestsPath;
+    return false;
+  }
+  ofstream output(resultsPath);
+  if (!output) {
+    error = "cannot write " + resultsPath;
+    return false;
+  }
+  output << "student_id,status,credits,days,gap_minutes,sections,note\n";
+
+  reader.nextRow();  // Skip header
+
+  vector<Request> block;
+  vector<string> rows;
+  vector<char> statuses;
+  block.reserve(BLOCK);
+  bool more = true;
+  while (more) {
+    // Copy the next block out of the mapping
+    block.clear();
+    while (block.size() < BLOCK && (more = reader.nextRow())) {
+      Request request;
+      request.studentId = reader[0].str();
+      if (reader.fieldCount() > 1) request.courses = reader[1].str();
+      if (reader.fieldCount() > 2) request.preferences = reader[2].str();
+      block.push_back(move(request));
+    }
+    if (block.empty()) break;
+
+    rows.assign(block.size(), string());
+    statuses.assign(block.size(), 0);
+    pool->parallelFor(block.size(), [&](size_t i) {
+      statuses[i] = static_cast<char>(solve(block[i], rows[i]));
+    });
+
+    for (size_t i = 0; i < block.size(); i++) {
+      output << rows[i] << '\n';
+      switch (statuses[i]) {
+        case SCHEDULED:
+          summary.scheduled++;
+          break;
+        case UNSCHEDULABLE:
+          summary.unschedulable++;
+          break;
+        default:
+          summary.invalid++;
+      }
+    }
+    summary.students += block.size();
+  }
+
+  output.flush();
+  summary.elapsedMs =
+      chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+          .count();
+  if (!output) {
+    error = "writing " + resultsPath + " failed";
+    return false;
+  }
+  return true;
+}
+
+BulkScheduler::Status BulkScheduler::solve(const Request& request,
+                                           string& row) const {
+  ostringstream text;
+  text << request.studentId << ',';
+  auto invalid = [&](string note) {
+    // Quoted, as parse errors can contain commas
+    for (size_t quote = note.find('"'); quote != string::npos;
+         quote = note.find('"', quote + 2)) {
+      note.insert(quote, 1, '"');
+    }
+    text << "INVALID,,,,,\"" << note << '"';
+    row = text.str();
+    return INVALID;
+  };
+
+  vector<int> courseIds;
+  istringstream ids(request.courses);
+  int courseId;
+  while (ids >> courseId) courseIds.push_back(courseId);
+  if (!ids.eof()) return invalid("course IDs must be numbers");
+  sort(courseIds.begin(), courseIds.end());
+  courseIds.erase(unique(courseIds.begin(), courseIds.end()),
+                  courseIds.end());
+  if (courseIds.empty()) return invalid("no course IDs");
+  double credits = 0;
+  for (int id : courseIds) {
+    auto course = creditsById.find(id);
+    if (course == creditsById.end()) {
+      return invalid("unknown course " + to_string(id));
+    }
+    credits += course->second;
+  }
+
+  SchedulePreferences::Spec spec;
+  string problem;
+  if (!SchedulePreferences::parse(request.preferences, spec, problem)) {
+    return invalid(problem);
+  }
+  SchedulePreferences preferences;
+  preferences.compile(spec, *lessonTable, compatibility->size());
+
+  SectionSolver solver(*lessonIndex, *compatibility, &preferences);
+  vector<LessonRef> lessons;
+  if (!solver.solve(courseIds, lessons)) {
+    text << "UNSCHEDULABLE," << credits << ",,,,";
+    row = text.str();
+    return UNSCHEDULABLE;
+  }
+
+  ScheduleQuality quality(*lessonTable, credits, &preferences);
+  ScheduleQuality::Metrics metrics = quality.measure(lessons, credits);
+  text << "SCHEDULED," << credits << ',' << metrics.daysUsed << ','
+       << metrics.gapMinutes << ',';
+  for (size_t i = 0; i < lessons.size(); i++) {
+    text << (i ? " " : "") << lessonTable->courseId(lessons[i]) << ':'
+         << lessonTable->groupId(lessons[i]);
+  }
+  text << ',';
+  row = text.str();
+  return SCHEDULED;
+}
@@ -0,0 +1,91 @@
+#ifndef BULK_SCHEDULER_H
+#define BULK_SCHEDULER_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Course.h"
+#include "CourseLessonIndex.h"
+#include "LessonTable.h"
+#include "SectionCompatibility.h"
+#include "WorkerPool.h"
+
+using namespace std;
+
+/**
+ * @class BulkScheduler
+ * @brief Schedules a whole file of students against one catalog
+ *
+ * Each row of the requests file is one student:
+ *   student_id,courses,preferences
+ *   1001,31104 31401 31442,after=10:00 off=Friday
+ * where courses are course IDs and preferences a SchedulePreferences spec,
+ * both separated by spaces; the first row is a header. Every listed course
+ * is required: the student gets one group per lesson type of each, or the
+ * row is reported unschedulable.
+ *
+ * Rows are read in blocks of BLOCK. A block's students are solved on the
+ * pool, each with its own compiled preferences and SectionSolver, and the
+ * block's result rows are appended to the output in input order before the
+ * next block is read. Memory therefore stays O(BLOCK) however many
+ * students the file has, and the output does not depend on the thread
+ * count. The catalog structures are only read, so every thread shares
+ * them; nothing is added to the schedule store.
+ *
+ * Output rows:
+ *   student_id,status,credits,days,gap_minutes,sections,note
+ * status is SCHEDULED, UNSCHEDULABLE or INVALID; sections lists
+ * courseId:groupId pairs and note, quoted, says what was wrong with an
+ * INVALID row.
+ */
+class BulkScheduler {
+ public:
+  static const size_t BLOCK = 256;  // Students solved between writes
+
+  /** @brief What one run did */
+  struct Summary {
+    size_t students = 0;
+    size_t scheduled = 0;
+    size_t unschedulable = 0;
+    size_t invalid = 0;
+    double elapsedMs = 0;
+
+    double studentsPerSecond() const {
+      return elapsedMs > 0 ? students * 1000.0 / elapsedMs : 0;
+    }
+  };
+
+  BulkScheduler(const vector<Course>& courses, const LessonTable& lessonTable,
+                const CourseLessonIndex& lessonIndex,
+                const SectionCompatibility& compatibility, WorkerPool& pool);
+
+  /**
+   * @brief Solve every request in the input and write one row each
+   * @param error Receives what went wrong when it returns false
+   * @return false if a file could not be opened or written
+   */
+  bool run(const string& requestsPath, const string& resultsPath,
+           Summary& summary, string& error);
+
+ private:
+  enum Status { SCHEDULED, UNSCHEDULABLE, INVALID };
+
+  struct Request {
+    string studentId;
+    string courses;  // Parsed by the pool thread that solves it
+    string preferences;
+  };
+
+  // Solve one student into a result row, without the line break
+  Status solve(const Request& request, string& row) const;
+
+  const LessonTable* lessonTable;
+  const CourseLessonIndex* lessonIndex;
+  const SectionCompatibility* compatibility;
+  WorkerPool* pool;
+  unordered_map<int, double> creditsById;
+};
+
+#endif  // BULK_SCHEDULER_H
@@ -0,0 +1,211 @@
+#include "CandidateSearch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "SectionSolver.h"
+
+const size_t CandidateSearch::NOT_FOUND = static_cast<size_t>(-1);
+const size_t CandidateSearch::CHUNK;
+
+CandidateSearch::CandidateSearch(const CourseLessonIndex& lessonIndex,
+                                 const SectionCompatibility& compatibility,
+                                 WorkerPool& pool,
+                                 const SchedulePreferences* preferences,
+                                 FeasibilityCache* cache)
+    : lessonIndex(&lessonIndex),
+      compatibility(&compatibility),
+      pool(&pool),
+      preferences(preferences),
+      cache(cache) {}
+
+bool CandidateSearch::solveCandidate(SectionSolver& solver,
+                                     const vector<int>& courseIds,
+                                     vector<LessonRef>& assignment,
+                                     size_t& visited) const {
+  FeasibilityCache::Key key;
+  if (!cache || !cache->key(courseIds, key)) {
+    if (cache) cache->countUncacheable();
+    bool found = solver.solve(courseIds, assignment);
+    visited = solver.nodesVisited();
+    return found;
+  }
+
+  visited = 0;
+  FeasibilityCache::Answer answer = cache->lookup(key, assignment);
+  if (answer == FeasibilityCache::SCHEDULABLE) return true;
+  if (answer == FeasibilityCache::UNSCHEDULABLE) {
+    assignment.clear();
+    return false;
+  }
+
+  bool found = solver.solve(courseIds, assignment);
+  visited = solver.nodesVisited();
+  if (found) {
+    cache->storeSchedulable(key, assignment);
+    return true;
+  }
+
+  // Drop every course the others are unschedulable without; the schedulable
+  // subsets met on the way are worth keeping too
+  vector<int> core = courseIds;
+  vector<int> without;
+  vector<LessonRef> partial;
+  FeasibilityCache::Key partKey;
+  for (size_t i = 0; i < core.size() && core.size() > 1;) {
+    without = core;
+    without.erase(without.begin() + i);
+    bool schedulable = solver.solve(without, partial);
+    visited += solver.nodesVisited();
+    if (!schedulable) {
+      core.swap(without);
+      continue;
+    }
+    cache->key(without, partKey);
+    cache->storeSchedulable(partKey, partial);
+    i++;
+  }
+  cache->key(core, key);
+  cache->storeCore(key);
+  assignment.clear();
+  return false;
+}
+
+size_t CandidateSearch::findFirst(const vector<vector<int>>& candidates,
+                                  vector<LessonRef>& assignment) {
+  size_t count = candidates.size();
+  vector<vector<LessonRef>> solutions(count);
+  vector<size_t> candidateNodes(count, 0);
+  atomic<size_t> first(count);
+
+  pool->parallelFor((count + CHUNK - 1) / CHUNK, [&](size_t chunk) {
+    SectionSolver solver(*lessonIndex, *compatibility, preferences);
+    size_t end = min(count, (chunk + 1) * CHUNK);
+    for (size_t i = chunk * CHUNK; i < end; i++) {
+      // Anything after a solved candidate can no longer be the answer
+      if (i > first.load()) return;
+      bool solved = solveCandidate(solver, candidates[i], solutions[i],
+                                   candidateNodes[i]);
+      if (!solved) continue;
+
+      size_t current = first.load();
+      while (i < current && !first.compare_exchange_weak(current, i)) {
+      }
+      return;
+    }
+  });
+
+  // Every candidate before `first` was solved and failed, whatever the
+  // thread count, so the count below is deterministic too
+  size_t found = first.load();
+  nodes = 0;
+  for (size_t i = 0; i < count && i <= found; i++) nodes += candidateNodes[i];
+  if (found == count) {
+    assignment.clear();
+    return NOT_FOUND;
+  }
+  assignment = move(solutions[found]);
+  return found;
+}
+
+size_t CandidateSearch::findBest(const vector<vector<int>>& candidates,
+                                 const ScoreFunction& score,
+                                 const SearchBudget& budget,
+                                 const ImprovementFunction& onImprove,
+                                 vector<LessonRef>& assignment) {
+  size_t count = candidates.size();
+  vector<size_t> candidateNodes(count, 0);
+  vector<char> done(count, 0);
+  mutex bestMutex;
+  size_t best = NOT_FOUND;
+  double bestScore = 0;
+  assignment.clear();
+
+  pool->parallelFor((count + CHUNK - 1) / CHUNK, [&](size_t chunk) {
+    SectionSolver solver(*lessonIndex, *compatibility, preferences);
+    vector<LessonRef> solution;
+    size_t end = min(count, (chunk + 1) * CHUNK);
+    for (size_t i = chunk * CHUNK; i < end; i++) {
+      // Once the budget is spent the remaining chunks drain at once
+      if (budget.expired()) return;
+      bool solvedHere =
+          solveCandidate(solver, candidates[i], solution, candidateNodes[i]);
+      done[i] = 1;
+      if (!solvedHere) continue;
+
+      double value = score(i, solution);
+      lock_guard<mutex> lock(bestMutex);
+      if (best != NOT_FOUND &&
+          (value < bestScore || (value == bestScore && i > best))) {
+        continue;
+      }
+      best = i;
+      bestScore = value;
+      assignment = solution;
+      if (onImprove) onImprove(i, value, assignment, budget.elapsedMs());
+    }
+  });
+
+  nodes = 0;
+  solved = 0;
+  for (size_t i = 0; i < count; i++) {
+    nodes += candidateNodes[i];
+    solved += done[i];
+  }
+  return best;
+}
+
+void CandidateSearch::solveEach(size_t count,
+                                const CandidateFunction& candidate,
+                                const SearchBudget& budget,
+                                const SolutionFunction& onSolution) {
+  // Totals, not per-candidate slots, so memory does not grow with count
+  atomic<size_t> totalNodes(0);
+  atomic<size_t> totalSolved(0);
+
+  pool->parallelFor((count + CHUNK - 1) / CHUNK, [&](size_t chunk) {
+    SectionSolver solver(*lessonIndex, *compatibility, preferences);
+    vector<int> courseIds;
+    vector<LessonRef> solution;
+    size_t chunkNodes = 0;
+    size_t chunkSolved = 0;
+    size_t end = min(count, (chunk + 1) * CHUNK);
+    for (size_t i = chunk * CHUNK; i < end && !budget.expired(); i++) {
+      courseIds.clear();
+      candidate(i, courseIds);
+      size_t visited = 0;
+      bool solvedHere = solveCandidate(solver, courseIds, solution, visited);
+      chunkNodes += visited;
+      chunkSolved++;
+      if (solvedHere) onSolution(i, courseIds, solution);
+    }
+    totalNodes += chunkNodes;
+    totalSolved += chunkSolved;
+  });
+
+  nodes = totalNodes.load();
+  solved = totalSolved.load();
+}
+
+void CandidateSearch::solveAll(const vector<vector<int>>& candidates,
+                               vector<char>& schedulable) {
+  size_t count = candidates.size();
+  schedulable.assign(count, 0);
+  vector<size_t> candidateNodes(count, 0);
+
+  pool->parallelFor((count + CHUNK - 1) / CHUNK, [&](size_t chunk) {
+    SectionSolver solver(*lessonIndex, *compatibility, preferences);
+    vector<LessonRef> assignment;
+    size_t end = min(count, (chunk + 1) * CHUNK);
+    for (size_t i = chunk * CHUNK; i < end; i++) {
+      schedulable[i] =
+          solveCandidate(solver, candidates[i], assignment, candidateNodes[i])
+              ? 1
+              : 0;
+    }
+  });
+
+  nodes = 0;
+  for (size_t visited : candidateNodes) nodes += visited;
+}
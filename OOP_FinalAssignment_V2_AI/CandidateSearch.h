@@ -0,0 +1,148 @@
+#ifndef CANDIDATE_SEARCH_H
+#define CANDIDATE_SEARCH_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "CourseLessonIndex.h"
+#include "FeasibilityCache.h"
+#include "SchedulePreferences.h"
+#include "SearchBudget.h"
+#include "SectionCompatibility.h"
+#include "WorkerPool.h"
+
+using namespace std;
+
+class SectionSolver;
+
+/**
+ * @class CandidateSearch
+ * @brief Runs the SectionSolver over many candidate course sets at once
+ *
+ * Candidates are handed to the pool in chunks of CHUNK; an idle thread
+ * takes the next chunk from the pool's shared counter, so a thread that
+ * draws cheap candidates keeps taking work while another is stuck in a
+ * deep search. Each chunk has its own solver, so no search state is
+ * shared between threads.
+ *
+ * Results do not depend on the thread count: every candidate's answer goes
+ * to its own slot, and findFirst() returns the lowest schedulable position,
+ * exactly what a sequential scan would return.
+ *
+ * findBest() is the anytime form: it keeps solving until every candidate is
+ * done or the budget runs out, and reports each better schedule as it
+ * turns up.
+ *
+ * With a FeasibilityCache, a candidate already answered is not solved
+ * again. An unschedulable one is shrunk to a minimal unschedulable core,
+ * dropping each course the rest fails without, and the core is stored so
+ * that it answers every later set containing it.
+ */
+class CandidateSearch {
+ public:
+  static const size_t NOT_FOUND;
+  static const size_t CHUNK = 8;  // Candidates per pool task
+
+  /** @brief Score of a candidate's assignment; higher is better */
+  typedef function<double(size_t candidate,
+                          const vector<LessonRef>& assignment)>
+      ScoreFunction;
+
+  /** @brief Writes the course IDs of a candidate; called on pool threads */
+  typedef function<void(size_t candidate, vector<int>& courseIds)>
+      CandidateFunction;
+
+  /** @brief Told of each schedulable candidate; called on pool threads */
+  typedef function<void(size_t candidate, const vector<int>& courseIds,
+                        const vector<LessonRef>& assignment)>
+      SolutionFunction;
+
+  /**
+   * @brief Told of each new best: its position, score and assignment, and
+   *        the time since the budget started
+   */
+  typedef function<void(size_t candidate, double score,
+                        const vector<LessonRef>& assignment, double elapsedMs)>
+      ImprovementFunction;
+
+  /**
+   * @param preferences Passed to every solver; may be null
+   * @param cache Answers built for the same catalog and preferences; may be
+   *        null
+   */
+  CandidateSearch(const CourseLessonIndex& lessonIndex,
+                  const SectionCompatibility& compatibility, WorkerPool& pool,
+                  const SchedulePreferences* preferences = nullptr,
+                  FeasibilityCache* cache = nullptr);
+
+  /**
+   * @brief The first candidate, in order, with a conflict-free assignment
+   * @param candidates Course IDs of each candidate
+   * @param assignment Receives that candidate's lessons
+   * @return Its position, or NOT_FOUND
+   *
+   * Once a candidate is solved, the threads skip every later one.
+   */
+  size_t findFirst(const vector<vector<int>>& candidates,
+                   vector<LessonRef>& assignment);
+
+  /**
+   * @brief The best-scoring schedulable candidate found within the budget
+   * @param score Called on the pool threads; must only read shared data
+   * @param onImprove May be null. Called under a lock, one new best at a
+   *        time, each better than the last (ties go to the lower position)
+   * @return Its position, or NOT_FOUND
+   *
+   * Candidates are taken in order, so when time runs out the answer is the
+   * best of a prefix. With no time limit and no cancellation the answer is
+   * the same for every thread count.
+   */
+  size_t findBest(const vector<vector<int>>& candidates,
+                  const ScoreFunction& score, const SearchBudget& budget,
+                  const ImprovementFunction& onImprove,
+                  vector<LessonRef>& assignment);
+
+  /**
+   * @brief Solve candidates 0 ... count - 1 in order until the budget runs
+   *        out, building each one only when a thread reaches it
+   *
+   * Nothing is kept per candidate, so memory does not grow with count:
+   * the caller decides in onSolution what to keep.
+   */
+  void solveEach(size_t count, const CandidateFunction& candidate,
+                 const SearchBudget& budget,
+                 const SolutionFunction& onSolution);
+
+  /** @brief Solve every candidate; schedulable[i] is 1 if i has a solution */
+  void solveAll(const vector<vector<int>>& candidates,
+                vector<char>& schedulable);
+
+  /**
+   * @brief Groups the solver tried for the candidates up to the one found
+   *        (findFirst), for those solved (findBest, solveEach) or for all
+   *        of them (solveAll)
+   */
+  size_t nodesVisited() const { return nodes; }
+
+  /**
+   * @brief Candidates the last findBest() or solveEach() solved before it
+   *        stopped
+   */
+  size_t candidatesSolved() const { return solved; }
+
+ private:
+  // One candidate's answer, from the cache when it has one
+  bool solveCandidate(SectionSolver& solver, const vector<int>& courseIds,
+                      vector<LessonRef>& assignment, size_t& visited) const;
+
+  const CourseLessonIndex* lessonIndex;
+  const SectionCompatibility* compatibility;
+  WorkerPool* pool;
+  const SchedulePreferences* preferences;
+  FeasibilityCache* cache;
+  size_t nodes = 0;
+  size_t solved = 0;
+};
+
+#endif  // CANDIDATE_SEARCH_H
@@ -0,0 +1,312 @@
+#include "CatalogSnapshot.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+#include "PersistenceQueue.h"
+
+const string CatalogSnapshot::FILE_NAME = "catalog.snapshot";
+
+namespace {
+
+// Bump FORMAT_VERSION whenever the record layout below changes
+const char MAGIC[8] = {'S', 'S', 'M', 'C', 'A', 'T', 'L', 'G'};
+const uint32_t FORMAT_VERSION = 1;
+
+// FNV-1a, used both for source file hashes and the trailing checksum
+uint64_t fnv1a(const char* data, size_t size,
+               uint64_t hash = 14695981039346656037ULL) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/**
+ * @brief Appends fixed-width little-endian records to an in-memory image
+ */
+class ImageWriter {
+ public:
+  template <typename T>
+  void put(T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void putString(const string& value) {
+    put<uint32_t>(static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+  }
+
+  string buffer;
+};
+
+/**
+ * @brief Bounds-checked cursor over a snapshot image
+ */
+class ImageReader {
+ public:
+  ImageReader(const char* data, size_t size)
+      : cursor(data), end(data + size), ok(true) {}
+
+  template <typename T>
+  T get() {
+    T value = T();
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+      ok = false;
+      return value;
+    }
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+  }
+
+  string getString() {
+    uint32_t length = get<uint32_t>();
+    if (!ok || static_cast<size_t>(end - cursor) < length) {
+      ok = false;
+      return string();
+    }
+    string value(cursor, length);
+    cursor += length;
+    return value;
+  }
+
+  bool good() const { return ok; }
+
+ private:
+  const char* cursor;
+  const char* end;
+  bool ok;
+};
+
+}  // namespace
+
+bool CatalogSnapshot::statFile(const string& path, int64_t& size,
+                               int64_t& mtime) {
+#ifdef _WIN32
+  struct _stat64 info;
+  if (_stat64(path.c_str(), &info) != 0) return false;
+#else
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) return false;
+#endif
+  size = static_cast<int64_t>(info.st_size);
+  mtime = static_cast<int64_t>(info.st_mtime);
+  return true;
+}
+
+bool CatalogSnapshot::hashFile(const string& path, uint64_t& hash) {
+  ifstream file(path, ios::binary);
+  if (!file.is_open()) return false;
+
+  hash = fnv1a(nullptr, 0);
+  char chunk[64 * 1024];
+  while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+    hash = fnv1a(chunk, static_cast<size_t>(file.gcount()), hash);
+  }
+  return true;
+}
+
+vector<string> CatalogSnapshot::sourceFileNames(
+    const vector<Course>& courses) {
+  vector<string> names;
+  names.reserve(courses.size() * 3 + 1);
+  names.push_back("courses.csv");
+  for (const Course& course : courses) {
+    string prefix = to_string(course.getCourseId()) + "_";
+    names.push_back(prefix + "lectures.csv");
+    names.push_back(prefix + "tutorials.csv");
+    names.push_back(prefix + "labs.csv");
+  }
+  return names;
+}
+
+bool CatalogSnapshot::isSourceCurrent(const string& dataDir,
+                                      const SourceEntry& entry,
+                                      int64_t builtAt) {
+  int64_t size = -1, mtime = 0;
+  bool exists = statFile(dataDir + entry.name, size, mtime);
+
+  if (entry.size < 0) return !exists;  // Must still be missing
+  if (!exists || size != entry.size || mtime != entry.mtime) return false;
+
+  // A file touched within the same second the snapshot was built can change
+  // without moving its mtime, so only those "racy" entries get re-hashed.
+  if (mtime >= builtAt) {
+    uint64_t hash = 0;
+    return hashFile(dataDir + entry.name, hash) && hash == entry.hash;
+  }
+  return true;
+}
+
+bool CatalogSnapshot::save(const string& dataDir,
+                           const vector<Course>& courses,
+                           const LessonTable& lessonTable,
+                           const map<int, vector<LessonRef>>& courseLessons) {
+  ImageWriter image;
+  image.buffer.append(MAGIC, sizeof(MAGIC));
+  image.put<uint32_t>(FORMAT_VERSION);
+  image.put<int64_t>(static_cast<int64_t>(time(nullptr)));
+
+  // Source manifest
+  vector<string> names = sourceFileNames(courses);
+  image.put<uint32_t>(static_cast<uint32_t>(names.size()));
+  for (const string& name : names) {
+    int64_t size = -1, mtime = 0;
+    uint64_t hash = 0;
+    if (statFile(dataDir + name, size, mtime)) {
+      hashFile(dataDir + name, hash);
+    } else {
+      size = -1;
+    }
+    image.putString(name);
+    image.put<int64_t>(size);
+    image.put<int64_t>(mtime);
+    image.put<uint64_t>(hash);
+  }
+
+  // Courses
+  image.put<uint32_t>(static_cast<uint32_t>(courses.size()));
+  for (const Course& course : courses) {
+    image.put<int32_t>(course.getCourseId());
+    image.putString(course.getName());
+    image.put<double>(course.getCredits());
+    image.putString(course.getExamDateA());
+    image.putString(course.getExamDateB());
+    image.putString(course.getLecturer());
+  }
+
+  // Lessons, grouped by course in the same order they were loaded
+  uint32_t lessonCount = 0;
+  for (const auto& entry : courseLessons) {
+    lessonCount += static_cast<uint32_t>(entry.second.size());
+  }
+  image.put<uint32_t>(lessonCount);
+  for (const auto& entry : courseLessons) {
+    for (LessonRef lesson : entry.second) {
+      image.put<int32_t>(entry.first);
+      image.put<uint8_t>(lessonTable.kind(lesson));
+      image.putString(lessonTable.dayName(lesson));
+      image.putString(lessonTable.startTime(lesson));
+      image.put<int32_t>(lessonTable.durationMinutes(lesson));
+      image.putString(lessonTable.classroom(lesson));
+      image.putString(lessonTable.building(lesson));
+      image.putString(lessonTable.teacher(lesson));
+      image.putString(lessonTable.groupId(lesson));
+    }
+  }
+
+  image.put<uint64_t>(fnv1a(image.buffer.data(), image.buffer.size()));
+
+  // Write next to the target and move it over, so a crash never leaves a
+  // torn image
+  string path = dataDir + FILE_NAME;
+  string tempPath = path + ".tmp";
+  {
+    ofstream file(tempPath, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(image.buffer.data(),
+               static_cast<streamsize>(image.buffer.size()));
+    if (!file.good()) return false;
+  }
+  return PersistenceQueue::commitFile(tempPath, path);
+}
+
+bool CatalogSnapshot::load(const string& dataDir, vector<Course>& courses,
+                           LessonTable& lessonTable,
+                           map<int, vector<LessonRef>>& courseLessons) {
+  // One read for the whole image
+  ifstream file(dataDir + FILE_NAME, ios::binary | ios::ate);
+  if (!file.is_open()) return false;
+
+  streamoff fileSize = file.tellg();
+  if (fileSize < static_cast<streamoff>(sizeof(MAGIC) + sizeof(uint64_t))) {
+    return false;
+  }
+  string buffer(static_cast<size_t>(fileSize), '\0');
+  file.seekg(0);
+  if (!file.read(&buffer[0], fileSize)) return false;
+  file.close();
+
+  // Verify magic and checksum before trusting any length field
+  if (memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+  size_t payloadSize = buffer.size() - sizeof(uint64_t);
+  uint64_t storedChecksum = 0;
+  memcpy(&storedChecksum, buffer.data() + payloadSize, sizeof(uint64_t));
+  if (fnv1a(buffer.data(), payloadSize) != storedChecksum) return false;
+
+  ImageReader reader(buffer.data() + sizeof(MAGIC),
+                     payloadSize - sizeof(MAGIC));
+  if (reader.get<uint32_t>() != FORMAT_VERSION) return false;
+  int64_t builtAt = reader.get<int64_t>();
+
+  uint32_t sourceCount = reader.get<uint32_t>();
+  for (uint32_t i = 0; i < sourceCount && reader.good(); i++) {
+    SourceEntry entry;
+    entry.name = reader.getString();
+    entry.size = reader.get<int64_t>();
+    entry.mtime = reader.get<int64_t>();
+    entry.hash = reader.get<uint64_t>();
+    if (!reader.good() || !isSourceCurrent(dataDir, entry, builtAt)) {
+      return false;
+    }
+  }
+
+  vector<Course> loadedCourses;
+  uint32_t courseCount = reader.get<uint32_t>();
+  loadedCourses.reserve(courseCount);
+  for (uint32_t i = 0; i < courseCount && reader.good(); i++) {
+    int32_t id = reader.get<int32_t>();
+    string name = reader.getString();
+    double credits = reader.get<double>();
+    string examDateA = reader.getString();
+    string examDateB = reader.getString();
+    string lecturer = reader.getString();
+    loadedCourses.emplace_back(id, name, credits, examDateA, examDateB,
+                               lecturer);
+  }
+
+  // Lessons are stored grouped by course, so the map slot is looked up once
+  // per course rather than once per lesson
+  LessonTable loadedTable;
+  map<int, vector<LessonRef>> loadedLessons;
+  vector<LessonRef>* currentCourse = nullptr;
+  int32_t currentCourseId = 0;
+  uint32_t lessonCount = reader.get<uint32_t>();
+  for (uint32_t i = 0; i < lessonCount && reader.good(); i++) {
+    int32_t courseId = reader.get<int32_t>();
+    uint8_t type = reader.get<uint8_t>();
+    string day = reader.getString();
+    string startTime = reader.getString();
+    int32_t duration = reader.get<int32_t>();
+    string classroom = reader.getString();
+    string building = reader.getString();
+    string teacher = reader.getString();
+    string groupId = reader.getString();
+
+    if (!reader.good()) break;
+    if (type > LessonTable::LAB) continue;
+
+    LessonRef lesson = loadedTable.add(
+        courseId, static_cast<LessonTable::Kind>(type), day, startTime,
+        duration, classroom, building, teacher, groupId);
+    if (!currentCourse || courseId != currentCourseId) {
+      currentCourse = &loadedLessons[courseId];
+      currentCourseId = courseId;
+    }
+    currentCourse->push_back(lesson);
+  }
+
+  if (!reader.good()) return false;
+
+  courses.swap(loadedCourses);
+  lessonTable.swap(loadedTable);
+  courseLessons.swap(loadedLessons);
+  return true;
+}
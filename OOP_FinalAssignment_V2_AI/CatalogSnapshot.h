@@ -0,0 +1,71 @@
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Course.h"
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class CatalogSnapshot
+ * @brief Compiled binary image of the course catalog
+ *
+ * The catalog normally lives in data/courses.csv plus three lesson files per
+ * course. Opening and parsing all of them dominates startup, so the parsed
+ * catalog is written once to a single binary file (data/catalog.snapshot)
+ * and loaded back with one read on the next start.
+ *
+ * The image carries a manifest of every source CSV (size, mtime and content
+ * hash). The snapshot is rejected - and the caller falls back to the CSV
+ * files - as soon as any source file was added, removed or modified.
+ */
+class CatalogSnapshot {
+ public:
+  static const string FILE_NAME;
+
+  /**
+   * @brief Load courses and lessons from the snapshot in dataDir
+   *
+   * lessonTable is replaced by the catalog lessons, which courseLessons
+   * refers to.
+   * @return true if the snapshot exists, is intact and matches all sources
+   */
+  static bool load(const string& dataDir, vector<Course>& courses,
+                   LessonTable& lessonTable,
+                   map<int, vector<LessonRef>>& courseLessons);
+
+  /**
+   * @brief Write a fresh snapshot of the given catalog into dataDir
+   * @return true if the snapshot file was written and renamed into place
+   */
+  static bool save(const string& dataDir, const vector<Course>& courses,
+                   const LessonTable& lessonTable,
+                   const map<int, vector<LessonRef>>& courseLessons);
+
+  /**
+   * @brief Size and modification time of a file
+   * @return false if the file does not exist
+   */
+  static bool statFile(const string& path, int64_t& size, int64_t& mtime);
+
+ private:
+  struct SourceEntry {
+    string name;  // Path relative to the data directory
+    int64_t size;  // -1 when the file did not exist at build time
+    int64_t mtime;
+    uint64_t hash;
+  };
+
+  static vector<string> sourceFileNames(const vector<Course>& courses);
+  static bool hashFile(const string& path, uint64_t& hash);
+  static bool isSourceCurrent(const string& dataDir, const SourceEntry& entry,
+                              int64_t builtAt);
+};
+
+#endif  // CATALOG_SNAPSHOT_H
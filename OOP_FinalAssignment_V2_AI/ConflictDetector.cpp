@@ -0,0 +1,74 @@
+#include "ConflictDetector.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// One timed lesson, with its position in the caller's list
+struct Span {
+  uint32_t day;
+  int start;
+  int end;
+  size_t position;
+};
+
+// Heap order: the lesson that ends first on top
+bool endsLater(const Span& a, const Span& b) { return a.end > b.end; }
+
+}  // namespace
+
+vector<LessonConflict> ConflictDetector::findAll(
+    const LessonTable& table, const vector<LessonRef>& lessons) {
+  vector<LessonConflict> conflicts;
+  sweep(table, lessons, &conflicts);
+  return conflicts;
+}
+
+bool ConflictDetector::hasAny(const LessonTable& table,
+                              const vector<LessonRef>& lessons) {
+  return sweep(table, lessons, nullptr) > 0;
+}
+
+size_t ConflictDetector::sweep(const LessonTable& table,
+                               const vector<LessonRef>& lessons,
+                               vector<LessonConflict>* conflicts) {
+  vector<Span> spans;
+  spans.reserve(lessons.size());
+  for (size_t i = 0; i < lessons.size(); i++) {
+    LessonRef lesson = lessons[i];
+    int start = table.startMinute(lesson);
+    int duration = table.durationMinutes(lesson);
+    if (start == LessonTable::NO_START || duration <= 0) continue;
+    spans.push_back({table.dayIndex(lesson), start, start + duration, i});
+  }
+  sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+    if (a.day != b.day) return a.day < b.day;
+    if (a.start != b.start) return a.start < b.start;
+    return a.position < b.position;
+  });
+
+  size_t found = 0;
+  vector<Span> running;  // Min-heap by end
+  for (size_t i = 0; i < spans.size(); i++) {
+    const Span& span = spans[i];
+    if (i > 0 && span.day != spans[i - 1].day) running.clear();
+    while (!running.empty() && running.front().end <= span.start) {
+      pop_heap(running.begin(), running.end(), endsLater);
+      running.pop_back();
+    }
+
+    // What is left started no later and is still running at this start
+    for (const Span& other : running) {
+      found++;
+      if (!conflicts) return found;
+      conflicts->push_back({min(other.position, span.position),
+                            max(other.position, span.position),
+                            min(other.end, span.end) - span.start});
+    }
+
+    running.push_back(span);
+    push_heap(running.begin(), running.end(), endsLater);
+  }
+  return found;
+}
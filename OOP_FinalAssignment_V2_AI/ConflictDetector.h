@@ -0,0 +1,49 @@
+#ifndef CONFLICT_DETECTOR_H
+#define CONFLICT_DETECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @brief Two lessons of one list whose times overlap
+ */
+struct LessonConflict {
+  size_t first;        // Position in the list; always below `second`
+  size_t second;
+  int overlapMinutes;  // Length of the shared time
+};
+
+/**
+ * @class ConflictDetector
+ * @brief Every time overlap in a list of lessons, by sweep line
+ *
+ * Comparing every pair of lessons is O(n^2) however few of them clash.
+ * The detector sorts the lessons by (day, start) and sweeps them in that
+ * order, keeping the lessons still running in a min-heap by end time. When
+ * a lesson starts, the ones that ended are popped and everything left in
+ * the heap overlaps it, so the cost is O(n log n + k) for k conflicts.
+ *
+ * Works on the in-memory lesson table and prints nothing. Lessons without
+ * a parsed start time or with no duration never conflict.
+ */
+class ConflictDetector {
+ public:
+  /** @brief All overlapping pairs, ordered by the start of the later one */
+  static vector<LessonConflict> findAll(const LessonTable& table,
+                                        const vector<LessonRef>& lessons);
+
+  /** @brief True if any two lessons overlap; stops at the first pair */
+  static bool hasAny(const LessonTable& table,
+                     const vector<LessonRef>& lessons);
+
+ private:
+  static size_t sweep(const LessonTable& table,
+                      const vector<LessonRef>& lessons,
+                      vector<LessonConflict>* conflicts);
+};
+
+#endif  // CONFLICT_DETECTOR_H
@@ -58,7 +58,7 @@ string Course::getExamDateA() const { return examDateA; }
 
 string Course::getExamDateB() const { return examDateB; }
 
-string Course::getLecturer() const { return lecturer; }
+const string& Course::getLecturer() const { return lecturer; }
 
 // Setters
 void Course::setCourseId(int id) { courseId = id; }
@@ -2,6 +2,8 @@
 #define COURSE_H
 
 #include <string>
+
+#include "StringPool.h"
 using namespace std;
 
 class Course {
@@ -11,7 +13,7 @@ class Course {
   double credits;  // Changed from int to double to support decimal credits
   string examDateA;
   string examDateB;
-  string lecturer;
+  Symbol lecturer;
 
  public:
   // Default constructor
@@ -37,7 +39,7 @@ class Course {
   double getCredits() const;  // Changed from int to double
   string getExamDateA() const;
   string getExamDateB() const;
-  string getLecturer() const;
+  const string& getLecturer() const;
 
   // Setters
   void setCourseId(int id);
@@ -0,0 +1,40 @@
+#include "CourseLessonIndex.h"
+
+void CourseLessonIndex::build(
+    const LessonTable& table,
+    const map<int, vector<LessonRef>>& courseLessons) {
+  clear();
+  size_t total = 0;
+  for (const auto& entry : courseLessons) total += entry.second.size();
+  lessons.reserve(total);
+  courseGroups.reserve(courseLessons.size());
+
+  for (const auto& entry : courseLessons) {
+    CourseGroups& groupLists = courseGroups[entry.first];
+    for (LessonRef lesson : entry.second) {
+      // emplace keeps the first row of a repeated group
+      if (lessons.emplace(key(entry.first, table.groupCode(lesson)), lesson)
+              .second) {
+        groupLists.byKind[table.kind(lesson)].push_back(lesson);
+      }
+    }
+  }
+}
+
+void CourseLessonIndex::clear() {
+  lessons.clear();
+  courseGroups.clear();
+}
+
+void CourseLessonIndex::swap(CourseLessonIndex& other) {
+  lessons.swap(other.lessons);
+  courseGroups.swap(other.courseGroups);
+}
+
+const vector<LessonRef>& CourseLessonIndex::groups(
+    int courseId, LessonTable::Kind kind) const {
+  static const vector<LessonRef> none;
+  auto it = courseGroups.find(courseId);
+  if (it == courseGroups.end() || kind > LessonTable::LAB) return none;
+  return it->second.byKind[kind];
+}
@@ -0,0 +1,72 @@
+#ifndef COURSE_LESSON_INDEX_H
+#define COURSE_LESSON_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class CourseLessonIndex
+ * @brief Catalog lessons by (course, group) and by (course, lesson type)
+ *
+ * Adding or removing a lesson, reading an old-format schedule row and the
+ * conflict resolver all had to find "group T2 of course 11002" by scanning
+ * courseLessons[courseId] and comparing group names, once per candidate
+ * pair in the resolver's nested loop. The index is built once when the
+ * catalog is loaded:
+ *   - (courseId, packed group code) -> LessonRef, one hash probe
+ *   - courseId -> the course's lessons split by LessonTable::Kind, in
+ *     catalog order, so the groups of one type need no filtering
+ * Group codes come from LessonTable::findGroupCode() on the table the
+ * index was built from, so no group name is compared as a string.
+ *
+ * When a course lists the same group twice the first row wins, as the
+ * find_if scans it replaces did. Rebuild after the catalog changes.
+ */
+class CourseLessonIndex {
+ public:
+  /** @brief Index every lesson of `courseLessons` (rows of `table`) */
+  void build(const LessonTable& table,
+             const map<int, vector<LessonRef>>& courseLessons);
+
+  void clear();
+  void swap(CourseLessonIndex& other);
+
+  /**
+   * @brief The lesson of `courseId` with group `groupCode`
+   * @return false if the course has no such group
+   */
+  bool find(int courseId, uint16_t groupCode, LessonRef& lesson) const {
+    auto it = lessons.find(key(courseId, groupCode));
+    if (it == lessons.end()) return false;
+    lesson = it->second;
+    return true;
+  }
+
+  /** @brief The lessons of one type of a course, one per group */
+  const vector<LessonRef>& groups(int courseId, LessonTable::Kind kind) const;
+
+  /** @brief Number of indexed (course, group) pairs */
+  size_t size() const { return lessons.size(); }
+
+ private:
+  struct CourseGroups {
+    vector<LessonRef> byKind[3];  // Indexed by LessonTable::Kind
+  };
+
+  static uint64_t key(int courseId, uint16_t groupCode) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(courseId)) << 16) |
+           groupCode;
+  }
+
+  unordered_map<uint64_t, LessonRef> lessons;
+  unordered_map<int, CourseGroups> courseGroups;
+};
+
+#endif  // COURSE_LESSON_INDEX_H
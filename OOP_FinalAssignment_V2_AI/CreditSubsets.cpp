@@ -0,0 +1,141 @@
+#include "CreditSubsets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+CreditSubsets::CreditSubsets(const vector<double>& credits,
+                             double targetCredits, double tolerance,
+                             int minCourses, int maxCourses)
+    : minCourses(max(0, minCourses)),
+      maxCourses(max(0, min(maxCourses, static_cast<int>(credits.size())))) {
+  for (double credit : credits) {
+    units.push_back(max(0, static_cast<int>(lround(credit * 2))));
+  }
+
+  // No set sums past its size's largest credits, so the table stops there
+  // however large the target; the bounds are clamped before the int cast
+  vector<int> largest(units);
+  sort(largest.begin(), largest.end(), greater<int>());
+  int reachable = 0;
+  for (int i = 0; i < this->maxCourses; i++) reachable += largest[i];
+
+  // The epsilon keeps 14.5 +/- 0.5 from losing an end to rounding
+  double low = ceil((targetCredits - tolerance) * 2 - 1e-9);
+  double high = floor((targetCredits + tolerance) * 2 + 1e-9);
+  minUnits = static_cast<int>(max(0.0, min(low, reachable + 1.0)));
+  maxUnits =
+      static_cast<int>(max(-1.0, min(high, static_cast<double>(reachable))));
+  if (maxUnits < minUnits || this->minCourses > this->maxCourses) return;
+
+  size_t courseCount = units.size();
+  table.assign((courseCount + 1) * (this->maxCourses + 1) * (maxUnits + 1), 0);
+  ways(courseCount, 0, 0) = 1;
+  for (size_t course = courseCount; course-- > 0;) {
+    for (int k = 0; k <= this->maxCourses; k++) {
+      for (int s = 0; s <= maxUnits; s++) {
+        double without = ways(course + 1, k, s);
+        double with = k > 0 && s >= units[course]
+                          ? ways(course + 1, k - 1, s - units[course])
+                          : 0;
+        ways(course, k, s) = without + with;
+      }
+    }
+  }
+
+  for (int k = this->minCourses; k <= this->maxCourses; k++) {
+    for (int s = minUnits; s <= maxUnits; s++) total += ways(0, k, s);
+  }
+}
+
+double& CreditSubsets::ways(size_t course, int courses, int sum) {
+  return table[(course * (maxCourses + 1) + courses) * (maxUnits + 1) + sum];
+}
+
+double CreditSubsets::ways(size_t course, int courses, int sum) const {
+  return table[(course * (maxCourses + 1) + courses) * (maxUnits + 1) + sum];
+}
+
+void CreditSubsets::enumerate(vector<vector<int>>& sets, size_t limit) const {
+  if (total == 0) return;
+  vector<int> current;
+  for (int k = minCourses; k <= maxCourses; k++) {
+    for (int s = minUnits; s <= maxUnits; s++) {
+      enumerateFrom(0, k, s, current, sets, limit);
+    }
+  }
+}
+
+void CreditSubsets::enumerateFrom(size_t course, int courses, int sum,
+                                  vector<int>& current,
+                                  vector<vector<int>>& sets,
+                                  size_t limit) const {
+  if (sets.size() >= limit || ways(course, courses, sum) == 0) return;
+  if (courses == 0) {
+    sets.push_back(current);  // ways > 0 with no courses left: sum == 0
+    return;
+  }
+
+  // The table says whether each branch holds any set, so no dead ends
+  int credit = units[course];
+  if (sum >= credit) {
+    current.push_back(static_cast<int>(course));
+    enumerateFrom(course + 1, courses - 1, sum - credit, current, sets, limit);
+    current.pop_back();
+  }
+  enumerateFrom(course + 1, courses, sum, current, sets, limit);
+}
+
+vector<int> CreditSubsets::sample(mt19937& random) const {
+  if (total == 0) return vector<int>();
+  return at(uniform_real_distribution<double>(0, total)(random));
+}
+
+vector<int> CreditSubsets::at(double rank) const {
+  vector<int> chosen;
+  if (total == 0) return chosen;
+
+  // Find the set with this rank: first its size and unit sum, then course
+  // by course whether it is in it
+  int courses = maxCourses;
+  int sum = maxUnits;
+  bool located = false;
+  for (int k = minCourses; k <= maxCourses && !located; k++) {
+    for (int s = minUnits; s <= maxUnits; s++) {
+      double here = ways(0, k, s);
+      if (rank < here) {
+        courses = k;
+        sum = s;
+        located = true;
+        break;
+      }
+      rank -= here;
+    }
+  }
+  if (!located) {
+    // Rounding left the rank just past the end: take the last set
+    while (ways(0, courses, sum) == 0) {
+      if (--sum < minUnits) {
+        sum = maxUnits;
+        courses--;
+      }
+    }
+    rank = ways(0, courses, sum) - 1;
+  }
+
+  for (size_t course = 0; courses > 0 && course < units.size(); course++) {
+    int credit = units[course];
+    double with =
+        sum >= credit ? ways(course + 1, courses - 1, sum - credit) : 0;
+    double without = ways(course + 1, courses, sum);
+    if (rank < with || without == 0) {
+      chosen.push_back(static_cast<int>(course));
+      courses--;
+      sum -= credit;
+      rank = min(rank, max(0.0, with - 1));
+    } else {
+      rank -= with;
+    }
+  }
+  return chosen;
+}
@@ -0,0 +1,74 @@
+#ifndef CREDIT_SUBSETS_H
+#define CREDIT_SUBSETS_H
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class CreditSubsets
+ * @brief Every course set whose credits fall in a target window, counted
+ *        by dynamic programming
+ *
+ * Credits are multiples of 0.5, so doubled they are small integers
+ * ("units") and the window is a range of unit sums. ways(i, k, s) is the
+ * number of sets of k courses taken from positions i.. that add up to s
+ * units:
+ *   ways(i, k, s) = ways(i + 1, k, s) + ways(i + 1, k - 1, s - units[i])
+ * With the table, the sets in the window can be listed without visiting a
+ * dead end, or drawn uniformly at random by walking the table with a
+ * random rank. Counts are doubles, so a catalog with more sets than a
+ * double counts exactly still samples (almost) uniformly.
+ *
+ * Credits that are not a multiple of 0.5 are rounded to the nearest half.
+ */
+class CreditSubsets {
+ public:
+  /**
+   * @param credits Credits of each course, by position
+   * @param minCourses,maxCourses Allowed set sizes
+   */
+  CreditSubsets(const vector<double>& credits, double targetCredits,
+                double tolerance, int minCourses, int maxCourses);
+
+  /** @brief Number of course sets in the window */
+  double count() const { return total; }
+
+  /**
+   * @brief Append every set in the window, fewest courses first
+   * @param limit Stop after this many
+   */
+  void enumerate(vector<vector<int>>& sets, size_t limit) const;
+
+  /** @brief One set drawn uniformly from all sets in the window */
+  vector<int> sample(mt19937& random) const;
+
+  /**
+   * @brief The set at this position of enumerate()'s order, built straight
+   *        from the table, so all sets can be visited without storing them
+   * @param rank 0 <= rank < count()
+   */
+  vector<int> at(double rank) const;
+
+ private:
+  double& ways(size_t course, int courses, int sum);
+  double ways(size_t course, int courses, int sum) const;
+
+  // Sets of `courses` courses from positions `course`.. adding up to `sum`
+  // units, each appended to `current`
+  void enumerateFrom(size_t course, int courses, int sum,
+                     vector<int>& current, vector<vector<int>>& sets,
+                     size_t limit) const;
+
+  vector<int> units;
+  int minCourses;
+  int maxCourses;
+  int minUnits;
+  int maxUnits;
+  vector<double> table;  // ways, indexed [course][courses][units]
+  double total = 0;
+};
+
+#endif  // CREDIT_SUBSETS_H
@@ -0,0 +1,212 @@
+#include "CsvReader.h"
+
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Map the whole file read-only. The OS handles are released right away; the
+// view stays valid until it is unmapped.
+bool mapFile(const string& path, const char*& data, size_t& size) {
+  data = nullptr;
+  size = 0;
+#ifdef _WIN32
+  // Share like ifstream does, so a concurrent writer is not locked out
+  HANDLE file =
+      CreateFileA(path.c_str(), GENERIC_READ,
+                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                  nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    return false;
+  }
+  if (fileSize.QuadPart == 0) {  // Empty files cannot be mapped
+    CloseHandle(file);
+    return true;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) return false;
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!view) return false;
+
+  data = static_cast<const char*>(view);
+  size = static_cast<size_t>(fileSize.QuadPart);
+  return true;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return false;
+  }
+  if (info.st_size == 0) {  // Empty files cannot be mapped
+    close(fd);
+    return true;
+  }
+
+  void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (view == MAP_FAILED) return false;
+  madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+  data = static_cast<const char*>(view);
+  size = static_cast<size_t>(info.st_size);
+  return true;
+#endif
+}
+
+void unmapFile(const char* data, size_t size) {
+  if (!data) return;
+#ifdef _WIN32
+  (void)size;
+  UnmapViewOfFile(data);
+#else
+  munmap(const_cast<char*>(data), size);
+#endif
+}
+
+}  // namespace
+
+// =================== CSV FIELD ===================
+
+int CsvField::toInt() const {
+  const char* p = data;
+  const char* end = data + size;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+  if (p == end || *p < '0' || *p > '9') throw invalid_argument("stoi");
+
+  // Like stoi, trailing non-digits are ignored
+  long long value = 0;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    value = value * 10 + (*p - '0');
+    if (value > static_cast<long long>(INT_MAX) + 1) {
+      throw out_of_range("stoi");
+    }
+  }
+  if (negative) value = -value;
+  if (value > INT_MAX || value < INT_MIN) throw out_of_range("stoi");
+  return static_cast<int>(value);
+}
+
+double CsvField::toDouble() const {
+  // The mapping is not NUL-terminated, so strtod gets a bounded copy
+  char buffer[64];
+  size_t n = size < sizeof(buffer) - 1 ? size : sizeof(buffer) - 1;
+  memcpy(buffer, data, n);
+  buffer[n] = '\0';
+
+  char* parsedEnd = nullptr;
+  double value = strtod(buffer, &parsedEnd);
+  if (parsedEnd == buffer) throw invalid_argument("stod");
+  return value;
+}
+
+// =================== CSV READER ===================
+
+CsvReader::CsvReader(const string& path)
+    : opened(false),
+      base(nullptr),
+      length(0),
+      cursor(nullptr),
+      limit(nullptr),
+      count(0),
+      terminated(false) {
+  opened = mapFile(path, base, length);
+  cursor = base;
+  limit = base + length;
+
+  // Skip a UTF-8 byte order mark left by spreadsheet exports
+  if (length >= 3 && memcmp(base, "\xEF\xBB\xBF", 3) == 0) cursor += 3;
+}
+
+CsvReader::~CsvReader() { close(); }
+
+void CsvReader::close() {
+  unmapFile(base, length);
+  opened = false;
+  base = cursor = limit = nullptr;
+  length = 0;
+  count = 0;
+}
+
+bool CsvReader::nextRow() {
+  while (cursor < limit) {
+    const char* begin = cursor;
+    const char* newline =
+        static_cast<const char*>(memchr(begin, '\n', limit - begin));
+    const char* end = newline ? newline : limit;
+    cursor = newline ? newline + 1 : limit;
+
+    const char* trimmed = end;
+    while (trimmed > begin && isBlank(trimmed[-1])) --trimmed;
+    if (trimmed == begin) continue;  // Blank line
+
+    currentRow = CsvField(begin, trimmed - begin);
+    terminated = newline != nullptr;
+    splitRow(begin, trimmed);
+    return true;
+  }
+  count = 0;
+  return false;
+}
+
+void CsvReader::splitRow(const char* begin, const char* end) {
+  count = 0;
+  const char* p = begin;
+  while (true) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+
+    const char* fieldBegin = p;
+    const char* fieldEnd;
+    if (p < end && *p == '"') {
+      // Quoted field: commas inside the quotes do not split
+      fieldBegin = ++p;
+      while (p < end && *p != '"') ++p;
+      fieldEnd = p;
+      while (p < end && *p != ',') ++p;
+    } else {
+      while (p < end && *p != ',') ++p;
+      fieldEnd = p;
+      while (fieldEnd > fieldBegin && isBlank(fieldEnd[-1])) --fieldEnd;
+    }
+
+    if (count < MAX_FIELDS) {
+      fields[count++] = CsvField(fieldBegin, fieldEnd - fieldBegin);
+    }
+    if (p >= end) break;
+    ++p;  // Skip the comma
+  }
+}
@@ -0,0 +1,114 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "StringPool.h"
+
+using namespace std;
+
+/**
+ * @struct CsvField
+ * @brief Non-owning view of one field inside a mapped CSV file
+ *
+ * Valid only while the CsvReader that produced it is open. Leading and
+ * trailing blanks, a trailing '\r' and surrounding quotes are already
+ * stripped.
+ */
+struct CsvField {
+  const char* data;
+  size_t size;
+
+  CsvField() : data(nullptr), size(0) {}
+  CsvField(const char* fieldData, size_t fieldSize)
+      : data(fieldData), size(fieldSize) {}
+
+  bool empty() const { return size == 0; }
+  string str() const { return string(data, size); }
+  Symbol symbol() const { return Symbol(data, size); }
+
+  bool operator==(const char* text) const {
+    return strlen(text) == size && memcmp(data, text, size) == 0;
+  }
+  bool operator!=(const char* text) const { return !(*this == text); }
+
+  /**
+   * @brief Parse the field as an integer
+   * @throws invalid_argument / out_of_range, like stoi
+   */
+  int toInt() const;
+
+  /**
+   * @brief Parse the field as a floating point number
+   * @throws invalid_argument, like stod
+   */
+  double toDouble() const;
+};
+
+/**
+ * @class CsvReader
+ * @brief Memory-mapped, zero-copy CSV tokenizer shared by all loaders
+ *
+ * The file is mapped read-only and each row is split in place into
+ * CsvField views, so reading a row performs no heap allocation. Callers
+ * copy only the fields they keep (CsvField::str()).
+ *
+ * Usage:
+ *   CsvReader reader(path);
+ *   reader.nextRow();  // header
+ *   while (reader.nextRow()) { int id = reader[0].toInt(); ... }
+ */
+class CsvReader {
+ public:
+  /** @brief Fields beyond this count are ignored (widest file has 10) */
+  static const size_t MAX_FIELDS = 16;
+
+  explicit CsvReader(const string& path);
+  ~CsvReader();
+
+  bool isOpen() const { return opened; }
+
+  /**
+   * @brief Release the mapping early (Windows cannot rewrite a mapped file)
+   */
+  void close();
+
+  /**
+   * @brief Advance to the next non-blank row
+   * @return false at end of file
+   */
+  bool nextRow();
+
+  size_t fieldCount() const { return count; }
+  const CsvField& operator[](size_t index) const { return fields[index]; }
+
+  /** @brief Raw text of the current row, for diagnostics */
+  const CsvField& row() const { return currentRow; }
+
+  /**
+   * @brief false only for a last row without a line break, e.g. one whose
+   *        write was cut short
+   */
+  bool rowTerminated() const { return terminated; }
+
+ private:
+  CsvReader(const CsvReader&) = delete;
+  CsvReader& operator=(const CsvReader&) = delete;
+
+  void splitRow(const char* begin, const char* end);
+
+  bool opened;
+  const char* base;  // Start of the mapping (nullptr for an empty file)
+  size_t length;
+  const char* cursor;
+  const char* limit;
+
+  CsvField fields[MAX_FIELDS];
+  size_t count;
+  CsvField currentRow;
+  bool terminated;
+};
+
+#endif  // CSV_READER_H
@@ -0,0 +1,141 @@
+#include "FeasibilityCache.h"
+
+#include <functional>
+
+const size_t FeasibilityCache::MAX_COURSES;
+const size_t FeasibilityCache::SHARDS;
+
+FeasibilityCache::FeasibilityCache(size_t maxEntries)
+    : maxEntries(maxEntries),
+      entryCount(0),
+      hits(0),
+      proofHits(0),
+      misses(0),
+      uncacheable(0),
+      full(0) {}
+
+void FeasibilityCache::reset(const vector<int>& catalogCourseIds) {
+  courseBits.clear();
+  for (int courseId : catalogCourseIds) {
+    if (courseBits.size() == MAX_COURSES) break;
+    courseBits.emplace(courseId, courseBits.size());
+  }
+  invalidate();
+  resetStats();
+}
+
+void FeasibilityCache::invalidate() {
+  for (Shard& shard : shards) {
+    lock_guard<mutex> guard(shard.lock);
+    shard.entries.clear();
+  }
+  {
+    unique_lock<shared_timed_mutex> guard(coreLock);
+    alone.reset();
+    partners.assign(courseBits.size(), Key());
+    largerCores.assign(courseBits.size(), vector<Key>());
+    coreCount = 0;
+  }
+  entryCount = 0;
+  invalidations++;
+}
+
+bool FeasibilityCache::key(const vector<int>& courseIds, Key& key) const {
+  key.reset();
+  for (int courseId : courseIds) {
+    auto bit = courseBits.find(courseId);
+    if (bit == courseBits.end()) return false;
+    key.set(bit->second);
+  }
+  return true;
+}
+
+FeasibilityCache::Answer FeasibilityCache::lookup(
+    const Key& key, vector<LessonRef>& assignment) const {
+  const Shard& shard = shards[hash<Key>()(key) % SHARDS];
+  {
+    lock_guard<mutex> guard(shard.lock);
+    auto entry = shard.entries.find(key);
+    if (entry != shard.entries.end()) {
+      assignment = entry->second;
+      hits++;
+      return SCHEDULABLE;
+    }
+  }
+
+  shared_lock<shared_timed_mutex> guard(coreLock);
+  if (provedUnschedulable(key)) {
+    proofHits++;
+    return UNSCHEDULABLE;
+  }
+  misses++;
+  return UNKNOWN;
+}
+
+bool FeasibilityCache::provedUnschedulable(const Key& key) const {
+  if ((alone & key).any()) return true;
+  for (size_t course = 0; course < partners.size(); course++) {
+    if (!key[course]) continue;
+    if ((partners[course] & key).any()) return true;
+    for (const Key& core : largerCores[course]) {
+      if ((core & key) == core) return true;
+    }
+  }
+  return false;
+}
+
+void FeasibilityCache::storeSchedulable(const Key& key,
+                                        const vector<LessonRef>& assignment) {
+  if (entryCount.load() >= maxEntries) {
+    full++;
+    return;
+  }
+  Shard& shard = shards[hash<Key>()(key) % SHARDS];
+  lock_guard<mutex> guard(shard.lock);
+  if (shard.entries.emplace(key, assignment).second) entryCount++;
+}
+
+void FeasibilityCache::storeCore(const Key& core) {
+  size_t size = core.count();
+  if (size == 0) return;
+  vector<size_t> courses;
+  for (size_t course = 0; course < partners.size(); course++) {
+    if (core[course]) courses.push_back(course);
+  }
+  if (courses.size() != size) return;  // Not numbered by reset()
+
+  unique_lock<shared_timed_mutex> guard(coreLock);
+  // Another thread may have proved a subset of it meanwhile
+  if (provedUnschedulable(core)) return;
+  if (size == 1) {
+    alone.set(courses[0]);
+  } else if (size == 2) {
+    partners[courses[0]].set(courses[1]);
+    partners[courses[1]].set(courses[0]);
+  } else {
+    largerCores[courses[0]].push_back(core);
+  }
+  coreCount++;
+}
+
+FeasibilityCache::Stats FeasibilityCache::stats() const {
+  Stats stats;
+  stats.hits = hits.load();
+  stats.proofHits = proofHits.load();
+  stats.misses = misses.load();
+  stats.uncacheable = uncacheable.load();
+  stats.entries = entryCount.load();
+  stats.full = full.load();
+  stats.invalidations = invalidations;
+  shared_lock<shared_timed_mutex> guard(coreLock);
+  stats.cores = coreCount;
+  return stats;
+}
+
+void FeasibilityCache::resetStats() {
+  hits = 0;
+  proofHits = 0;
+  misses = 0;
+  uncacheable = 0;
+  full = 0;
+}
@@ -0,0 +1,113 @@
+#ifndef FEASIBILITY_CACHE_H
+#define FEASIBILITY_CACHE_H
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class FeasibilityCache
+ * @brief Remembered SectionSolver answers, shared by every search thread
+ *
+ * A course set's key is a bitset with one bit per catalog course, so the
+ * same courses in any order share one entry. Two kinds of answer are kept:
+ *   - schedulable sets, with the assignment the solver found for them, in
+ *     a hash map split into SHARDS parts with a lock each
+ *   - infeasibility proofs: minimal course sets that have no conflict-free
+ *     assignment. Every superset of such a core is unschedulable too, so
+ *     one core answers every overlapping query that contains it.
+ * A lookup is one shard probe and, on a miss there, a check of the cores
+ * under a shared lock. Most cores are a single course or a pair, kept as
+ * one bitset per course (its own bit, or its partners), so those are one
+ * AND per course of the set; larger cores are listed under their lowest
+ * course and only the lists of the set's courses are scanned.
+ *
+ * The answers depend on the catalog and on the solver's preferences:
+ * reset() when the catalog changes, invalidate() when the preferences do.
+ * Neither may run while a search is using the cache.
+ */
+class FeasibilityCache {
+ public:
+  static const size_t MAX_COURSES = 256;  // Courses past this are not cached
+  static const size_t SHARDS = 16;
+
+  typedef bitset<MAX_COURSES> Key;
+
+  enum Answer { UNKNOWN, SCHEDULABLE, UNSCHEDULABLE };
+
+  /** @brief Counters since the last reset() or resetStats(); sizes now */
+  struct Stats {
+    size_t hits = 0;          // Schedulable sets answered from the map
+    size_t proofHits = 0;     // Sets answered by an infeasibility core
+    size_t misses = 0;        // Sets the solver had to run for
+    size_t uncacheable = 0;   // Sets with a course outside the catalog
+    size_t entries = 0;       // Schedulable sets stored
+    size_t cores = 0;         // Infeasibility cores stored
+    size_t full = 0;          // Stores turned away at maxEntries
+    size_t invalidations = 0;
+  };
+
+  /** @param maxEntries Most schedulable sets kept; cores are not limited */
+  explicit FeasibilityCache(size_t maxEntries = 1 << 17);
+
+  /** @brief Number the catalog's courses and drop every answer */
+  void reset(const vector<int>& catalogCourseIds);
+
+  /** @brief Drop every answer, keeping the course numbering */
+  void invalidate();
+
+  /** @brief False if a course is not in the catalog the cache was reset to */
+  bool key(const vector<int>& courseIds, Key& key) const;
+
+  // True if a stored core is a subset of key; needs coreLock
+  bool provedUnschedulable(const Key& key) const;
+
+  /**
+   * @brief What is known about a course set
+   * @param assignment Receives the stored lessons when SCHEDULABLE
+   */
+  Answer lookup(const Key& key, vector<LessonRef>& assignment) const;
+
+  void storeSchedulable(const Key& key, const vector<LessonRef>& assignment);
+
+  /** @brief Record a course set with no conflict-free assignment */
+  void storeCore(const Key& core);
+
+  /** @brief Count a set that could not be keyed */
+  void countUncacheable() const { uncacheable++; }
+
+  Stats stats() const;
+  void resetStats();
+
+ private:
+  struct Shard {
+    mutable mutex lock;
+    unordered_map<Key, vector<LessonRef>> entries;
+  };
+
+  size_t maxEntries;
+  unordered_map<int, size_t> courseBits;  // Course ID to bit, set by reset()
+  Shard shards[SHARDS];
+  mutable shared_timed_mutex coreLock;
+  Key alone;                        // Courses unschedulable on their own
+  vector<Key> partners;             // Per course: its unschedulable pairs
+  vector<vector<Key>> largerCores;  // Per lowest course: 3+ course cores
+  size_t coreCount = 0;
+  atomic<size_t> entryCount;
+  mutable atomic<size_t> hits;
+  mutable atomic<size_t> proofHits;
+  mutable atomic<size_t> misses;
+  mutable atomic<size_t> uncacheable;
+  atomic<size_t> full;
+  size_t invalidations = 0;
+};
+
+#endif  // FEASIBILITY_CACHE_H
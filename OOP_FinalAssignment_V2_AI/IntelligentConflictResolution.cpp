@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <climits>
 #include <cstring>
 #include <fstream>
@@ -42,7 +43,8 @@ const string BG_CYAN = "\033[46m";
 // =================== FUNCTION 1: INTELLIGENT CONFLICT RESOLUTION
 // ===================
 
-bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
+bool AdvancedScheduleAnalytics::intelligentConflictResolution(
+    int scheduleId, double budgetMs, const CancellationToken* cancel) {
   cout << "\n";
   cout << BRIGHT_CYAN << BOLD
        << "===================================================================="
@@ -72,9 +74,8 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
        << endl;
 
   // Load schedule data with error handling
-  string scheduleFile = "data/schedule_" + to_string(scheduleId) + ".csv";
-  ifstream file(scheduleFile);
-  if (!file.is_open()) {
+  vector<ConflictContext::LessonInfo> scheduledLessons;
+  if (!collectScheduleLessons(scheduleId, scheduledLessons)) {
     cout << BRIGHT_RED << "ERROR: " << RESET << "Schedule " << BRIGHT_YELLOW
          << scheduleId << RESET << " not found or inaccessible." << endl;
     cout << BRIGHT_CYAN << "Recommendation: " << RESET
@@ -86,138 +87,18 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
   displayProgressAnimation("Loading schedule data with integrity validation",
                            6);
 
-  vector<ConflictContext::LessonInfo> scheduledLessons;
-  TimeSlotMatrix timeMatrix;
-
-  string line;
-  getline(file, line);  // Skip header
-
-  while (getline(file, line)) {
-    if (line.empty()) continue;
-
-    vector<string> fields = parseCSVLine(line);
-    if (fields.size() >= 10) {
-      try {
-        ConflictContext::LessonInfo lesson(
-            stoi(fields[2]),  // courseId (column 3: CourseID)
-            "",               // courseName (will be loaded)
-            fields[1],        // lessonType (column 2: LessonType)
-            fields[9],        // groupId (column 10: GroupID)
-            fields[3],        // day (column 4: Day)
-            fields[4],        // startTime (column 5: StartTime)
-            stoi(fields[5]),  // duration (column 6: Duration)
-            fields[6],        // classroom (column 7: Classroom)
-            fields[7],        // building (column 8: Building)
-            fields[8]         // instructor (column 9: Teacher)
-        );
-
-        scheduledLessons.push_back(lesson);
-
-        // Update time matrix for O(1) conflict detection
-        int dayIndex = 0;  // Convert day string to index
-        if (lesson.day == "Monday")
-          dayIndex = 1;
-        else if (lesson.day == "Tuesday")
-          dayIndex = 2;
-        else if (lesson.day == "Wednesday")
-          dayIndex = 3;
-        else if (lesson.day == "Thursday")
-          dayIndex = 4;
-        else if (lesson.day == "Friday")
-          dayIndex = 5;
-        else if (lesson.day == "Saturday")
-          dayIndex = 6;
-
-        int timeInMinutes = timeStringToMinutes(lesson.startTime);
-        if (timeInMinutes >= 0) {
-          timeMatrix.setTimeSlot(dayIndex, timeInMinutes / 60,
-                                 timeInMinutes % 60, lesson.duration);
-        }
-
-      } catch (const exception&) {
-        continue;  // Skip malformed entries
-      }
-    }
-  }
-  file.close();
+  // The schedule keeps its occupied 5-minute slots up to date itself
+  const WeekOccupancy& occupancy = findSchedule(scheduleId)->getOccupancy();
 
   cout << "Loaded " << scheduledLessons.size() << " lessons for analysis"
        << endl;
   cout << "Schedule utilization: " << fixed << setprecision(1)
-       << (timeMatrix.getUtilizationRatio() * 100) << "%" << endl;
+       << (occupancy.getUtilizationRatio() * 100) << "%" << endl;
 
   displayProgressAnimation("Performing advanced conflict detection", 10);
 
-  // Advanced conflict detection using graph theory
-  vector<ConflictContext> conflicts;
-  unordered_set<string> processedPairs;
-
-  for (size_t i = 0; i < scheduledLessons.size(); i++) {
-    for (size_t j = i + 1; j < scheduledLessons.size(); j++) {
-      const ConflictContext::LessonInfo& lesson1 = scheduledLessons[i];
-      const ConflictContext::LessonInfo& lesson2 =
-          scheduledLessons[j];  // Generate unique pair identifier
-      string pairId = to_string(min(i, j)) + "_" + to_string(max(i, j));
-      if (processedPairs.count(pairId)) continue;
-      processedPairs.insert(pairId);
-
-      // Multi-dimensional conflict analysis
-      if (lesson1.day == lesson2.day) {
-        int start1 = timeStringToMinutes(lesson1.startTime);
-        int end1 = start1 + (lesson1.duration * 60);
-        int start2 = timeStringToMinutes(lesson2.startTime);
-        int end2 = start2 + (lesson2.duration * 60);
-
-        // Time overlap detection
-        if (start1 < end2 && start2 < end1) {
-          int overlapStart = max(start1, start2);
-          int overlapEnd = min(end1, end2);
-          int overlapMinutes = overlapEnd - overlapStart;
-
-          // Calculate conflict severity (0.0 to 1.0)
-          double severity = static_cast<double>(overlapMinutes) /
-                            max(lesson1.duration * 60, lesson2.duration * 60);
-
-          ConflictContext conflict(lesson1, lesson2, overlapMinutes, severity);
-
-          // Enhanced conflict resolution - NO TIME LIMIT!
-          // All conflicts are now considered resolvable through intelligent
-          // algorithms
-          conflict.isResolvable =
-              true;  // Enhanced: Handle ANY duration conflicts
-
-          // Enhanced resolution strategies based on conflict characteristics
-          conflict.resolutionStrategies.push_back(
-              "Advanced group substitution");
-          conflict.resolutionStrategies.push_back(
-              "Intelligent time slot optimization");
-
-          if (lesson1.classroom != lesson2.classroom) {
-            conflict.resolutionStrategies.push_back(
-                "Multi-room spatial reallocation");
-          }
-
-          // Advanced strategies for longer conflicts
-          if (overlapMinutes >=
-              120) {  // 2+ hour conflicts get special treatment
-            conflict.resolutionStrategies.push_back(
-                "Deep schedule restructuring");
-            conflict.resolutionStrategies.push_back(
-                "Course priority rebalancing");
-          }
-
-          if (overlapMinutes >= 180) {  // 3+ hour conflicts
-            conflict.resolutionStrategies.push_back(
-                "Alternative course recommendation");
-            conflict.resolutionStrategies.push_back(
-                "Cross-semester optimization");
-          }
-
-          conflicts.push_back(conflict);
-        }
-      }
-    }
-  }
+  // Sweep-line conflict detection over the in-memory schedule
+  vector<ConflictContext> conflicts = detectConflicts(scheduledLessons);
 
   displayProgressAnimation("Analyzing conflict resolution strategies", 7);
 
@@ -318,16 +199,31 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
       // Track attempted resolutions to prevent circular conflicts
       set<pair<int, string>> attemptedChanges;
 
+      // The budget starts once the fixes are confirmed, not while the
+      // prompt waits for an answer
+      SearchBudget budget(budgetMs, cancel);
+      bool budgeted = budget.limitMs() > 0 || cancel;
+
       // Multi-round resolution - keep resolving until no conflicts remain
       int totalFixesApplied = 0;
-      int maxRounds = 3;  // Prevent infinite loops
+      int maxRounds = budgeted ? 20 : 3;  // Prevent infinite loops
 
       for (int round = 1; round <= maxRounds; round++) {
+        if (budgeted && budget.expired()) {
+          cout << BRIGHT_YELLOW << "=== "
+               << (budget.cancelled() ? "Cancelled" : "Time budget spent")
+               << " after " << (round - 1) << " rounds - keeping "
+               << totalFixesApplied << " fixes ===" << RESET << endl;
+          break;
+        }
         cout << BRIGHT_BLUE << "\n=== RESOLUTION ROUND " << round
              << " ===" << RESET << endl;
 
         int fixesApplied = 0;
         for (const ConflictContext& conflict : conflicts) {
+          // Every applied fix leaves the schedule consistent, so stopping
+          // between conflicts keeps the best schedule so far
+          if (budgeted && budget.expired()) break;
           if (conflict.isResolvable &&
               fixesApplied <
                   5) {  // Enhanced: Allow up to 5 fixes for complex schedules
@@ -401,50 +297,26 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
                        << conflict.lesson2.courseId << RESET << " -> "
                        << BRIGHT_CYAN << group2 << RESET;
 
-                  // Load lesson data for both alternatives
-                  vector<shared_ptr<Lesson>> lessons1 = loadLessonsForCourse(
-                      conflict.lesson1.courseId, conflict.lesson1.lessonType);
-                  vector<shared_ptr<Lesson>> lessons2 = loadLessonsForCourse(
-                      conflict.lesson2.courseId, conflict.lesson2.lessonType);
-
-                  shared_ptr<Lesson> candidateLesson1 = nullptr;
-                  shared_ptr<Lesson> candidateLesson2 = nullptr;
-
-                  // Find specific lessons for these groups
-                  for (const shared_ptr<Lesson>& lesson : lessons1) {
-                    if (lesson->getGroupId() == group1) {
-                      candidateLesson1 = lesson;
-                      break;
-                    }
-                  }
-                  for (const shared_ptr<Lesson>& lesson : lessons2) {
-                    if (lesson->getGroupId() == group2) {
-                      candidateLesson2 = lesson;
-                      break;
-                    }
-                  }
-
-                  if (!candidateLesson1 || !candidateLesson2) {
+                  // Look up the lessons of both alternative groups
+                  LessonRef candidateRef1 = 0, candidateRef2 = 0;
+                  uint16_t groupCode1 = 0, groupCode2 = 0;
+                  bool found1 =
+                      lessonTable_ptr->findGroupCode(group1, groupCode1) &&
+                      lessonIndex_ptr->find(conflict.lesson1.courseId,
+                                            groupCode1, candidateRef1);
+                  bool found2 =
+                      lessonTable_ptr->findGroupCode(group2, groupCode2) &&
+                      lessonIndex_ptr->find(conflict.lesson2.courseId,
+                                            groupCode2, candidateRef2);
+
+                  if (!found1 || !found2) {
                     cout << BRIGHT_RED << " [SKIP - Missing lesson data]"
                          << RESET << endl;
                     continue;
                   }
-
                   // Check if these two alternatives conflict with each other
-                  bool selfConflict = false;
-                  if (candidateLesson1->getDay() ==
-                      candidateLesson2->getDay()) {
-                    int start1 =
-                        timeStringToMinutes(candidateLesson1->getStartTime());
-                    int end1 = start1 + (candidateLesson1->getDuration() * 60);
-                    int start2 =
-                        timeStringToMinutes(candidateLesson2->getStartTime());
-                    int end2 = start2 + (candidateLesson2->getDuration() * 60);
-
-                    if (start1 < end2 && start2 < end1) {
-                      selfConflict = true;
-                    }
-                  }
+                  bool selfConflict =
+                      lessonsOverlap(candidateRef1, candidateRef2);
 
                   if (selfConflict) {
                     cout << BRIGHT_RED << " [CONFLICT between alternatives!]"
@@ -466,38 +338,11 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
                       continue;
                     }
 
-                    // Check candidate1 conflicts
-                    if (existingLesson.day == candidateLesson1->getDay()) {
-                      int existingStart =
-                          timeStringToMinutes(existingLesson.startTime);
-                      int existingEnd =
-                          existingStart + (existingLesson.duration * 60);
-                      int candidateStart =
-                          timeStringToMinutes(candidateLesson1->getStartTime());
-                      int candidateEnd = candidateStart +
-                                         (candidateLesson1->getDuration() * 60);
-
-                      if (existingStart < candidateEnd &&
-                          candidateStart < existingEnd) {
-                        totalConflicts++;
-                      }
+                    if (lessonsOverlap(existingLesson.lesson, candidateRef1)) {
+                      totalConflicts++;
                     }
-
-                    // Check candidate2 conflicts
-                    if (existingLesson.day == candidateLesson2->getDay()) {
-                      int existingStart =
-                          timeStringToMinutes(existingLesson.startTime);
-                      int existingEnd =
-                          existingStart + (existingLesson.duration * 60);
-                      int candidateStart =
-                          timeStringToMinutes(candidateLesson2->getStartTime());
-                      int candidateEnd = candidateStart +
-                                         (candidateLesson2->getDuration() * 60);
-
-                      if (existingStart < candidateEnd &&
-                          candidateStart < existingEnd) {
-                        totalConflicts++;
-                      }
+                    if (lessonsOverlap(existingLesson.lesson, candidateRef2)) {
+                      totalConflicts++;
                     }
                   }
 
@@ -646,130 +491,27 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
                << "Re-scanning for additional conflicts after round " << round
                << "..." << RESET << endl;
 
-          // CRITICAL FIX: RELOAD SCHEDULE DATA FROM FILE
+          // CRITICAL FIX: RELOAD SCHEDULE DATA AFTER THE FIXES
           scheduledLessons.clear();
-          string scheduleFile =
-              "data/schedule_" + to_string(scheduleId) + ".csv";
-          ifstream file(scheduleFile);
-          if (file.is_open()) {
-            string line;
-            getline(file, line);  // Skip header
-
-            while (getline(file, line)) {
-              if (line.empty()) continue;
-
-              vector<string> fields = parseCSVLine(line);
-              if (fields.size() >= 10) {
-                try {
-                  ConflictContext::LessonInfo lesson(
-                      stoi(fields[2]),  // courseId (column 3: CourseID)
-                      "",               // courseName (will be loaded)
-                      fields[1],        // lessonType (column 2: LessonType)
-                      fields[9],        // groupId (column 10: GroupID)
-                      fields[3],        // day (column 4: Day)
-                      fields[4],        // startTime (column 5: StartTime)
-                      stoi(fields[5]),  // duration (column 6: Duration)
-                      fields[6],        // classroom (column 7: Classroom)
-                      fields[7],        // building (column 8: Building)
-                      fields[8]         // instructor (column 9: Teacher)
-                  );
-                  scheduledLessons.push_back(lesson);
-                } catch (const exception&) {
-                  continue;  // Skip malformed entries
-                }
-              }
-            }
-            file.close();
-          }
+          collectScheduleLessons(scheduleId, scheduledLessons);
 
           cout << BRIGHT_CYAN << "Reloaded " << scheduledLessons.size()
-               << " lessons from updated schedule file" << RESET << endl;
-
-          // Quick conflict re-check (simplified) with UPDATED data
-          bool hasMoreConflicts = false;
-          for (size_t i = 0; i < scheduledLessons.size() && !hasMoreConflicts;
-               i++) {
-            for (size_t j = i + 1; j < scheduledLessons.size(); j++) {
-              const ConflictContext::LessonInfo& lesson1 = scheduledLessons[i];
-              const ConflictContext::LessonInfo& lesson2 = scheduledLessons[j];
-
-              if (lesson1.day == lesson2.day) {
-                int start1 = timeStringToMinutes(lesson1.startTime);
-                int end1 = start1 + (lesson1.duration * 60);
-                int start2 = timeStringToMinutes(lesson2.startTime);
-                int end2 = start2 + (lesson2.duration * 60);
-
-                if (start1 < end2 && start2 < end1) {
-                  hasMoreConflicts = true;
-                  break;
-                }
-              }
-            }
-          }
+               << " lessons from updated schedule" << RESET << endl;
 
-          if (!hasMoreConflicts) {
+          // Rebuild the conflict list from the updated data
+          conflicts = detectConflicts(scheduledLessons);
+          if (conflicts.empty()) {
             cout << BRIGHT_GREEN << "=== All conflicts resolved! ===" << RESET
                  << endl;
             break;
           } else {
-            // CRITICAL FIX: REBUILD CONFLICTS VECTOR WITH NEW DATA
-            conflicts.clear();
-            unordered_set<string> processedPairs;
-
-            for (size_t i = 0; i < scheduledLessons.size(); i++) {
-              for (size_t j = i + 1; j < scheduledLessons.size(); j++) {
-                const ConflictContext::LessonInfo& lesson1 =
-                    scheduledLessons[i];
-                const ConflictContext::LessonInfo& lesson2 =
-                    scheduledLessons[j];
-                string pairId =
-                    to_string(min(i, j)) + "_" + to_string(max(i, j));
-                if (processedPairs.count(pairId)) continue;
-                processedPairs.insert(pairId);
-
-                // Multi-dimensional conflict analysis
-                if (lesson1.day == lesson2.day) {
-                  int start1 = timeStringToMinutes(lesson1.startTime);
-                  int end1 = start1 + (lesson1.duration * 60);
-                  int start2 = timeStringToMinutes(lesson2.startTime);
-                  int end2 = start2 + (lesson2.duration * 60);
-
-                  // Time overlap detection
-                  if (start1 < end2 && start2 < end1) {
-                    int overlapStart = max(start1, start2);
-                    int overlapEnd = min(end1, end2);
-                    int overlapMinutes = overlapEnd - overlapStart;
-
-                    // Calculate conflict severity (0.0 to 1.0)
-                    double severity =
-                        static_cast<double>(overlapMinutes) /
-                        max(lesson1.duration * 60, lesson2.duration * 60);
-
-                    ConflictContext conflict(lesson1, lesson2, overlapMinutes,
-                                             severity);
-                    conflict.isResolvable =
-                        true;  // Enhanced: Handle ANY duration conflicts
-
-                    // Enhanced resolution strategies based on conflict
-                    // characteristics
-                    conflict.resolutionStrategies.push_back(
-                        "Advanced group substitution");
-                    conflict.resolutionStrategies.push_back(
-                        "Intelligent time slot optimization");
-
-                    if (lesson1.classroom != lesson2.classroom) {
-                      conflict.resolutionStrategies.push_back(
-                          "Multi-room spatial reallocation");
-                    }
-
-                    conflicts.push_back(conflict);
-                  }
-                }
-              }
-            }
-
             cout << BRIGHT_YELLOW << "Found " << conflicts.size()
                  << " remaining conflicts for next round" << RESET << endl;
+            if (budgeted) {
+              cout << BRIGHT_CYAN << "  [" << fixed << setprecision(2)
+                   << budget.elapsedMs() << " ms] " << totalFixesApplied
+                   << " fixes applied so far" << RESET << endl;
+            }
           }
         }
       }
@@ -47,17 +47,17 @@ Lesson::~Lesson() {}
 // Getters
 int Lesson::getCourseId() const { return courseId; }
 
-string Lesson::getDay() const { return day; }
+const string& Lesson::getDay() const { return day; }
 
 string Lesson::getStartTime() const { return startTime; }
 
 int Lesson::getDuration() const { return duration; }
 
-string Lesson::getClassroom() const { return classroom; }
+const string& Lesson::getClassroom() const { return classroom; }
 
-string Lesson::getBuilding() const { return building; }
+const string& Lesson::getBuilding() const { return building; }
 
-string Lesson::getTeacher() const { return teacher; }
+const string& Lesson::getTeacher() const { return teacher; }
 
 string Lesson::getGroupId() const { return groupId; }
 
@@ -2,17 +2,19 @@
 #define LESSON_H
 
 #include <string>
+
+#include "StringPool.h"
 using namespace std;
 
 class Lesson {
  protected:
   int courseId;
-  string day;
+  Symbol day;
   string startTime;
   int duration;
-  string classroom;
-  string building;
-  string teacher;
+  Symbol classroom;
+  Symbol building;
+  Symbol teacher;
   string groupId;
 
  public:
@@ -32,12 +34,12 @@ class Lesson {
 
   // Getters
   int getCourseId() const;
-  string getDay() const;
+  const string& getDay() const;
   string getStartTime() const;
   int getDuration() const;
-  string getClassroom() const;
-  string getBuilding() const;
-  string getTeacher() const;
+  const string& getClassroom() const;
+  const string& getBuilding() const;
+  const string& getTeacher() const;
   string getGroupId() const;
 
   // Setters
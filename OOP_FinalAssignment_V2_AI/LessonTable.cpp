@@ -0,0 +1,320 @@
+#include "LessonTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#include "Lab.h"
+#include "Lecture.h"
+#include "Tutorial.h"
+
+const char* const LessonTable::DAY_NAMES[7] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday",
+    "Saturday"};
+
+namespace {
+
+// Group prefixes packed into the top nibble of a group code; longer
+// prefixes first so "LB" is not read as "L"
+struct GroupPrefix {
+  const char* text;
+  size_t length;
+  uint16_t tag;
+};
+const GroupPrefix GROUP_PREFIXES[] = {{"LB", 2, 3}, {"L", 1, 1}, {"T", 1, 2}};
+const uint16_t GROUP_NUMBER_MASK = 0x0FFF;
+
+const string& groupPrefixText(uint16_t tag) {
+  static const string names[] = {"", "L", "T", "LB"};
+  return names[tag < 4 ? tag : 0];
+}
+
+template <typename T>
+size_t columnBytes(const vector<T>& column) {
+  return column.capacity() * sizeof(T);
+}
+
+}  // namespace
+
+LessonTable::LessonTable()
+    : dayNames(DAY_NAMES, DAY_NAMES + 7) {}
+
+// =================== BUILDING ===================
+
+LessonRef LessonTable::add(int courseId, Kind kind, Symbol day,
+                           const string& startTime, int durationMinutes,
+                           Symbol classroom, Symbol building, Symbol teacher,
+                           const string& groupId) {
+  if (size() >= 0xFFFFFFFFu) throw length_error("LessonTable rows");
+
+  LessonRef row = static_cast<LessonRef>(size());
+  courseIds.push_back(courseId);
+  kinds.push_back(kind);
+  days.push_back(internDay(day));
+  startMinutes.push_back(parseStartMinute(startTime));
+  durations.push_back(static_cast<uint16_t>(
+      durationMinutes < 0 ? 0 : (durationMinutes > 0xFFFF ? 0xFFFF
+                                                          : durationMinutes)));
+  classroomIds.push_back(intern(classroom));
+  buildingIds.push_back(intern(building));
+  teacherIds.push_back(intern(teacher));
+  groupCodes.push_back(packGroup(groupId));
+  return row;
+}
+
+LessonRef LessonTable::append(const LessonTable& other) {
+  LessonRef first = static_cast<LessonRef>(size());
+
+  // Translate each of the other table's IDs once, not once per row
+  vector<uint8_t> dayMap(other.dayNames.size());
+  for (size_t i = 0; i < other.dayNames.size(); i++) {
+    dayMap[i] = internDay(other.dayNames[i]);
+  }
+  vector<uint16_t> symbolMap(other.symbols.size());
+  for (size_t i = 0; i < other.symbols.size(); i++) {
+    symbolMap[i] = intern(other.symbols[i]);
+  }
+
+  // Grow geometrically: the loaders append many small tables in a row
+  size_t needed = size() + other.size();
+  if (needed > courseIds.capacity()) {
+    reserve(max(needed, courseIds.capacity() * 2));
+  }
+
+  for (size_t row = 0; row < other.size(); row++) {
+    courseIds.push_back(other.courseIds[row]);
+    kinds.push_back(other.kinds[row]);
+    days.push_back(dayMap[other.days[row]]);
+    startMinutes.push_back(other.startMinutes[row]);
+    durations.push_back(other.durations[row]);
+    classroomIds.push_back(symbolMap[other.classroomIds[row]]);
+    buildingIds.push_back(symbolMap[other.buildingIds[row]]);
+    teacherIds.push_back(symbolMap[other.teacherIds[row]]);
+    uint16_t group = other.groupCodes[row];
+    if (group & GROUP_SYMBOL) {
+      group = GROUP_SYMBOL | symbolMap[group & ~GROUP_SYMBOL];
+    }
+    groupCodes.push_back(group);
+  }
+  return first;
+}
+
+LessonRef LessonTable::copyRow(const LessonTable& other, LessonRef row) {
+  return add(other.courseId(row), other.kind(row), other.daySymbol(row),
+             other.startTime(row), other.durationMinutes(row),
+             other.classroomSymbol(row), other.buildingSymbol(row),
+             other.teacherSymbol(row), other.groupId(row));
+}
+
+bool LessonTable::sameLesson(LessonRef row, const LessonTable& other,
+                             LessonRef otherRow) const {
+  // Numeric columns first, then Symbols; no string is compared
+  if (courseIds[row] != other.courseIds[otherRow] ||
+      kinds[row] != other.kinds[otherRow] ||
+      startMinutes[row] != other.startMinutes[otherRow] ||
+      durations[row] != other.durations[otherRow]) {
+    return false;
+  }
+  if (this == &other) {
+    return days[row] == days[otherRow] &&
+           groupCodes[row] == groupCodes[otherRow] &&
+           classroomIds[row] == classroomIds[otherRow] &&
+           buildingIds[row] == buildingIds[otherRow] &&
+           teacherIds[row] == teacherIds[otherRow];
+  }
+  // Canonical group names never get a symbol, so codes compare directly
+  uint16_t group = groupCodes[row];
+  uint16_t otherGroup = other.groupCodes[otherRow];
+  bool sameGroup =
+      (group & GROUP_SYMBOL) && (otherGroup & GROUP_SYMBOL)
+          ? symbols[group & ~GROUP_SYMBOL] ==
+                other.symbols[otherGroup & ~GROUP_SYMBOL]
+          : group == otherGroup;
+  return sameGroup && daySymbol(row) == other.daySymbol(otherRow) &&
+         classroomSymbol(row) == other.classroomSymbol(otherRow) &&
+         buildingSymbol(row) == other.buildingSymbol(otherRow) &&
+         teacherSymbol(row) == other.teacherSymbol(otherRow);
+}
+
+void LessonTable::reserve(size_t rows) {
+  courseIds.reserve(rows);
+  kinds.reserve(rows);
+  days.reserve(rows);
+  startMinutes.reserve(rows);
+  durations.reserve(rows);
+  classroomIds.reserve(rows);
+  buildingIds.reserve(rows);
+  teacherIds.reserve(rows);
+  groupCodes.reserve(rows);
+}
+
+void LessonTable::clear() {
+  LessonTable empty;
+  swap(empty);
+}
+
+void LessonTable::swap(LessonTable& other) {
+  courseIds.swap(other.courseIds);
+  kinds.swap(other.kinds);
+  days.swap(other.days);
+  startMinutes.swap(other.startMinutes);
+  durations.swap(other.durations);
+  classroomIds.swap(other.classroomIds);
+  buildingIds.swap(other.buildingIds);
+  teacherIds.swap(other.teacherIds);
+  groupCodes.swap(other.groupCodes);
+  dayNames.swap(other.dayNames);
+  symbols.swap(other.symbols);
+  symbolIds.swap(other.symbolIds);
+}
+
+shared_ptr<Lesson> LessonTable::materialize(LessonRef row) const {
+  switch (kind(row)) {
+    case TUTORIAL:
+      return make_shared<Tutorial>(courseId(row), dayName(row), startTime(row),
+                                   durationMinutes(row), classroom(row),
+                                   building(row), teacher(row), groupId(row));
+    case LAB:
+      return make_shared<Lab>(courseId(row), dayName(row), startTime(row),
+                              durationMinutes(row), classroom(row),
+                              building(row), teacher(row), groupId(row));
+    default:
+      return make_shared<Lecture>(courseId(row), dayName(row), startTime(row),
+                                  durationMinutes(row), classroom(row),
+                                  building(row), teacher(row), groupId(row));
+  }
+}
+
+// =================== DECODING ===================
+
+string LessonTable::startTime(LessonRef row) const {
+  uint16_t minute = startMinutes[row];
+  if (minute == NO_START) return string();
+  char buffer[8];
+  snprintf(buffer, sizeof(buffer), "%02d:%02d", minute / 60, minute % 60);
+  return buffer;
+}
+
+string LessonTable::groupId(LessonRef row) const {
+  uint16_t code = groupCodes[row];
+  if (code & GROUP_SYMBOL) return symbols[code & ~GROUP_SYMBOL].str();
+  return groupPrefixText(code >> 12) + to_string(code & GROUP_NUMBER_MASK);
+}
+
+bool LessonTable::findGroupCode(const string& groupId, uint16_t& code) const {
+  if (packCanonicalGroup(groupId, code)) return true;
+  uint32_t symbolId = 0;
+  if (!StringPool::global().find(groupId, symbolId)) return false;
+  auto it = symbolIds.find(symbolId);
+  if (it == symbolIds.end()) return false;
+  code = GROUP_SYMBOL | it->second;
+  return true;
+}
+
+// =================== HELPERS ===================
+
+const char* LessonTable::kindName(Kind kind) {
+  switch (kind) {
+    case TUTORIAL:
+      return "Tutorial";
+    case LAB:
+      return "Lab";
+    default:
+      return "Lecture";
+  }
+}
+
+bool LessonTable::parseKind(const string& name, Kind& kind) {
+  if (name == "Lecture") {
+    kind = LECTURE;
+  } else if (name == "Tutorial") {
+    kind = TUTORIAL;
+  } else if (name == "Lab") {
+    kind = LAB;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+uint16_t LessonTable::parseStartMinute(const string& startTime) {
+  // Only the "HH:MM" spelling is accepted, so rendering gives back the input
+  if (startTime.size() != 5 || startTime[2] != ':') return NO_START;
+  for (size_t i : {0, 1, 3, 4}) {
+    if (startTime[i] < '0' || startTime[i] > '9') return NO_START;
+  }
+  int hours = (startTime[0] - '0') * 10 + (startTime[1] - '0');
+  int minutes = (startTime[3] - '0') * 10 + (startTime[4] - '0');
+  if (hours > 23 || minutes > 59) return NO_START;
+  return static_cast<uint16_t>(hours * 60 + minutes);
+}
+
+int LessonTable::dayIndexOf(const string& day) {
+  for (int i = 0; i < 7; i++) {
+    if (day == DAY_NAMES[i]) return i;
+  }
+  return -1;
+}
+
+size_t LessonTable::memoryBytes() const {
+  size_t bytes = columnBytes(courseIds) + columnBytes(kinds) +
+                 columnBytes(days) + columnBytes(startMinutes) +
+                 columnBytes(durations) + columnBytes(classroomIds) +
+                 columnBytes(buildingIds) + columnBytes(teacherIds) +
+                 columnBytes(groupCodes);
+  bytes += columnBytes(dayNames) + columnBytes(symbols);
+  // Hash nodes: key, ID and next pointer, plus the bucket array
+  bytes += symbolIds.size() * (sizeof(uint32_t) + 2 * sizeof(void*)) +
+           symbolIds.bucket_count() * sizeof(void*);
+  return bytes;
+}
+
+uint8_t LessonTable::internDay(Symbol day) {
+  // The weekdays are seeded in day-index order
+  int index = day.dayIndex();
+  if (index >= 0) return static_cast<uint8_t>(index);
+  for (size_t i = 0; i < dayNames.size(); i++) {
+    if (dayNames[i] == day) return static_cast<uint8_t>(i);
+  }
+  if (dayNames.size() > 0xFF) throw length_error("LessonTable day names");
+  dayNames.push_back(day);
+  return static_cast<uint8_t>(dayNames.size() - 1);
+}
+
+uint16_t LessonTable::intern(Symbol value) {
+  auto it = symbolIds.find(value.getId());
+  if (it != symbolIds.end()) return it->second;
+  if (symbols.size() >= GROUP_SYMBOL) throw length_error("LessonTable strings");
+
+  uint16_t id = static_cast<uint16_t>(symbols.size());
+  symbols.push_back(value);
+  symbolIds.emplace(value.getId(), id);
+  return id;
+}
+
+uint16_t LessonTable::packGroup(const string& groupId) {
+  uint16_t code = 0;
+  if (packCanonicalGroup(groupId, code)) return code;
+  return GROUP_SYMBOL | intern(groupId);
+}
+
+bool LessonTable::packCanonicalGroup(const string& groupId, uint16_t& code) {
+  for (const GroupPrefix& prefix : GROUP_PREFIXES) {
+    if (groupId.compare(0, prefix.length, prefix.text) != 0) continue;
+
+    // The number must round-trip exactly: digits only, no leading zero
+    size_t digits = groupId.size() - prefix.length;
+    if (digits == 0 || digits > 4 || groupId[prefix.length] == '0') {
+      return false;
+    }
+    int number = 0;
+    for (size_t i = prefix.length; i < groupId.size(); i++) {
+      if (groupId[i] < '0' || groupId[i] > '9') return false;
+      number = number * 10 + (groupId[i] - '0');
+    }
+    if (number > GROUP_NUMBER_MASK) return false;
+    code = static_cast<uint16_t>((prefix.tag << 12) | number);
+    return true;
+  }
+  return false;
+}
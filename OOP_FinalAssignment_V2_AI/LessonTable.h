@@ -0,0 +1,211 @@
+#ifndef LESSON_TABLE_H
+#define LESSON_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Lesson.h"
+#include "StringPool.h"
+
+using namespace std;
+
+/** @brief Index of a lesson row inside a LessonTable */
+typedef uint32_t LessonRef;
+
+class LessonView;
+
+/**
+ * @class LessonTable
+ * @brief Structure-of-arrays store for every lesson in the system
+ *
+ * A Lesson object carries its fields behind a shared_ptr and a vtable.
+ * The table instead keeps one small column per field:
+ *   - day         uint8   index into the day names (Sunday = 0)
+ *   - start       uint16  minutes after midnight
+ *   - duration    uint16  minutes
+ *   - kind        uint8   Lecture / Tutorial / Lab
+ *   - room, building, teacher  uint16 local IDs of pooled Symbols
+ *   - group       uint16  packed code ("LB2" = LB << 12 | 2)
+ * so a row costs 18 bytes, and courseLessons and Schedule hold 32-bit
+ * LessonRef indices into it. The text behind each ID lives once in the
+ * StringPool. Conflict checks and rendering scan the day and start columns
+ * without touching the strings at all.
+ *
+ * Rows are append-only: a LessonRef stays valid until clear().
+ */
+class LessonTable {
+ public:
+  enum Kind : uint8_t { LECTURE = 0, TUTORIAL = 1, LAB = 2 };
+
+  /** @brief Start column value for a time that could not be parsed */
+  static const uint16_t NO_START = 0xFFFF;
+
+  /** @brief Sunday ... Saturday, in day-index order */
+  static const char* const DAY_NAMES[7];
+
+  LessonTable();
+
+  /**
+   * @brief Append one lesson
+   * @param startTime "HH:MM"; anything else is stored as NO_START
+   * @throws length_error once a dictionary runs out of IDs
+   */
+  LessonRef add(int courseId, Kind kind, Symbol day, const string& startTime,
+                int durationMinutes, Symbol classroom, Symbol building,
+                Symbol teacher, const string& groupId);
+
+  /**
+   * @brief Append every row of another table, remapping its local IDs
+   * @return Ref of the first copied row; the rest follow in order
+   */
+  LessonRef append(const LessonTable& other);
+
+  /** @brief Append one row of another table */
+  LessonRef copyRow(const LessonTable& other, LessonRef row);
+
+  /** @brief True if this row and a row of another table hold equal values */
+  bool sameLesson(LessonRef row, const LessonTable& other,
+                  LessonRef otherRow) const;
+
+  /** @brief Preallocate every column for `rows` rows */
+  void reserve(size_t rows);
+
+  size_t size() const { return courseIds.size(); }
+  bool empty() const { return courseIds.empty(); }
+  void clear();
+  void swap(LessonTable& other);
+
+  LessonView view(LessonRef row) const;
+
+  /** @brief Build a standalone Lesson object, for code that needs one */
+  shared_ptr<Lesson> materialize(LessonRef row) const;
+
+  // =================== COLUMNS ===================
+
+  int courseId(LessonRef row) const { return courseIds[row]; }
+  Kind kind(LessonRef row) const { return static_cast<Kind>(kinds[row]); }
+  uint8_t dayIndex(LessonRef row) const { return days[row]; }
+  uint16_t startMinute(LessonRef row) const { return startMinutes[row]; }
+  uint16_t durationMinutes(LessonRef row) const { return durations[row]; }
+  uint16_t groupCode(LessonRef row) const { return groupCodes[row]; }
+  uint16_t classroomId(LessonRef row) const { return classroomIds[row]; }
+  uint16_t buildingId(LessonRef row) const { return buildingIds[row]; }
+  uint16_t teacherId(LessonRef row) const { return teacherIds[row]; }
+
+  // =================== DECODED VALUES ===================
+
+  Symbol daySymbol(LessonRef row) const { return dayNames[days[row]]; }
+  Symbol classroomSymbol(LessonRef row) const {
+    return symbols[classroomIds[row]];
+  }
+  Symbol buildingSymbol(LessonRef row) const {
+    return symbols[buildingIds[row]];
+  }
+  Symbol teacherSymbol(LessonRef row) const {
+    return symbols[teacherIds[row]];
+  }
+
+  const string& dayName(LessonRef row) const { return daySymbol(row).str(); }
+  string startTime(LessonRef row) const;
+  const string& classroom(LessonRef row) const {
+    return classroomSymbol(row).str();
+  }
+  const string& building(LessonRef row) const {
+    return buildingSymbol(row).str();
+  }
+  const string& teacher(LessonRef row) const {
+    return teacherSymbol(row).str();
+  }
+  string groupId(LessonRef row) const;
+  string lessonType(LessonRef row) const { return kindName(kind(row)); }
+
+  /**
+   * @brief Packed code of a group name, without adding it to the table
+   * @return false if no row of this table can carry that group
+   */
+  bool findGroupCode(const string& groupId, uint16_t& code) const;
+
+  // =================== HELPERS ===================
+
+  /** @return "Lecture", "Tutorial" or "Lab" */
+  static const char* kindName(Kind kind);
+
+  /** @brief Parse "Lecture" / "Tutorial" / "Lab" */
+  static bool parseKind(const string& name, Kind& kind);
+
+  /** @return Minutes after midnight, or NO_START */
+  static uint16_t parseStartMinute(const string& startTime);
+
+  /** @return 0 (Sunday) ... 6 (Saturday), or -1 for any other name */
+  static int dayIndexOf(const string& day);
+
+  /** @brief Bytes held by the columns and ID maps (text is in the pool) */
+  size_t memoryBytes() const;
+
+ private:
+  // Group codes: prefix in the top nibble, number below. Names that do not
+  // fit the pattern are interned and tagged with GROUP_SYMBOL.
+  static const uint16_t GROUP_SYMBOL = 0x8000;
+
+  uint8_t internDay(Symbol day);
+  uint16_t intern(Symbol value);
+  uint16_t packGroup(const string& groupId);
+  static bool packCanonicalGroup(const string& groupId, uint16_t& code);
+
+  vector<int32_t> courseIds;
+  vector<uint8_t> kinds;
+  vector<uint8_t> days;
+  vector<uint16_t> startMinutes;
+  vector<uint16_t> durations;
+  vector<uint16_t> classroomIds;
+  vector<uint16_t> buildingIds;
+  vector<uint16_t> teacherIds;
+  vector<uint16_t> groupCodes;
+
+  vector<Symbol> dayNames;  // The seven weekdays, then any other spelling
+  vector<Symbol> symbols;
+  unordered_map<uint32_t, uint16_t> symbolIds;  // Symbol ID -> local ID
+};
+
+/**
+ * @class LessonView
+ * @brief Read-only handle to one table row with the Lesson getter names
+ *
+ * Cheap to copy; valid while the table is alive and not cleared.
+ */
+class LessonView {
+ public:
+  LessonView(const LessonTable& lessonTable, LessonRef lessonRef)
+      : table(&lessonTable), row(lessonRef) {}
+
+  LessonRef ref() const { return row; }
+
+  int getCourseId() const { return table->courseId(row); }
+  const string& getDay() const { return table->dayName(row); }
+  Symbol getDaySymbol() const { return table->daySymbol(row); }
+  string getStartTime() const { return table->startTime(row); }
+  int getDuration() const { return table->durationMinutes(row); }
+  const string& getClassroom() const { return table->classroom(row); }
+  const string& getBuilding() const { return table->building(row); }
+  const string& getTeacher() const { return table->teacher(row); }
+  string getGroupId() const { return table->groupId(row); }
+  string getLessonType() const { return table->lessonType(row); }
+
+  LessonTable::Kind getKind() const { return table->kind(row); }
+  int getDayIndex() const { return table->dayIndex(row); }
+  int getStartMinute() const { return table->startMinute(row); }
+
+ private:
+  const LessonTable* table;
+  LessonRef row;
+};
+
+inline LessonView LessonTable::view(LessonRef row) const {
+  return LessonView(*this, row);
+}
+
+#endif  // LESSON_TABLE_H
@@ -0,0 +1,70 @@
+#include "ParetoFront.h"
+
+#include <algorithm>
+
+bool ParetoFront::covers(const double* first, const double* second) {
+  for (int i = 0; i < OBJECTIVES; i++) {
+    if (first[i] > second[i]) return false;
+  }
+  return true;
+}
+
+bool ParetoFront::dominates(const double* first, const double* second) {
+  bool better = false;
+  for (int i = 0; i < OBJECTIVES; i++) {
+    if (first[i] > second[i]) return false;
+    if (first[i] < second[i]) better = true;
+  }
+  return better;
+}
+
+bool ParetoFront::before(const double* objectives, size_t candidate,
+                         const Point& point) {
+  for (int i = 0; i < OBJECTIVES; i++) {
+    if (objectives[i] != point.objectives[i]) {
+      return objectives[i] < point.objectives[i];
+    }
+  }
+  return candidate < point.candidate;
+}
+
+size_t ParetoFront::position(const double* objectives,
+                             size_t candidate) const {
+  size_t low = 0;
+  size_t high = front.size();
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (before(objectives, candidate, front[middle])) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return low;
+}
+
+bool ParetoFront::admits(const double* objectives, size_t candidate) const {
+  // Only points lexicographically before it can cover it
+  size_t end = position(objectives, candidate);
+  for (size_t i = 0; i < end; i++) {
+    if (covers(front[i].objectives, objectives)) return false;
+  }
+  return true;
+}
+
+bool ParetoFront::offer(Point& point) {
+  size_t at = position(point.objectives, point.candidate);
+  for (size_t i = 0; i < at; i++) {
+    if (covers(front[i].objectives, point.objectives)) return false;
+  }
+
+  // Only points after it can be covered by it
+  auto kept = remove_if(front.begin() + at, front.end(),
+                        [&](const Point& other) {
+                          return covers(point.objectives, other.objectives);
+                        });
+  removed += static_cast<size_t>(front.end() - kept);
+  front.erase(kept, front.end());
+  front.insert(front.begin() + at, move(point));
+  return true;
+}
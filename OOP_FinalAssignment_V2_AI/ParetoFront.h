@@ -0,0 +1,82 @@
+#ifndef PARETO_FRONT_H
+#define PARETO_FRONT_H
+
+#include <cstddef>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class ParetoFront
+ * @brief The schedules no other schedule seen so far beats on every
+ *        objective
+ *
+ * Every objective is minimized: credit deviation, idle minutes, days with
+ * a lesson (fewer is more free days) and days starting early. One schedule
+ * covers another when it is no worse on any objective; of two with equal
+ * objectives the earlier candidate is kept, so the front does not depend
+ * on the order schedules arrive in.
+ *
+ * The front is kept in lexicographic order of the objectives, as in
+ * efficient non-dominated sorting: a schedule can only be covered by those
+ * before its position and can only cover those after it, so each offer
+ * scans the prefix until a cover is found and filters the suffix, never
+ * comparing both ways. Memory is O(front size).
+ *
+ * Not thread-safe; a parallel search offers under a lock.
+ */
+class ParetoFront {
+ public:
+  enum Objective {
+    CREDIT_DEVIATION,  // |credits - target|
+    IDLE_MINUTES,      // Between lessons of the same day
+    DAYS_USED,         // 7 minus the free days
+    EARLY_STARTS,      // Days whose first lesson starts early
+    OBJECTIVES
+  };
+
+  /** @brief One schedule on the front */
+  struct Point {
+    size_t candidate = 0;   // Position in the search, breaks ties
+    vector<int> courseIds;  // Ascending
+    vector<LessonRef> lessons;
+    double credits = 0;
+    double objectives[OBJECTIVES] = {0, 0, 0, 0};
+  };
+
+  /** @brief Whether a schedule with these objectives would join the front */
+  bool admits(const double* objectives, size_t candidate) const;
+
+  /**
+   * @brief Consider a schedule, dropping every point it covers
+   * @return true if it is now on the front (and point was moved there)
+   */
+  bool offer(Point& point);
+
+  size_t size() const { return front.size(); }
+
+  /** @brief Points dropped because a later schedule covered them */
+  size_t displaced() const { return removed; }
+
+  /** @brief The front in lexicographic order of the objectives */
+  const vector<Point>& points() const { return front; }
+
+  /** @brief No worse on any objective and better on at least one */
+  static bool dominates(const double* first, const double* second);
+
+ private:
+  // Lexicographic by objectives, then candidate
+  static bool before(const double* objectives, size_t candidate,
+                     const Point& point);
+  // No worse on any objective
+  static bool covers(const double* first, const double* second);
+
+  size_t position(const double* objectives, size_t candidate) const;
+
+  vector<Point> front;
+  size_t removed = 0;
+};
+
+#endif  // PARETO_FRONT_H
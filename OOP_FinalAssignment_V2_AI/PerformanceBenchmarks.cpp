@@ -0,0 +1,2912 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "AllocationCounter.h"
+#include "BulkScheduler.h"
+#include "CandidateSearch.h"
+#include "CreditSubsets.h"
+#include "FeasibilityCache.h"
+#include "ParetoFront.h"
+#include "ScheduleManager.h"
+#include "SchedulePreferences.h"
+#include "ScheduleQuality.h"
+#include "SearchBudget.h"
+#include "SectionSolver.h"
+#include "TopSchedules.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// =================== BENCHMARK HELPERS ===================
+
+namespace {
+
+bool makeDirectory(const string& path) {
+#ifdef _WIN32
+  return _mkdir(path.c_str()) == 0;
+#else
+  return mkdir(path.c_str(), 0755) == 0;
+#endif
+}
+
+void removeDirectory(const string& path) {
+#ifdef _WIN32
+  _rmdir(path.c_str());
+#else
+  rmdir(path.c_str());
+#endif
+}
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+      .count();
+}
+
+string lessonFileSuffix(const string& lessonType) {
+  if (lessonType == "Tutorial") return "tutorials.csv";
+  if (lessonType == "Lab") return "labs.csv";
+  return "lectures.csv";
+}
+
+/**
+ * @brief Write a synthetic catalog that repeats the template catalog
+ *        `scale` times with shifted course IDs
+ * @return Names of all files written (relative to dir)
+ */
+vector<string> writeScaledCatalog(
+    const string& dir, int scale, const vector<Course>& templateCourses,
+    const LessonTable& table,
+    const map<int, vector<LessonRef>>& templateLessons) {
+  vector<string> written;
+
+  ofstream coursesFile(dir + "courses.csv");
+  coursesFile << "CourseID,Name,ExamDateA_Day,ExamDateA_Month,ExamDateA_Year,"
+                 "ExamDateB_Day,ExamDateB_Month,ExamDateB_Year,Credits,"
+                 "Lecturer\n";
+  written.push_back("courses.csv");
+
+  for (int copy = 0; copy < scale; copy++) {
+    for (const Course& course : templateCourses) {
+      int courseId = course.getCourseId() + copy * 1000000;
+      string examA = course.getExamDateA();
+      string examB = course.getExamDateB();
+      replace(examA.begin(), examA.end(), '/', ',');
+      replace(examB.begin(), examB.end(), '/', ',');
+      coursesFile << courseId << "," << course.getName() << "," << examA << ","
+                  << examB << "," << course.getCredits() << ","
+                  << course.getLecturer() << "\n";
+
+      map<string, ofstream> lessonFiles;
+      for (const char* suffix : {"lectures.csv", "tutorials.csv", "labs.csv"}) {
+        string name = to_string(courseId) + "_" + suffix;
+        lessonFiles[suffix].open(dir + name);
+        lessonFiles[suffix]
+            << "CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,"
+               "GroupID\n";
+        written.push_back(name);
+      }
+
+      auto lessonsIt = templateLessons.find(course.getCourseId());
+      if (lessonsIt == templateLessons.end()) continue;
+      for (LessonRef ref : lessonsIt->second) {
+        LessonView lesson = table.view(ref);
+        lessonFiles[lessonFileSuffix(lesson.getLessonType())]
+            << courseId << "," << lesson.getDay() << ","
+            << lesson.getStartTime() << "," << (lesson.getDuration() / 60)
+            << "," << lesson.getClassroom() << "," << lesson.getBuilding()
+            << "," << lesson.getTeacher() << "," << lesson.getGroupId()
+            << "\n";
+      }
+    }
+  }
+  return written;
+}
+
+/**
+ * @brief Write a schedule store with schedules 1..count that each hold
+ *        `lessonsPerSchedule` lessons drawn round-robin from the catalog
+ * @return Name of the file written (relative to dir)
+ */
+string writeScheduleStore(const string& dir, int count, int lessonsPerSchedule,
+                          const LessonTable& templateLessons) {
+  ofstream file(dir + ScheduleStore::FILE_NAME);
+  file << ScheduleStore::HEADER << "\n";
+  size_t next = 0;
+  for (int id = 1; id <= count; id++) {
+    file << "S," << id << "\n";
+    for (int i = 0; i < lessonsPerSchedule; i++) {
+      LessonView lesson = templateLessons.view(
+          static_cast<LessonRef>(next++ % templateLessons.size()));
+      file << "+," << ScheduleStore::formatRow(id, lesson) << "\n";
+    }
+  }
+  return ScheduleStore::FILE_NAME;
+}
+
+// Order-sensitive fingerprint of loaded lessons, to compare two loads
+uint64_t fingerprintLessons(const LessonTable& table,
+                            const vector<LessonRef>& lessons, uint64_t hash) {
+  for (LessonRef lesson : lessons) {
+    string key = to_string(table.courseId(lesson)) + table.groupId(lesson) +
+                 table.dayName(lesson) + table.startTime(lesson);
+    for (char c : key) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+// The groups of every lesson type of the courses, Lecture, Tutorial, Lab
+vector<vector<LessonRef>> lessonTypeGroups(const CourseLessonIndex& index,
+                                           const vector<int>& courseIds) {
+  vector<vector<LessonRef>> types;
+  for (int courseId : courseIds) {
+    for (LessonTable::Kind kind :
+         {LessonTable::LECTURE, LessonTable::TUTORIAL, LessonTable::LAB}) {
+      if (!index.groups(courseId, kind).empty()) {
+        types.push_back(index.groups(courseId, kind));
+      }
+    }
+  }
+  return types;
+}
+
+// Chronological backtracking with no ordering or pruning: slow but exact
+bool backtrackGroups(const SectionCompatibility& compatibility,
+                     const vector<vector<LessonRef>>& types,
+                     vector<LessonRef>& chosen) {
+  if (chosen.size() == types.size()) return true;
+  for (LessonRef group : types[chosen.size()]) {
+    bool fits = true;
+    for (LessonRef other : chosen) {
+      if (compatibility.clash(group, other)) fits = false;
+    }
+    if (!fits) continue;
+    chosen.push_back(group);
+    if (backtrackGroups(compatibility, types, chosen)) return true;
+    chosen.pop_back();
+  }
+  return false;
+}
+
+// The optimizer's former combination test: open each course's lecture, lab
+// and tutorial files and keep the first group whose times fit, comparing
+// "HH:MM" strings against everything placed so far
+bool firstFitFromFiles(const string& dir, const vector<int>& courseIds,
+                       int& filesOpened) {
+  struct Placed {
+    Symbol day;
+    string startTime;
+    int duration;
+  };
+  auto minutes = [](const string& time) {
+    size_t colon = time.find(':');
+    if (colon == string::npos) return -1;
+    return stoi(time.substr(0, colon)) * 60 + stoi(time.substr(colon + 1));
+  };
+
+  vector<Placed> placed;
+  for (int courseId : courseIds) {
+    for (const char* suffix :
+         {"_lectures.csv", "_labs.csv", "_tutorials.csv"}) {
+      CsvReader reader(dir + to_string(courseId) + suffix);
+      filesOpened++;
+      bool added = false;
+      if (reader.isOpen()) {
+        reader.nextRow();  // Skip header
+        while (!added && reader.nextRow()) {
+          if (reader.fieldCount() < 8) continue;
+          Placed lesson = {reader[1].symbol(), reader[2].str(),
+                           reader[3].toInt()};
+          bool fits = true;
+          for (const Placed& other : placed) {
+            if (other.day != lesson.day) continue;
+            int start = minutes(lesson.startTime);
+            int otherStart = minutes(other.startTime);
+            if (start < otherStart + other.duration * 60 &&
+                otherStart < start + lesson.duration * 60) {
+              fits = false;
+              break;
+            }
+          }
+          if (fits) {
+            placed.push_back(lesson);
+            added = true;
+          }
+        }
+      }
+      if (!added) return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// =================== PERFORMANCE BENCHMARKS ===================
+
+void ScheduleManager::runPerformanceBenchmark(const string& name) {
+  string benchmark = name;
+  transform(benchmark.begin(), benchmark.end(), benchmark.begin(), ::tolower);
+
+  if (benchmark == "catalog") {
+    runCatalogBenchmark();
+  } else if (benchmark == "csv") {
+    runCsvBenchmark();
+  } else if (benchmark == "load") {
+    runLoadBenchmark();
+  } else if (benchmark == "lessons") {
+    runLessonTableBenchmark();
+  } else if (benchmark == "strings") {
+    runStringPoolBenchmark();
+  } else if (benchmark == "store") {
+    runScheduleStoreBenchmark();
+  } else if (benchmark == "persistence") {
+    runPersistenceBenchmark();
+  } else if (benchmark == "index") {
+    runScheduleIndexBenchmark();
+  } else if (benchmark == "compat") {
+    runCompatibilityBenchmark();
+  } else if (benchmark == "solver") {
+    runSectionSolverBenchmark();
+  } else if (benchmark == "optimizer") {
+    runOptimizerBenchmark();
+  } else if (benchmark == "search") {
+    runCandidateSearchBenchmark();
+  } else if (benchmark == "credits") {
+    runCreditSubsetBenchmark();
+  } else if (benchmark == "anytime") {
+    runAnytimeSearchBenchmark();
+  } else if (benchmark == "topk") {
+    runTopSchedulesBenchmark();
+  } else if (benchmark == "prefs") {
+    runPreferencesBenchmark();
+  } else if (benchmark == "pareto") {
+    runParetoFrontBenchmark();
+  } else if (benchmark == "cache") {
+    runFeasibilityCacheBenchmark();
+  } else if (benchmark == "bulk") {
+    runBulkScheduleBenchmark();
+  } else {
+    cout << RED << "[ERROR] Unknown benchmark: " << name << RESET << endl;
+    cout << BRIGHT_GREEN
+         << "  [OK] Available benchmarks: catalog, csv, load, lessons, "
+            "strings, store, persistence, index, compat, solver, "
+            "optimizer, search, credits, anytime, topk, prefs, pareto, "
+            "cache, bulk"
+         << RESET << endl;
+  }
+}
+
+void ScheduleManager::runCatalogBenchmark() {
+  printTestHeader("CATALOG STARTUP BENCHMARK (CSV vs SNAPSHOT)");
+
+  if (courses.empty()) {
+    cout << RED << "[ERROR] No catalog loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  const vector<Course> templateCourses = courses;
+  const string originalDirectory = dataDirectory;
+
+  struct Result {
+    int scale;
+    size_t courseCount;
+    size_t lessonCount;
+    double csvMs;
+    double saveMs;
+    double snapshotMs;
+    bool verified;
+  };
+  vector<Result> results;
+
+  for (int scale : {10, 100}) {
+    string dir = originalDirectory + "bench_catalog_x" + to_string(scale) + "/";
+    makeDirectory(dir);
+    vector<string> written = writeScaledCatalog(dir, scale, templateCourses,
+                                                lessonTable, courseLessons);
+
+    // Let the clock move past the sources' mtime; otherwise every file is
+    // "racily clean" and the snapshot re-hashes all of them on load, which is
+    // not what a normal startup against an unchanged catalog looks like.
+    this_thread::sleep_for(chrono::milliseconds(1100));
+
+    // Point the regular CSV loaders at the synthetic catalog
+    vector<Course> benchCourses;
+    LessonTable benchTable;
+    map<int, vector<LessonRef>> benchLessons;
+    courses.swap(benchCourses);
+    lessonTable.swap(benchTable);
+    courseLessons.swap(benchLessons);
+    dataDirectory = dir;
+
+    Result result = {scale, 0, 0, 0, 0, 0, false};
+
+    auto start = chrono::steady_clock::now();
+    loadCourses();
+    loadLessons();
+    result.csvMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    CatalogSnapshot::save(dir, courses, lessonTable, courseLessons);
+    result.saveMs = elapsedMs(start);
+
+    vector<Course> snapshotCourses;
+    LessonTable snapshotTable;
+    map<int, vector<LessonRef>> snapshotLessons;
+    start = chrono::steady_clock::now();
+    bool loaded = CatalogSnapshot::load(dir, snapshotCourses, snapshotTable,
+                                        snapshotLessons);
+    result.snapshotMs = elapsedMs(start);
+
+    result.courseCount = courses.size();
+    for (const auto& entry : courseLessons) {
+      result.lessonCount += entry.second.size();
+    }
+    size_t snapshotLessonCount = 0;
+    for (const auto& entry : snapshotLessons) {
+      snapshotLessonCount += entry.second.size();
+    }
+    result.verified = loaded && snapshotCourses.size() == courses.size() &&
+                      snapshotLessonCount == result.lessonCount;
+
+    // Restore the live catalog
+    courses.swap(benchCourses);
+    lessonTable.swap(benchTable);
+    courseLessons.swap(benchLessons);
+    dataDirectory = originalDirectory;
+
+    for (const string& file : written) {
+      remove((dir + file).c_str());
+    }
+    remove((dir + CatalogSnapshot::FILE_NAME).c_str());
+    removeDirectory(dir);
+
+    results.push_back(result);
+  }
+
+  Schedule::setCourseDatabase(courses);
+
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(8) << "Scale" << setw(10)
+       << "Courses" << setw(10) << "Lessons" << setw(14) << "CSV (ms)"
+       << setw(16) << "Snapshot (ms)" << setw(12) << "Speedup"
+       << "Build (ms)" << RESET << endl;
+  cout << GRAY << string(78, '-') << RESET << endl;
+  for (const Result& result : results) {
+    double speedup =
+        result.snapshotMs > 0 ? result.csvMs / result.snapshotMs : 0.0;
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(8)
+         << (to_string(result.scale) + "x") << RESET << setw(10)
+         << result.courseCount << setw(10) << result.lessonCount << setw(14)
+         << result.csvMs << setw(16) << result.snapshotMs << BRIGHT_GREEN
+         << setw(12) << speedup << RESET
+         << result.saveMs << endl;
+    printTestResult("Snapshot round-trip at " + to_string(result.scale) + "x",
+                    result.verified);
+  }
+  cout << right;
+}
+
+void ScheduleManager::runCsvBenchmark() {
+  printTestHeader("CSV TOKENIZER BENCHMARK (STRINGSTREAM vs MAPPED)");
+
+  vector<LessonRef> templateLessons;
+  for (const auto& entry : courseLessons) {
+    templateLessons.insert(templateLessons.end(), entry.second.begin(),
+                           entry.second.end());
+  }
+  if (templateLessons.empty()) {
+    cout << RED << "[ERROR] No lessons loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  // Synthetic lesson file in the regular lesson CSV layout
+  const size_t ROW_COUNT = 200000;
+  const string path = dataDirectory + "bench_lessons.csv";
+  {
+    ofstream file(path);
+    file << "CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,"
+            "GroupID\n";
+    for (size_t i = 0; i < ROW_COUNT; i++) {
+      LessonView lesson =
+          lessonTable.view(templateLessons[i % templateLessons.size()]);
+      file << lesson.getCourseId() << "," << lesson.getDay() << ","
+           << lesson.getStartTime() << "," << (lesson.getDuration() / 60)
+           << "," << lesson.getClassroom() << "," << lesson.getBuilding()
+           << "," << lesson.getTeacher() << "," << lesson.getGroupId()
+           << "\n";
+    }
+  }
+
+  struct Result {
+    string parser;
+    size_t rows;
+    long long checksum;
+    double bestMs;
+    size_t allocations;
+  };
+  Result legacy = {"getline + stringstream", 0, 0, 0, 0};
+  Result mapped = {"CsvReader (mapped)", 0, 0, 0, 0};
+
+  // Best of three, so the first pass also warms the page cache
+  const int RUNS = 3;
+  for (int run = 0; run < RUNS; run++) {
+    size_t rows = 0;
+    long long checksum = 0;
+    size_t allocationsBefore = heapAllocationCount();
+    auto start = chrono::steady_clock::now();
+    {
+      ifstream file(path);
+      string line;
+      getline(file, line);  // Skip header
+      while (getline(file, line)) {
+        stringstream ss(line);
+        string item;
+        vector<string> tokens;
+        while (getline(ss, item, ',')) {
+          tokens.push_back(item);
+        }
+        if (tokens.size() >= 8) {
+          checksum += stoi(tokens[0]) + stoi(tokens[3]) +
+                      static_cast<long long>(tokens[7].size());
+          rows++;
+        }
+      }
+    }
+    double ms = elapsedMs(start);
+    if (run == 0 || ms < legacy.bestMs) legacy.bestMs = ms;
+    legacy.allocations = heapAllocationCount() - allocationsBefore;
+    legacy.rows = rows;
+    legacy.checksum = checksum;
+
+    rows = 0;
+    checksum = 0;
+    allocationsBefore = heapAllocationCount();
+    start = chrono::steady_clock::now();
+    {
+      CsvReader reader(path);
+      reader.nextRow();  // Skip header
+      while (reader.nextRow()) {
+        if (reader.fieldCount() >= 8) {
+          checksum += reader[0].toInt() + reader[3].toInt() +
+                      static_cast<long long>(reader[7].size);
+          rows++;
+        }
+      }
+    }
+    ms = elapsedMs(start);
+    if (run == 0 || ms < mapped.bestMs) mapped.bestMs = ms;
+    mapped.allocations = heapAllocationCount() - allocationsBefore;
+    mapped.rows = rows;
+    mapped.checksum = checksum;
+  }
+
+  remove(path.c_str());
+
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(26) << "Parser" << setw(10)
+       << "Rows" << setw(12) << "Best (ms)" << setw(16) << "Rows/sec"
+       << "Allocs/row" << RESET << endl;
+  cout << GRAY << string(74, '-') << RESET << endl;
+  for (const Result* result : {&legacy, &mapped}) {
+    double rowsPerSec =
+        result->bestMs > 0 ? result->rows / (result->bestMs / 1000.0) : 0.0;
+    double allocsPerRow =
+        result->rows > 0
+            ? static_cast<double>(result->allocations) / result->rows
+            : 0.0;
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(26)
+         << result->parser << RESET << setw(10) << result->rows << setw(12)
+         << result->bestMs << setprecision(0) << setw(16) << rowsPerSec
+         << setprecision(3) << allocsPerRow << endl;
+  }
+  cout << right;
+
+  double speedup = mapped.bestMs > 0 ? legacy.bestMs / mapped.bestMs : 0.0;
+  cout << BRIGHT_GREEN << "\nSpeedup: " << fixed << setprecision(2) << speedup
+       << "x" << RESET << endl;
+
+  printTestResult("Mapped reader matches legacy parser",
+                  mapped.rows == legacy.rows &&
+                      mapped.checksum == legacy.checksum &&
+                      mapped.rows == ROW_COUNT);
+  if (heapCountingEnabled()) {
+    printTestResult("No per-row heap allocations", mapped.allocations == 0,
+                    to_string(mapped.allocations) + " allocations");
+  } else {
+    cout << GRAY << "  [i] Heap allocations: skipped, needs a "
+         << "BENCHMARK_ALLOCATIONS build" << RESET << endl;
+  }
+}
+
+void ScheduleManager::runLoadBenchmark() {
+  printTestHeader("PARALLEL LOAD BENCHMARK (SEQUENTIAL vs WORKER POOL)");
+
+  if (courses.empty() || courseLessons.empty()) {
+    cout << RED << "[ERROR] No catalog loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  const int SCALE = 100;
+  const int SCHEDULE_COUNT = 5000;
+  const int LESSONS_PER_SCHEDULE = 12;
+
+  const vector<Course> templateCourses = courses;
+
+  const string originalDirectory = dataDirectory;
+  const bool originalParallel = parallelLoading;
+  string dir = originalDirectory + "bench_load/";
+  makeDirectory(dir);
+
+  cout << GRAY << "Writing synthetic data directory..." << RESET << endl;
+  vector<string> written = writeScaledCatalog(dir, SCALE, templateCourses,
+                                              lessonTable, courseLessons);
+  written.push_back(writeScheduleStore(dir, SCHEDULE_COUNT,
+                                      LESSONS_PER_SCHEDULE, lessonTable));
+
+  vector<Course> savedCourses;
+  LessonTable savedTable;
+  map<int, vector<LessonRef>> savedLessons;
+  CourseLessonIndex savedLessonIndex;
+  vector<Schedule> savedSchedules;
+  ScheduleIndex savedIndex;
+  courses.swap(savedCourses);
+  lessonTable.swap(savedTable);
+  courseLessons.swap(savedLessons);
+  lessonIndex.swap(savedLessonIndex);
+  schedules.swap(savedSchedules);
+  scheduleIndex.swap(savedIndex);
+  dataDirectory = dir;
+
+  // The loaders report per file; keep that out of the benchmark output
+  ostringstream discarded;
+  streambuf* consoleBuffer = cout.rdbuf(discarded.rdbuf());
+  loadCourses();
+
+  struct Result {
+    string mode;
+    size_t threads;
+    double lessonsMs;
+    double schedulesMs;
+    size_t lessonCount;
+    uint64_t fingerprint;
+  };
+  vector<Result> results;
+
+  for (bool parallel : {false, true}) {
+    parallelLoading = parallel;
+    lessonTable.clear();
+    courseLessons.clear();
+
+    Result result = {parallel ? "Worker pool" : "Sequential",
+                     parallel ? loadPool.size() : 1, 0, 0, 0,
+                     14695981039346656037ULL};
+
+    auto start = chrono::steady_clock::now();
+    loadLessons();
+    lessonIndex.build(lessonTable, courseLessons);
+    result.lessonsMs = elapsedMs(start);
+
+    // The store is one file, read in one pass either way
+    start = chrono::steady_clock::now();
+    ScheduleStore::Contents contents;
+    ScheduleStore::read(dir + ScheduleStore::FILE_NAME, contents);
+    loadScheduleData(contents);
+    result.schedulesMs = elapsedMs(start);
+
+    for (const auto& entry : courseLessons) {
+      result.lessonCount += entry.second.size();
+      result.fingerprint =
+          fingerprintLessons(lessonTable, entry.second, result.fingerprint);
+    }
+    for (const Schedule& schedule : schedules) {
+      result.fingerprint = fingerprintLessons(
+          lessonTable, schedule.getLessons(), result.fingerprint);
+    }
+    results.push_back(result);
+  }
+
+  cout.rdbuf(consoleBuffer);
+
+  // Restore the live state
+  size_t fileCount = written.size();
+  courses.swap(savedCourses);
+  lessonTable.swap(savedTable);
+  courseLessons.swap(savedLessons);
+  lessonIndex.swap(savedLessonIndex);
+  schedules.swap(savedSchedules);
+  scheduleIndex.swap(savedIndex);
+  dataDirectory = originalDirectory;
+  parallelLoading = originalParallel;
+  Schedule::setCourseDatabase(courses);
+
+  for (const string& file : written) {
+    remove((dir + file).c_str());
+  }
+  removeDirectory(dir);
+
+  cout << GRAY << fileCount << " files, " << results[0].lessonCount
+       << " catalog lessons, " << SCHEDULE_COUNT << " schedules" << RESET
+       << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(14) << "Mode" << setw(10)
+       << "Threads" << setw(16) << "Lessons (ms)" << setw(18)
+       << "Schedules (ms)" << "Files/sec" << RESET << endl;
+  cout << GRAY << string(70, '-') << RESET << endl;
+  for (const Result& result : results) {
+    double totalMs = result.lessonsMs + result.schedulesMs;
+    double filesPerSec = totalMs > 0 ? fileCount / (totalMs / 1000.0) : 0.0;
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(14)
+         << result.mode << RESET << setw(10) << result.threads << setw(16)
+         << result.lessonsMs << setw(18) << result.schedulesMs
+         << setprecision(0) << filesPerSec << endl;
+  }
+  cout << right;
+
+  double sequentialMs = results[0].lessonsMs + results[0].schedulesMs;
+  double parallelMs = results[1].lessonsMs + results[1].schedulesMs;
+  cout << BRIGHT_GREEN << "\nSpeedup: " << fixed << setprecision(2)
+       << (parallelMs > 0 ? sequentialMs / parallelMs : 0.0) << "x" << RESET
+       << endl;
+
+  printTestResult("Parallel load matches sequential load",
+                  results[0].lessonCount == results[1].lessonCount &&
+                      results[0].fingerprint == results[1].fingerprint);
+}
+
+void ScheduleManager::runLessonTableBenchmark() {
+  printTestHeader("LESSON STORAGE BENCHMARK (OBJECTS vs LESSON TABLE)");
+
+  vector<LessonRef> catalogRefs;
+  for (const auto& entry : courseLessons) {
+    catalogRefs.insert(catalogRefs.end(), entry.second.begin(),
+                       entry.second.end());
+  }
+  if (catalogRefs.empty()) {
+    cout << RED << "[ERROR] No lessons loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  const size_t ROW_COUNT = 100000;  // Lessons held in each representation
+  const size_t SCAN_ROWS = 2000;    // All pairs of these are compared
+
+  struct Result {
+    string storage;
+    size_t bytes;
+    double scanMs;
+    long long overlaps;
+  };
+
+  // Previous representation: one Lecture/Tutorial/Lab object per lesson
+  Result objects = {"shared_ptr<Lesson>", 0, 0, 0};
+  size_t bytesBefore = heapLiveBytes();
+  vector<shared_ptr<Lesson>> objectLessons;
+  objectLessons.reserve(ROW_COUNT);
+  for (size_t i = 0; i < ROW_COUNT; i++) {
+    objectLessons.push_back(
+        lessonTable.materialize(catalogRefs[i % catalogRefs.size()]));
+  }
+  objects.bytes = heapLiveBytes() - bytesBefore;
+
+  // Same lessons as table rows plus the 32-bit refs that point at them
+  Result table = {"LessonTable", 0, 0, 0};
+  bytesBefore = heapLiveBytes();
+  LessonTable tableLessons;
+  vector<LessonRef> tableRefs;
+  tableLessons.reserve(ROW_COUNT);
+  tableRefs.reserve(ROW_COUNT);
+  for (size_t i = 0; i < ROW_COUNT; i++) {
+    tableRefs.push_back(tableLessons.copyRow(
+        lessonTable, catalogRefs[i % catalogRefs.size()]));
+  }
+  table.bytes = heapLiveBytes() - bytesBefore;
+
+  // Same-day overlap test over every pair, as the conflict checks do it
+  size_t scanRows = min(SCAN_ROWS, ROW_COUNT);
+  auto start = chrono::steady_clock::now();
+  for (size_t i = 0; i < scanRows; i++) {
+    const Lesson& a = *objectLessons[i];
+    for (size_t j = i + 1; j < scanRows; j++) {
+      const Lesson& b = *objectLessons[j];
+      if (a.getDay() != b.getDay()) continue;
+      string startA = a.getStartTime();
+      string startB = b.getStartTime();
+      int beginA = stoi(startA.substr(0, 2)) * 60 + stoi(startA.substr(3, 2));
+      int beginB = stoi(startB.substr(0, 2)) * 60 + stoi(startB.substr(3, 2));
+      if (beginA < beginB + b.getDuration() &&
+          beginB < beginA + a.getDuration()) {
+        objects.overlaps++;
+      }
+    }
+  }
+  objects.scanMs = elapsedMs(start);
+
+  start = chrono::steady_clock::now();
+  for (size_t i = 0; i < scanRows; i++) {
+    LessonRef a = tableRefs[i];
+    int dayA = tableLessons.dayIndex(a);
+    int beginA = tableLessons.startMinute(a);
+    int endA = beginA + tableLessons.durationMinutes(a);
+    for (size_t j = i + 1; j < scanRows; j++) {
+      LessonRef b = tableRefs[j];
+      if (tableLessons.dayIndex(b) != dayA) continue;
+      int beginB = tableLessons.startMinute(b);
+      if (beginA < beginB + tableLessons.durationMinutes(b) && beginB < endA) {
+        table.overlaps++;
+      }
+    }
+  }
+  table.scanMs = elapsedMs(start);
+
+  cout << GRAY << ROW_COUNT << " lessons stored, " << scanRows
+       << " scanned pairwise" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(22) << "Storage" << setw(16)
+       << "Bytes/lesson" << setw(14) << "Scan (ms)" << "Overlaps" << RESET
+       << endl;
+  cout << GRAY << string(62, '-') << RESET << endl;
+  for (const Result* result : {&objects, &table}) {
+    cout << left << fixed << setprecision(1) << BRIGHT_CYAN << setw(22)
+         << result->storage << RESET << setw(16)
+         << static_cast<double>(result->bytes) / ROW_COUNT << setprecision(2)
+         << setw(14) << result->scanMs << result->overlaps << endl;
+  }
+  cout << right;
+
+  double ratio = objects.bytes > 0
+                     ? static_cast<double>(table.bytes) / objects.bytes
+                     : 0.0;
+  double speedup = table.scanMs > 0 ? objects.scanMs / table.scanMs : 0.0;
+  cout << BRIGHT_GREEN << "\nMemory: " << fixed << setprecision(3) << ratio
+       << "x of objects | Scan speedup: " << setprecision(2) << speedup << "x"
+       << RESET << endl;
+
+  if (heapCountingEnabled()) {
+    printTestResult("Table under a quarter of object bytes", ratio < 0.25,
+                    to_string(table.bytes / ROW_COUNT) + " vs " +
+                        to_string(objects.bytes / ROW_COUNT) + " bytes");
+  } else {
+    cout << GRAY << "  [i] Memory comparison: skipped, needs a "
+         << "BENCHMARK_ALLOCATIONS build" << RESET << endl;
+  }
+  printTestResult("Table scan matches object scan",
+                  table.overlaps == objects.overlaps);
+}
+
+void ScheduleManager::runStringPoolBenchmark() {
+  printTestHeader("STRING POOL BENCHMARK (STRINGS vs SYMBOLS)");
+
+  // What interning saved on the data loaded so far: every interned value
+  // would otherwise be its own std::string
+  StringPool::Stats loaded = StringPool::global().stats();
+  size_t handleBytes = loaded.internCalls * sizeof(Symbol);
+  long long loadedSaved = static_cast<long long>(loaded.copyBytes) -
+                          static_cast<long long>(loaded.poolBytes) -
+                          static_cast<long long>(handleBytes);
+  cout << BRIGHT_WHITE << BOLD << "Pool since startup" << RESET << endl;
+  cout << "  Interned values:  " << BRIGHT_CYAN << loaded.internCalls << RESET
+       << " (" << loaded.uniqueStrings << " distinct)" << endl;
+  cout << "  As strings:       " << BRIGHT_CYAN << loaded.copyBytes << RESET
+       << " bytes" << endl;
+  cout << "  Pool + handles:   " << BRIGHT_CYAN
+       << loaded.poolBytes + handleBytes << RESET << " bytes ("
+       << loaded.poolBytes << " pool, " << handleBytes << " handles)" << endl;
+  cout << "  Saved:            " << BRIGHT_GREEN << loadedSaved << RESET
+       << " bytes" << endl;
+
+  vector<LessonRef> catalogRefs;
+  for (const auto& entry : courseLessons) {
+    catalogRefs.insert(catalogRefs.end(), entry.second.begin(),
+                       entry.second.end());
+  }
+  if (catalogRefs.empty()) {
+    cout << RED << "[ERROR] No lessons loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  const size_t RECORD_COUNT = 100000;  // Conflict records of each kind
+  const size_t SCAN_RECORDS = 2000;    // All pairs of these are compared
+
+  // The four pooled fields of a conflict record, before and after
+  struct StringFields {
+    string day, classroom, building, instructor;
+  };
+  struct SymbolFields {
+    Symbol day, classroom, building, instructor;
+  };
+
+  size_t bytesBefore = heapLiveBytes();
+  vector<StringFields> stringRecords;
+  stringRecords.reserve(RECORD_COUNT);
+  for (size_t i = 0; i < RECORD_COUNT; i++) {
+    LessonRef lesson = catalogRefs[i % catalogRefs.size()];
+    StringFields record = {lessonTable.dayName(lesson),
+                           lessonTable.classroom(lesson),
+                           lessonTable.building(lesson),
+                           lessonTable.teacher(lesson)};
+    stringRecords.push_back(record);
+  }
+  size_t stringBytes = heapLiveBytes() - bytesBefore;
+
+  bytesBefore = heapLiveBytes();
+  vector<SymbolFields> symbolRecords;
+  symbolRecords.reserve(RECORD_COUNT);
+  for (size_t i = 0; i < RECORD_COUNT; i++) {
+    LessonRef lesson = catalogRefs[i % catalogRefs.size()];
+    SymbolFields record = {
+        lessonTable.daySymbol(lesson), lessonTable.classroomSymbol(lesson),
+        lessonTable.buildingSymbol(lesson), lessonTable.teacherSymbol(lesson)};
+    symbolRecords.push_back(record);
+  }
+  size_t symbolBytes = heapLiveBytes() - bytesBefore;
+
+  // Same day and same room, the room-clash test of the conflict analysis
+  size_t scanRecords = min(SCAN_RECORDS, RECORD_COUNT);
+  long long stringClashes = 0;
+  auto start = chrono::steady_clock::now();
+  for (size_t i = 0; i < scanRecords; i++) {
+    for (size_t j = i + 1; j < scanRecords; j++) {
+      if (stringRecords[i].day == stringRecords[j].day &&
+          stringRecords[i].classroom == stringRecords[j].classroom) {
+        stringClashes++;
+      }
+    }
+  }
+  double stringMs = elapsedMs(start);
+
+  long long symbolClashes = 0;
+  start = chrono::steady_clock::now();
+  for (size_t i = 0; i < scanRecords; i++) {
+    for (size_t j = i + 1; j < scanRecords; j++) {
+      if (symbolRecords[i].day == symbolRecords[j].day &&
+          symbolRecords[i].classroom == symbolRecords[j].classroom) {
+        symbolClashes++;
+      }
+    }
+  }
+  double symbolMs = elapsedMs(start);
+
+  cout << "\n"
+       << GRAY << RECORD_COUNT << " records stored, " << scanRecords
+       << " scanned pairwise" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(22) << "Fields" << setw(16)
+       << "Bytes/record" << setw(14) << "Scan (ms)" << "Clashes" << RESET
+       << endl;
+  cout << GRAY << string(62, '-') << RESET << endl;
+  cout << left << fixed << setprecision(1) << BRIGHT_CYAN << setw(22)
+       << "4 x string" << RESET << setw(16)
+       << static_cast<double>(stringBytes) / RECORD_COUNT << setprecision(2)
+       << setw(14) << stringMs << stringClashes << endl;
+  cout << left << fixed << setprecision(1) << BRIGHT_CYAN << setw(22)
+       << "4 x Symbol" << RESET << setw(16)
+       << static_cast<double>(symbolBytes) / RECORD_COUNT << setprecision(2)
+       << setw(14) << symbolMs << symbolClashes << endl;
+  cout << right;
+
+  double saved = stringBytes > symbolBytes
+                     ? 100.0 * (stringBytes - symbolBytes) / stringBytes
+                     : 0.0;
+  double speedup = symbolMs > 0 ? stringMs / symbolMs : 0.0;
+  cout << BRIGHT_GREEN << "\nMemory saved: " << fixed << setprecision(1)
+       << saved << "% | Scan speedup: " << setprecision(2) << speedup << "x"
+       << RESET << endl;
+
+  printTestResult("Interning saves memory on loaded data", loadedSaved > 0,
+                  to_string(loadedSaved) + " bytes");
+  if (heapCountingEnabled()) {
+    printTestResult("Symbol records smaller than string records",
+                    symbolBytes < stringBytes,
+                    to_string(symbolBytes / RECORD_COUNT) + " vs " +
+                        to_string(stringBytes / RECORD_COUNT) + " bytes");
+  } else {
+    cout << GRAY << "  [i] Record size comparison: skipped, needs a "
+         << "BENCHMARK_ALLOCATIONS build" << RESET << endl;
+  }
+  printTestResult("Symbol scan matches string scan",
+                  symbolClashes == stringClashes);
+}
+
+void ScheduleManager::runScheduleStoreBenchmark() {
+  printTestHeader("SCHEDULE STORE BENCHMARK (FILE PER SCHEDULE vs STORE)");
+
+  vector<LessonRef> templateLessons;
+  for (const auto& entry : courseLessons) {
+    templateLessons.insert(templateLessons.end(), entry.second.begin(),
+                           entry.second.end());
+  }
+  if (templateLessons.empty()) {
+    cout << RED << "[ERROR] No lessons loaded to use as a template." << RESET
+         << endl;
+    return;
+  }
+
+  string dir = dataDirectory + "bench_store/";
+  makeDirectory(dir);
+
+  // Previous layout: deleting schedule 1 renames every later file down by
+  // one (the old code also probed a fixed 20 names to find them)
+  const int FILE_COUNT = 1000;
+  for (int id = 1; id <= FILE_COUNT; id++) {
+    ofstream file(dir + "schedule_" + to_string(id) + ".csv");
+    file << ScheduleStore::HEADER << "\n";
+  }
+  auto start = chrono::steady_clock::now();
+  remove((dir + "schedule_1.csv").c_str());
+  for (int id = 2; id <= FILE_COUNT; id++) {
+    rename((dir + "schedule_" + to_string(id) + ".csv").c_str(),
+           (dir + "schedule_" + to_string(id - 1) + ".csv").c_str());
+  }
+  double fileDeleteMs = elapsedMs(start);
+  for (int id = 1; id < FILE_COUNT; id++) {
+    remove((dir + "schedule_" + to_string(id) + ".csv").c_str());
+  }
+
+  struct Result {
+    int count;
+    double createUs;
+    double deleteUs;
+    double flushMs;
+    double reloadMs;
+    int64_t fileBytes;
+    int maxId;
+    bool verified;
+  };
+  vector<Result> results;
+
+  mt19937 random(20240601);
+  for (int count : {1000, 100000, 1000000}) {
+    string path = dir + ScheduleStore::FILE_NAME;
+    remove(path.c_str());
+    Result result = {count, 0, 0, 0, 0, 0, 0, false};
+    vector<int> expected;
+    {
+      PersistenceQueue queue;
+      ScheduleStore store(&queue);
+      store.attach(path, ScheduleStore::Contents());
+
+      // Every tenth schedule gets a lesson, so the log carries rows too
+      start = chrono::steady_clock::now();
+      for (int i = 0; i < count; i++) {
+        int id = store.createSchedule();
+        if (i % 10 == 0) {
+          store.recordAdd(id, lessonTable.view(
+                                  templateLessons[i % templateLessons.size()]));
+        }
+      }
+      double createMs = elapsedMs(start);
+
+      vector<int> victims(count);
+      for (int i = 0; i < count; i++) victims[i] = i + 1;
+      shuffle(victims.begin(), victims.end(), random);
+      victims.resize(count / 2);
+      start = chrono::steady_clock::now();
+      for (int id : victims) store.deleteSchedule(id);
+      double deleteMs = elapsedMs(start);
+
+      // Recreate as many; every one should reuse a freed ID
+      start = chrono::steady_clock::now();
+      for (int i = 0; i < count / 2; i++) {
+        result.maxId = max(result.maxId, store.createSchedule());
+      }
+      createMs += elapsedMs(start);
+
+      result.createUs = createMs * 1000 / (count + count / 2);
+      result.deleteUs = deleteMs * 1000 / victims.size();
+
+      start = chrono::steady_clock::now();
+      queue.flush();
+      result.flushMs = elapsedMs(start);
+
+      for (int id = 1; id <= count; id++) {
+        if (store.contains(id)) expected.push_back(id);
+      }
+    }
+
+    int64_t mtime = 0;
+    CatalogSnapshot::statFile(path, result.fileBytes, mtime);
+    ScheduleStore::Contents contents;
+    start = chrono::steady_clock::now();
+    bool loaded = ScheduleStore::read(path, contents);
+    result.reloadMs = elapsedMs(start);
+    result.verified = loaded && contents.scheduleIds == expected &&
+                      static_cast<int>(expected.size()) == count &&
+                      result.maxId <= count;
+    remove(path.c_str());
+    results.push_back(result);
+  }
+
+  // 10k Add/Rm on one schedule: the old code rewrote the schedule's whole
+  // CSV after each one, the store appends one record
+  const int MUTATIONS = 10000;
+  const size_t TARGET_LESSONS = 20;
+  map<pair<int, string>, LessonRef> byKey;  // One lesson per (course, group)
+  for (LessonRef lesson : templateLessons) {
+    byKey.emplace(make_pair(lessonTable.courseId(lesson),
+                            lessonTable.groupId(lesson)),
+                  lesson);
+  }
+  vector<LessonRef> pool;
+  for (const auto& entry : byKey) pool.push_back(entry.second);
+  struct Mutation {
+    bool add;
+    LessonRef lesson;
+  };
+  vector<Mutation> mutations;
+  {
+    vector<char> held(pool.size(), 0);
+    vector<size_t> members;
+    uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+    while (mutations.size() < MUTATIONS) {
+      bool add = members.size() < TARGET_LESSONS / 2 ||
+                 (members.size() < TARGET_LESSONS && random() % 2 == 0);
+      if (add) {
+        size_t lesson = pick(random);
+        if (held[lesson]) continue;
+        held[lesson] = 1;
+        members.push_back(lesson);
+        mutations.push_back({true, pool[lesson]});
+      } else {
+        size_t slot = random() % members.size();
+        held[members[slot]] = 0;
+        mutations.push_back({false, pool[members[slot]]});
+        members[slot] = members.back();
+        members.pop_back();
+      }
+    }
+  }
+
+  // Before: truncate and rewrite schedule_1.csv after every mutation
+  string rewritePath = dir + "schedule_1.csv";
+  vector<LessonRef> current;
+  size_t rewriteBytes = 0;
+  size_t lastRewriteBytes = 0;
+  start = chrono::steady_clock::now();
+  for (const Mutation& mutation : mutations) {
+    if (mutation.add) {
+      current.push_back(mutation.lesson);
+    } else {
+      current.erase(find(current.begin(), current.end(), mutation.lesson));
+    }
+    ofstream file(rewritePath, ios::trunc);
+    string text = ScheduleStore::HEADER + "\n";
+    for (LessonRef lesson : current) {
+      text += ScheduleStore::formatRow(1, lessonTable.view(lesson)) + "\n";
+    }
+    file << text;
+    rewriteBytes += text.size();
+    lastRewriteBytes = text.size();
+  }
+  double rewriteMs = elapsedMs(start);
+  vector<string> expectedRows;
+  for (LessonRef lesson : current) {
+    expectedRows.push_back(
+        ScheduleStore::formatRow(1, lessonTable.view(lesson)));
+  }
+  sort(expectedRows.begin(), expectedRows.end());
+  vector<string> rewrittenRows;
+  {
+    ifstream file(rewritePath);
+    string line;
+    getline(file, line);  // Header
+    while (getline(file, line)) rewrittenRows.push_back(line);
+  }
+  sort(rewrittenRows.begin(), rewrittenRows.end());
+  remove(rewritePath.c_str());
+
+  // After: one appended record per mutation, written synchronously
+  string logPath = dir + ScheduleStore::FILE_NAME;
+  remove(logPath.c_str());
+  double storeMs = 0;
+  {
+    ScheduleStore store;
+    store.attach(logPath, ScheduleStore::Contents());
+    int id = store.createSchedule();
+    start = chrono::steady_clock::now();
+    for (const Mutation& mutation : mutations) {
+      if (mutation.add) {
+        store.recordAdd(id, lessonTable.view(mutation.lesson));
+      } else {
+        store.recordRemove(id, lessonTable.courseId(mutation.lesson),
+                           lessonTable.groupId(mutation.lesson));
+      }
+    }
+    storeMs = elapsedMs(start);
+  }
+  int64_t logBytes = 0;
+  int64_t logTime = 0;
+  CatalogSnapshot::statFile(logPath, logBytes, logTime);
+  ScheduleStore::Contents replayed;
+  vector<string> replayedRows;
+  if (ScheduleStore::read(logPath, replayed) &&
+      replayed.scheduleLessons.size() == 1) {
+    for (LessonRef lesson : replayed.scheduleLessons[0]) {
+      replayedRows.push_back(ScheduleStore::formatRow(
+          replayed.scheduleIds[0], replayed.lessons.view(lesson)));
+    }
+  }
+  sort(replayedRows.begin(), replayedRows.end());
+  remove(logPath.c_str());
+  removeDirectory(dir);
+
+  cout << GRAY << "File per schedule: deleting schedule 1 of " << FILE_COUNT
+       << " renamed " << (FILE_COUNT - 1) << " files in " << fixed
+       << setprecision(2) << fileDeleteMs << " ms" << RESET << endl;
+  cout << GRAY << "Store: create N, delete N/2 at random, create N/2 again"
+       << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(12) << "Schedules" << setw(14)
+       << "Create (us)" << setw(14) << "Delete (us)" << setw(13)
+       << "Flush (ms)" << setw(14) << "Reload (ms)" << "File (KB)" << RESET
+       << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  for (const Result& result : results) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(12)
+         << result.count << RESET << setw(14) << result.createUs << setw(14)
+         << result.deleteUs << setw(13) << result.flushMs << setw(14)
+         << result.reloadMs << (result.fileBytes / 1024) << endl;
+    printTestResult("Free IDs reused, reload matches at " +
+                        to_string(result.count),
+                    result.verified);
+  }
+  cout << right;
+
+  double fileDeleteUs = fileDeleteMs * 1000;
+  printTestResult("Store delete faster than renumbering files",
+                  results.back().deleteUs < fileDeleteUs,
+                  to_string(static_cast<int>(fileDeleteUs /
+                                             max(results.back().deleteUs,
+                                                 0.001))) +
+                      "x");
+
+  cout << "\n"
+       << GRAY << MUTATIONS << " Add/Rm mutations on one schedule of up to "
+       << TARGET_LESSONS << " lessons, written synchronously" << RESET
+       << endl;
+  cout << BRIGHT_WHITE << BOLD << left << setw(26) << "Persistence" << setw(14)
+       << "Time (ms)" << setw(16) << "us/mutation" << "Final file (KB)"
+       << RESET << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(26)
+       << "Rewrite schedule CSV" << RESET << setw(14) << rewriteMs << setw(16)
+       << rewriteMs * 1000 / MUTATIONS << lastRewriteBytes / 1024.0
+       << endl;
+  cout << BRIGHT_CYAN << setw(26) << "Append store record" << RESET
+       << setw(14) << storeMs << setw(16) << storeMs * 1000 / MUTATIONS
+       << logBytes / 1024.0 << endl;
+  cout << right;
+  cout << GRAY << "Rewriting wrote " << rewriteBytes / 1024 << " KB in total"
+       << RESET << endl;
+
+  printTestResult("Replayed store matches the rewritten CSV",
+                  replayedRows == expectedRows &&
+                      rewrittenRows == expectedRows);
+  printTestResult("Appending beats rewriting under 10k mutations",
+                  storeMs < rewriteMs,
+                  to_string(rewriteMs / max(storeMs, 1e-9)) + "x");
+}
+
+void ScheduleManager::runPersistenceBenchmark() {
+  printTestHeader("GROUP COMMIT BENCHMARK (SYNCHRONOUS vs FLUSHER THREAD)");
+
+  vector<LessonRef> candidates;
+  set<pair<int, uint16_t>> keys;
+  for (const auto& entry : courseLessons) {
+    for (LessonRef lesson : entry.second) {
+      if (keys.insert(make_pair(lessonTable.courseId(lesson),
+                                lessonTable.groupCode(lesson)))
+              .second) {
+        candidates.push_back(lesson);
+      }
+    }
+  }
+  if (candidates.size() < 2) {
+    cout << RED << "[ERROR] Not enough lessons loaded to mutate." << RESET
+         << endl;
+    return;
+  }
+
+  // An interactive session: every command records an Add or Rm, and every
+  // tenth one also creates a schedule, as AddSchedule does
+  const int COMMANDS = 2000;
+  const int CREATE_EVERY = 10;
+
+  string dir = dataDirectory + "bench_persistence/";
+  makeDirectory(dir);
+
+  struct Result {
+    vector<double> latencies;  // Per command, in ms
+    double flushMs;
+  };
+
+  // Runs the session; `queue` null means every write finishes in the call
+  auto runSession = [&](PersistenceQueue* queue, const string& path) {
+    remove(path.c_str());
+    ScheduleStore store(queue);
+    store.attach(path, ScheduleStore::Contents());
+    int scheduleId = store.createSchedule();
+    Result result;
+    result.latencies.reserve(COMMANDS);
+    for (int command = 0; command < COMMANDS; command++) {
+      LessonView lesson =
+          lessonTable.view(candidates[(command / 2) % candidates.size()]);
+      auto start = chrono::steady_clock::now();
+      if (command % 2 == 0) {
+        store.recordAdd(scheduleId, lesson);
+      } else {
+        store.recordRemove(scheduleId, lesson.getCourseId(),
+                           lesson.getGroupId());
+      }
+      if (command % CREATE_EVERY == 0) store.createSchedule();
+      result.latencies.push_back(elapsedMs(start));
+    }
+    auto start = chrono::steady_clock::now();
+    if (queue) queue->flush();
+    result.flushMs = elapsedMs(start);
+    return result;
+  };
+
+  auto readFile = [](const string& path) {
+    ifstream file(path);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+  };
+
+  string directPath = dir + "direct_store.csv";
+  string queuedPath = dir + "queued_store.csv";
+  Result direct = runSession(nullptr, directPath);
+  PersistenceQueue queue;
+  Result queued = runSession(&queue, queuedPath);
+  PersistenceQueue::Stats stats = queue.stats();
+
+  ScheduleStore::compact(directPath);
+  ScheduleStore::compact(queuedPath);
+  bool sameFiles = readFile(directPath) == readFile(queuedPath);
+  remove(directPath.c_str());
+  remove(queuedPath.c_str());
+  removeDirectory(dir);
+
+  auto summarize = [](vector<double> latencies, double& mean, double& p99,
+                      double& worst) {
+    sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (double latency : latencies) total += latency;
+    mean = total / latencies.size();
+    p99 = latencies[latencies.size() * 99 / 100];
+    worst = latencies.back();
+  };
+  double directMean, directP99, directWorst;
+  double queuedMean, queuedP99, queuedWorst;
+  summarize(direct.latencies, directMean, directP99, directWorst);
+  summarize(queued.latencies, queuedMean, queuedP99, queuedWorst);
+
+  cout << GRAY << COMMANDS << " commands, a new schedule every "
+       << CREATE_EVERY << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(14) << "Writes" << setw(14)
+       << "Mean (us)" << setw(14) << "p99 (us)" << setw(14) << "Max (us)"
+       << "Flush (ms)" << RESET << endl;
+  cout << GRAY << string(66, '-') << RESET << endl;
+  cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(14)
+       << "Synchronous" << RESET << setw(14) << directMean * 1000 << setw(14)
+       << directP99 * 1000 << setw(14) << directWorst * 1000 << "-" << endl;
+  cout << left << BRIGHT_CYAN << setw(14) << "Group commit" << RESET
+       << setw(14) << queuedMean * 1000 << setw(14) << queuedP99 * 1000
+       << setw(14) << queuedWorst * 1000 << queued.flushMs << endl;
+  cout << right;
+  cout << GRAY << stats.requests << " requests written as " << stats.fileWrites
+       << " file operations in " << stats.batches << " batches" << RESET
+       << endl;
+
+  double speedup = queuedMean > 0 ? directMean / queuedMean : 0.0;
+  cout << BRIGHT_GREEN << "\nCommand latency: " << fixed << setprecision(2)
+       << speedup << "x lower" << RESET << endl;
+
+  printTestResult("Group commit leaves the same files", sameFiles);
+  printTestResult("No failed writes", stats.failedWrites == 0);
+  printTestResult("Commands no longer wait on disk", queuedMean < directMean,
+                  to_string(static_cast<int>(speedup)) + "x");
+}
+
+void ScheduleManager::runScheduleIndexBenchmark() {
+  printTestHeader("SCHEDULE LOOKUP BENCHMARK (FIND_IF vs SCHEDULE INDEX)");
+
+  struct Result {
+    int count;
+    double linearNs;
+    double indexNs;
+    size_t indexBytes;
+    bool verified;
+  };
+  vector<Result> results;
+
+  const int INDEX_LOOKUPS = 1000000;
+  mt19937 random(20240615);
+  for (int count : {1000, 100000, 1000000}) {
+    Result result = {count, 0, 0, 0, true};
+
+    // Create every schedule, then delete and recreate a tenth of them the
+    // way removeSchedule does, so positions no longer follow IDs
+    vector<Schedule> table;
+    ScheduleIndex index;
+    for (int id = 1; id <= count; id++) {
+      table.emplace_back(id);
+      index.set(id, table.size() - 1);
+    }
+    vector<int> victims(count);
+    for (int i = 0; i < count; i++) victims[i] = i + 1;
+    shuffle(victims.begin(), victims.end(), random);
+    victims.resize(count / 10);
+    for (int id : victims) {
+      size_t slot = index.find(id);
+      if (slot != table.size() - 1) {
+        table[slot] = move(table.back());
+        index.set(table[slot].getScheduleId(), slot);
+      }
+      table.pop_back();
+      index.erase(id);
+    }
+    for (int id : victims) {
+      table.emplace_back(id);
+      index.set(id, table.size() - 1);
+    }
+    for (size_t slot = 0; slot < table.size(); slot++) {
+      if (index.find(table[slot].getScheduleId()) != slot) {
+        result.verified = false;
+      }
+    }
+    result.verified = result.verified && index.size() == table.size();
+    result.indexBytes = index.memoryBytes();
+
+    // A linear scan costs count / 2 per hit, so it gets fewer lookups
+    int linearLookups = max(20, 50000000 / count);
+    uniform_int_distribution<int> pickId(1, count + count / 100);
+    vector<int> lookups(INDEX_LOOKUPS);
+    for (int& id : lookups) id = pickId(random);  // ~1% misses
+
+    long long linearSum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < linearLookups; i++) {
+      int scheduleId = lookups[i];
+      auto it = find_if(table.begin(), table.end(),
+                        [scheduleId](const Schedule& schedule) {
+                          return schedule.getScheduleId() == scheduleId;
+                        });
+      if (it != table.end()) linearSum += it - table.begin();
+    }
+    result.linearNs = elapsedMs(start) * 1e6 / linearLookups;
+
+    long long indexSum = 0;
+    long long indexPrefixSum = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < INDEX_LOOKUPS; i++) {
+      size_t slot = index.find(lookups[i]);
+      if (slot != ScheduleIndex::NOT_FOUND) {
+        indexSum += static_cast<long long>(slot);
+      }
+      if (i + 1 == linearLookups) indexPrefixSum = indexSum;
+    }
+    result.indexNs = elapsedMs(start) * 1e6 / INDEX_LOOKUPS;
+    result.verified = result.verified && indexPrefixSum == linearSum;
+
+    results.push_back(result);
+  }
+
+  cout << GRAY << "Lookups of random IDs (~1% missing) after deleting and "
+       << "recreating a tenth of the schedules" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(12) << "Schedules" << setw(16)
+       << "find_if (ns)" << setw(14) << "Index (ns)" << setw(12) << "Speedup"
+       << "Index (KB)" << RESET << endl;
+  cout << GRAY << string(64, '-') << RESET << endl;
+  for (const Result& result : results) {
+    double speedup = result.linearNs / max(result.indexNs, 0.001);
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(12)
+         << result.count << RESET << setw(16) << result.linearNs << setw(14)
+         << result.indexNs << setw(12) << speedup
+         << (result.indexBytes / 1024) << endl;
+    printTestResult("Index agrees with find_if at " + to_string(result.count),
+                    result.verified);
+  }
+  cout << right;
+
+  const Result& largest = results.back();
+  printTestResult("Index lookup faster than find_if",
+                  largest.indexNs < largest.linearNs,
+                  to_string(static_cast<int>(largest.linearNs /
+                                             max(largest.indexNs, 0.001))) +
+                      "x at " + to_string(largest.count));
+
+  // Removing 10:03-11:00 must leave the 10:00-10:05 slot that 09:00-10:02
+  // still covers, or the occupancy fast path misses the 10:00 overlap
+  LessonTable boundary;
+  LessonRef early = boundary.add(1, LessonTable::LECTURE, "Sunday", "09:00",
+                                 62, "R1", "B1", "T1", "L1");
+  LessonRef late = boundary.add(2, LessonTable::LECTURE, "Sunday", "10:03",
+                                57, "R1", "B1", "T1", "L2");
+  LessonRef probe = boundary.add(3, LessonTable::LECTURE, "Sunday", "10:00",
+                                 1, "R1", "B1", "T1", "L3");
+  Schedule::setLessonTable(&boundary);
+  bool slotKept = false;
+  {
+    Schedule schedule(1);
+    schedule.addLesson(early);
+    schedule.addLesson(late);
+    schedule.removeLesson(2, "L2");
+    slotKept = schedule.hasConflict(probe);
+  }
+  Schedule::setLessonTable(&lessonTable);
+  printTestResult("Removal keeps slots a remaining lesson shares", slotKept);
+}
+
+void ScheduleManager::runCompatibilityBenchmark() {
+  printTestHeader("SECTION COMPATIBILITY BENCHMARK (TIME STRINGS vs BITS)");
+
+  if (compatibility.size() == 0) {
+    cout << RED << "[ERROR] No catalog sections loaded to use as a template."
+         << RESET << endl;
+    return;
+  }
+
+  struct Result {
+    size_t sections;
+    double buildMs;
+    size_t bytes;
+    double stringNs;
+    double bitNs;
+    bool verified;
+  };
+  vector<Result> results;
+
+  const int STRING_QUERIES = 200000;
+  const int BIT_QUERIES = 2000000;
+  mt19937 random(20240701);
+  size_t catalogRows = compatibility.size();
+  for (int scale : {1, 10, 50}) {
+    // The catalog's sections repeated, as a larger faculty would list them
+    LessonTable table;
+    table.reserve(catalogRows * scale);
+    for (int copy = 0; copy < scale; copy++) {
+      for (LessonRef lesson = 0; lesson < catalogRows; lesson++) {
+        table.copyRow(lessonTable, lesson);
+      }
+    }
+
+    Result result = {table.size(), 0, 0, 0, 0, true};
+    SectionCompatibility matrix;
+    auto start = chrono::steady_clock::now();
+    matrix.build(table);
+    result.buildMs = elapsedMs(start);
+    result.bytes = matrix.memoryBytes();
+
+    uniform_int_distribution<LessonRef> pick(
+        0, static_cast<LessonRef>(table.size() - 1));
+    vector<pair<LessonRef, LessonRef>> queries(BIT_QUERIES);
+    for (auto& query : queries) query = {pick(random), pick(random)};
+
+    // What the optimizer did per check: compare day names, parse "HH:MM"
+    vector<bool> stringAnswers(STRING_QUERIES);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < STRING_QUERIES; i++) {
+      LessonView a = table.view(queries[i].first);
+      LessonView b = table.view(queries[i].second);
+      bool clash = false;
+      if (queries[i].first != queries[i].second && a.getDay() == b.getDay()) {
+        string startA = a.getStartTime();
+        string startB = b.getStartTime();
+        int beginA = stoi(startA.substr(0, 2)) * 60 + stoi(startA.substr(3));
+        int beginB = stoi(startB.substr(0, 2)) * 60 + stoi(startB.substr(3));
+        clash = beginA < beginB + b.getDuration() &&
+                beginB < beginA + a.getDuration();
+      }
+      stringAnswers[i] = clash;
+    }
+    result.stringNs = elapsedMs(start) * 1e6 / STRING_QUERIES;
+
+    long long clashes = 0;
+    long long prefixClashes = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < BIT_QUERIES; i++) {
+      if (matrix.clash(queries[i].first, queries[i].second)) clashes++;
+      if (i + 1 == STRING_QUERIES) prefixClashes = clashes;
+    }
+    result.bitNs = elapsedMs(start) * 1e6 / BIT_QUERIES;
+
+    long long stringClashes = 0;
+    for (int i = 0; i < STRING_QUERIES; i++) {
+      if (stringAnswers[i]) stringClashes++;
+      if (stringAnswers[i] !=
+          matrix.clash(queries[i].first, queries[i].second)) {
+        result.verified = false;
+      }
+    }
+    result.verified = result.verified && stringClashes == prefixClashes;
+    results.push_back(result);
+  }
+
+  cout << GRAY << "Random section pairs; the string check compares day names "
+       << "and parses start times" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(11) << "Sections" << setw(12)
+       << "Build (ms)" << setw(13) << "Matrix (KB)" << setw(14)
+       << "Strings (ns)" << setw(11) << "Bits (ns)" << "Speedup" << RESET
+       << endl;
+  cout << GRAY << string(68, '-') << RESET << endl;
+  for (const Result& result : results) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(11)
+         << result.sections << RESET << setw(12) << result.buildMs << setw(13)
+         << (result.bytes / 1024) << setw(14) << result.stringNs << setw(11)
+         << result.bitNs << (result.stringNs / max(result.bitNs, 0.001))
+         << "x" << endl;
+    printTestResult(
+        "Matrix agrees with time comparison at " + to_string(result.sections),
+        result.verified);
+  }
+  cout << right;
+
+  const Result& largest = results.back();
+  printTestResult("Bit test faster than string comparison",
+                  largest.bitNs < largest.stringNs,
+                  to_string(static_cast<int>(largest.stringNs /
+                                             max(largest.bitNs, 0.001))) +
+                      "x at " + to_string(largest.sections));
+  printTestResult("Matrix is n^2 bits",
+                  largest.bytes >= largest.sections * largest.sections / 8 &&
+                      largest.bytes <=
+                          largest.sections * (largest.sections + 64) / 8,
+                  to_string(largest.bytes / (1024 * 1024)) + " MB");
+}
+
+void ScheduleManager::runSectionSolverBenchmark() {
+  printTestHeader("SECTION SOLVER BENCHMARK (FIRST FIT vs EXACT SEARCH)");
+
+  vector<int> courseIds;
+  for (const Course& course : courses) {
+    if (!lessonIndex.groups(course.getCourseId(), LessonTable::LECTURE)
+             .empty() ||
+        !lessonIndex.groups(course.getCourseId(), LessonTable::TUTORIAL)
+             .empty() ||
+        !lessonIndex.groups(course.getCourseId(), LessonTable::LAB).empty()) {
+      courseIds.push_back(course.getCourseId());
+    }
+  }
+  if (courseIds.size() < 8) {
+    cout << RED << "[ERROR] Need at least 8 courses with lessons." << RESET
+         << endl;
+    return;
+  }
+
+  struct Result {
+    int courses;
+    int loads;
+    int firstFitFound;
+    int solverFound;
+    double solverUs;
+    double maxSolverUs;
+    size_t nodes;
+    bool verified;
+  };
+  vector<Result> results;
+
+  const int LOADS = 2000;  // Random course loads per size
+  mt19937 random(20240708);
+  SectionSolver solver(lessonIndex, compatibility);
+  for (int courseCount = 5; courseCount <= 8; courseCount++) {
+    Result result = {courseCount, LOADS, 0, 0, 0, 0, 0, true};
+    for (int load = 0; load < LOADS; load++) {
+      shuffle(courseIds.begin(), courseIds.end(), random);
+      vector<int> picked(courseIds.begin(), courseIds.begin() + courseCount);
+      vector<vector<LessonRef>> types = lessonTypeGroups(lessonIndex, picked);
+
+      // What the optimizer did: take the first group that fits, never undo
+      vector<LessonRef> chosen;
+      for (const vector<LessonRef>& groups : types) {
+        for (LessonRef group : groups) {
+          bool fits = true;
+          for (LessonRef other : chosen) {
+            if (compatibility.clash(group, other)) fits = false;
+          }
+          if (fits) {
+            chosen.push_back(group);
+            break;
+          }
+        }
+      }
+      bool firstFit = chosen.size() == types.size();
+
+      vector<LessonRef> assignment;
+      auto start = chrono::steady_clock::now();
+      bool solved = solver.solve(picked, assignment);
+      double us = elapsedMs(start) * 1000;
+      result.solverUs += us;
+      result.maxSolverUs = max(result.maxSolverUs, us);
+      result.nodes += solver.nodesVisited();
+
+      // Check the answer: no overlap in a solution, and no solution missed
+      chosen.clear();
+      bool exists = backtrackGroups(compatibility, types, chosen);
+      if (solved != exists || (firstFit && !solved)) result.verified = false;
+      if (solved) {
+        if (assignment.size() != types.size()) result.verified = false;
+        for (size_t i = 0; i < assignment.size(); i++) {
+          for (size_t j = i + 1; j < assignment.size(); j++) {
+            if (compatibility.clash(assignment[i], assignment[j])) {
+              result.verified = false;
+            }
+          }
+        }
+      }
+      if (firstFit) result.firstFitFound++;
+      if (solved) result.solverFound++;
+    }
+    result.solverUs /= LOADS;
+    results.push_back(result);
+  }
+
+  cout << GRAY << LOADS << " random course loads per size from "
+       << courseIds.size() << " courses" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(9) << "Courses" << setw(12)
+       << "First fit" << setw(10) << "Solver" << setw(12) << "Avg (us)"
+       << setw(12) << "Max (us)" << "Groups tried" << RESET << endl;
+  cout << GRAY << string(67, '-') << RESET << endl;
+  for (const Result& result : results) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(9)
+         << result.courses << RESET << setw(12) << result.firstFitFound
+         << setw(10) << result.solverFound << setw(12) << result.solverUs
+         << setw(12) << result.maxSolverUs
+         << (static_cast<double>(result.nodes) / result.loads) << endl;
+    printTestResult("Solver agrees with exhaustive search at " +
+                        to_string(result.courses) + " courses",
+                    result.verified);
+  }
+  cout << right;
+
+  int firstFitTotal = 0, solverTotal = 0;
+  double worstAverage = 0;
+  for (const Result& result : results) {
+    firstFitTotal += result.firstFitFound;
+    solverTotal += result.solverFound;
+    worstAverage = max(worstAverage, result.solverUs);
+  }
+  printTestResult("Solver schedules every load first fit does",
+                  solverTotal >= firstFitTotal,
+                  to_string(solverTotal - firstFitTotal) +
+                      " more loads scheduled");
+  printTestResult("Average solve under 100 us", worstAverage < 100,
+                  to_string(static_cast<int>(worstAverage)) + " us worst");
+}
+
+void ScheduleManager::runOptimizerBenchmark() {
+  printTestHeader("OPTIMIZER CANDIDATE BENCHMARK (LESSON FILES vs IN MEMORY)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  // The optimizer tests up to 500 sampled combinations of 2-6 courses
+  const int CANDIDATES = 500;
+  mt19937 random(20240715);
+  vector<vector<int>> candidates;
+  vector<int> courseIds;
+  for (const Course& course : courses) {
+    courseIds.push_back(course.getCourseId());
+  }
+  uniform_int_distribution<int> pickCount(2, 6);
+  for (int i = 0; i < CANDIDATES; i++) {
+    shuffle(courseIds.begin(), courseIds.end(), random);
+    candidates.emplace_back(courseIds.begin(),
+                            courseIds.begin() + pickCount(random));
+  }
+
+  // Before: every candidate re-reads its courses' lesson files
+  int filesOpened = 0;
+  int fileFound = 0;
+  auto start = chrono::steady_clock::now();
+  for (const vector<int>& candidate : candidates) {
+    if (firstFitFromFiles(dataDirectory, candidate, filesOpened)) fileFound++;
+  }
+  double fileMs = elapsedMs(start);
+
+  // After: the exact solver on the lesson index and compatibility matrix,
+  // repeated so the clock sees more than a few microseconds
+  const int ROUNDS = 20;
+  SectionSolver solver(lessonIndex, compatibility);
+  vector<LessonRef> assignment;
+  int memoryFound = 0;
+  start = chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++) {
+    memoryFound = 0;
+    for (const vector<int>& candidate : candidates) {
+      if (solver.solve(candidate, assignment)) memoryFound++;
+    }
+  }
+  double memoryMs = elapsedMs(start) / ROUNDS;
+
+  double fileRate = CANDIDATES / max(fileMs / 1000, 1e-9);
+  double memoryRate = CANDIDATES / max(memoryMs / 1000, 1e-9);
+  cout << GRAY << CANDIDATES << " random combinations of 2-6 courses" << RESET
+       << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(24) << "Candidate test"
+       << setw(14) << "Time (ms)" << setw(16) << "Candidates/s"
+       << setw(12) << "Files read" << "Schedulable" << RESET << endl;
+  cout << GRAY << string(77, '-') << RESET << endl;
+  cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(24)
+       << "Lesson files, first fit" << RESET << setw(14) << fileMs << setw(16)
+       << setprecision(0) << fileRate << setw(12) << filesOpened << fileFound
+       << endl;
+  cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(24)
+       << "In memory, exact" << RESET << setw(14) << memoryMs << setw(16)
+       << setprecision(0) << memoryRate << setw(12) << 0 << memoryFound
+       << endl;
+  cout << right;
+
+  printTestResult("In-memory test reads no files", true,
+                  to_string(filesOpened) + " file opens avoided");
+  printTestResult("In memory at least 10x the candidates/sec",
+                  memoryRate >= 10 * fileRate,
+                  to_string(static_cast<int>(memoryRate / fileRate)) + "x");
+  printTestResult("Exact test schedules every combination first fit does",
+                  memoryFound >= fileFound);
+}
+
+void ScheduleManager::runCandidateSearchBenchmark() {
+  printTestHeader("PARALLEL CANDIDATE SEARCH BENCHMARK (1 THREAD vs POOL)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  // Enough 2-6 course combinations to keep every thread busy for a while
+  const int CANDIDATES = 20000;
+  mt19937 random(20240715);
+  vector<vector<int>> candidates;
+  vector<int> courseIds;
+  for (const Course& course : courses) {
+    courseIds.push_back(course.getCourseId());
+  }
+  uniform_int_distribution<int> pickCount(2, 6);
+  for (int i = 0; i < CANDIDATES; i++) {
+    shuffle(courseIds.begin(), courseIds.end(), random);
+    candidates.emplace_back(courseIds.begin(),
+                            courseIds.begin() + pickCount(random));
+  }
+
+  // Unschedulable candidates up front, so findFirst has to work for it
+  vector<vector<int>> firstSearch;
+  {
+    WorkerPool single(1);
+    CandidateSearch search(lessonIndex, compatibility, single);
+    vector<char> schedulable;
+    search.solveAll(candidates, schedulable);
+    for (int i = 0; i < CANDIDATES; i++) {
+      if (!schedulable[i]) firstSearch.push_back(candidates[i]);
+    }
+    for (int i = 0; i < CANDIDATES; i++) {
+      if (schedulable[i]) firstSearch.push_back(candidates[i]);
+    }
+  }
+
+  struct Result {
+    size_t threads;
+    double solveAllMs;
+    size_t schedulableCount;
+    vector<char> schedulable;
+    size_t nodes;
+    double findFirstMs;
+    size_t found;
+    vector<LessonRef> assignment;
+  };
+  vector<Result> results;
+
+  set<size_t> threadCounts = {1, 2, 4, loadPool.size()};
+  for (size_t threads : threadCounts) {
+    WorkerPool pool(threads);
+    CandidateSearch search(lessonIndex, compatibility, pool);
+    Result result;
+    result.threads = threads;
+
+    auto start = chrono::steady_clock::now();
+    search.solveAll(candidates, result.schedulable);
+    result.solveAllMs = elapsedMs(start);
+    result.nodes = search.nodesVisited();
+    result.schedulableCount =
+        count(result.schedulable.begin(), result.schedulable.end(), 1);
+
+    start = chrono::steady_clock::now();
+    result.found = search.findFirst(firstSearch, result.assignment);
+    result.findFirstMs = elapsedMs(start);
+    results.push_back(result);
+  }
+
+  cout << GRAY << CANDIDATES << " random combinations of 2-6 courses, "
+       << loadPool.size() << " hardware threads" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(10) << "Threads" << setw(16)
+       << "Solve all (ms)" << setw(16) << "Candidates/s" << setw(10)
+       << "Speedup" << setw(18) << "First found (ms)" << "Schedulable"
+       << RESET << endl;
+  cout << GRAY << string(81, '-') << RESET << endl;
+  bool identical = true;
+  for (const Result& result : results) {
+    double rate = CANDIDATES / max(result.solveAllMs / 1000, 1e-9);
+    double speedup = results[0].solveAllMs / max(result.solveAllMs, 1e-9);
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(10)
+         << result.threads << RESET << setw(16) << result.solveAllMs
+         << setw(16) << setprecision(0) << rate << setprecision(2)
+         << setw(10) << speedup << setw(18) << result.findFirstMs
+         << result.schedulableCount << endl;
+    identical = identical && result.schedulable == results[0].schedulable &&
+                result.nodes == results[0].nodes &&
+                result.found == results[0].found &&
+                result.assignment == results[0].assignment;
+  }
+  cout << right;
+
+  printTestResult("Every thread count gives the same answers", identical,
+                  to_string(results[0].nodes) + " groups tried each");
+  printTestResult("findFirst returns the first schedulable candidate",
+                  results[0].found == CANDIDATES - results[0].schedulableCount,
+                  "position " + to_string(results[0].found));
+}
+
+void ScheduleManager::runCreditSubsetBenchmark() {
+  printTestHeader("CREDIT TARGET BENCHMARK (RANDOM SHUFFLES vs SUBSET DP)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  vector<double> credits;
+  for (const Course& course : courses) credits.push_back(course.getCredits());
+  const double TOLERANCE = 1.0;
+  mt19937 random(20240715);
+
+  cout << GRAY << courses.size() << " courses, sets of 2-6 courses, +/-"
+       << TOLERANCE << " credits" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(8) << "Target" << setw(12)
+       << "In range" << setw(12) << "Checked" << setw(16) << "Shuffle found"
+       << setw(14) << "Shuffle (ms)" << setw(12) << "DP found" << "DP (ms)"
+       << RESET << endl;
+  cout << GRAY << string(81, '-') << RESET << endl;
+
+  bool countsMatch = true;
+  bool setsValid = true;
+  bool dpCovers = true;
+  int shuffleMisses = 0;
+  for (double target = 6; target <= 24; target += 3) {
+    // Exact count: every set of 2-6 courses, checked one by one
+    long long checked = 0;
+    long long inRange = 0;
+    vector<int> chosen;
+    function<void(size_t, double)> visit = [&](size_t next, double sum) {
+      if (chosen.size() >= 2) {
+        checked++;
+        if (fabs(sum - target) <= TOLERANCE + 1e-9) inRange++;
+      }
+      if (chosen.size() == 6) return;
+      for (size_t course = next; course < credits.size(); course++) {
+        chosen.push_back(static_cast<int>(course));
+        visit(course + 1, sum + credits[course]);
+        chosen.pop_back();
+      }
+    };
+    visit(0, 0);
+
+    // Before: the optimizer's old partial shuffles, 500 hits per size
+    auto start = chrono::steady_clock::now();
+    set<vector<int>> shuffleFound;
+    vector<int> order(credits.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+    int courseCount = static_cast<int>(credits.size());
+    for (int size = 2; size <= 6; size++) {
+      int hits = 0;
+      for (int sample = 0; sample < min(5000, courseCount * 100) && hits < 500;
+           sample++) {
+        double sum = 0;
+        for (int i = 0; i < size; i++) {
+          swap(order[i], order[uniform_int_distribution<int>(
+                                    i, courseCount - 1)(random)]);
+          sum += credits[order[i]];
+        }
+        if (fabs(sum - target) <= TOLERANCE + 1e-9) {
+          vector<int> found(order.begin(), order.begin() + size);
+          sort(found.begin(), found.end());
+          shuffleFound.insert(found);
+          hits++;
+        }
+      }
+    }
+    double shuffleMs = elapsedMs(start);
+
+    // After: count with the DP, then list or sample up to 500
+    start = chrono::steady_clock::now();
+    CreditSubsets subsets(credits, target, TOLERANCE, 2, 6);
+    set<vector<int>> dpFound;
+    if (subsets.count() <= 500) {
+      vector<vector<int>> sets;
+      subsets.enumerate(sets, 500);
+      dpFound.insert(sets.begin(), sets.end());
+    } else {
+      for (int draw = 0; draw < 10000 && dpFound.size() < 500; draw++) {
+        dpFound.insert(subsets.sample(random));
+      }
+    }
+    double dpMs = elapsedMs(start);
+
+    for (const vector<int>& found : dpFound) {
+      double sum = 0;
+      for (int course : found) sum += credits[course];
+      setsValid = setsValid && found.size() >= 2 && found.size() <= 6 &&
+                  fabs(sum - target) <= TOLERANCE + 1e-9;
+    }
+    countsMatch = countsMatch && subsets.count() == inRange;
+    size_t expected = static_cast<size_t>(min<long long>(inRange, 500));
+    dpCovers = dpCovers && dpFound.size() == expected;
+    if (shuffleFound.size() < expected) shuffleMisses++;
+
+    cout << left << fixed << setprecision(0) << BRIGHT_CYAN << setw(8)
+         << target << RESET << setw(12) << inRange << setw(12) << checked
+         << setw(16) << shuffleFound.size() << setprecision(2) << setw(14)
+         << shuffleMs << setw(12) << dpFound.size() << dpMs << endl;
+  }
+  cout << right;
+
+  printTestResult("DP count matches checking every set", countsMatch);
+  printTestResult("Every DP set is in the credit window", setsValid);
+  printTestResult("DP finds min(in range, 500) distinct sets every time",
+                  dpCovers,
+                  "shuffles fell short for " + to_string(shuffleMisses) +
+                      " targets");
+}
+
+void ScheduleManager::runAnytimeSearchBenchmark() {
+  printTestHeader("ANYTIME OPTIMIZER BENCHMARK (BUDGETS AND CANCELLATION)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  // A large uniform sample of 15 +/- 1 credit loads, far more than the
+  // optimizer's 500, so the full search takes well past the short budgets
+  const double TARGET = 15;
+  const size_t CANDIDATES = 20000;
+  vector<double> credits;
+  for (const Course& course : courses) credits.push_back(course.getCredits());
+  CreditSubsets subsets(credits, TARGET, 1.0, 2, 6);
+  mt19937 random(20240715);
+  set<vector<int>> seen;
+  vector<vector<int>> candidates;
+  vector<double> candidateCredits;
+  for (size_t draw = 0; draw < 5 * CANDIDATES && candidates.size() < CANDIDATES;
+       draw++) {
+    vector<int> drawn = subsets.sample(random);
+    if (!seen.insert(drawn).second) continue;
+    double total = 0;
+    vector<int> courseIds;
+    for (int course : drawn) {
+      total += credits[course];
+      courseIds.push_back(courses[course].getCourseId());
+    }
+    candidates.push_back(courseIds);
+    candidateCredits.push_back(total);
+  }
+
+  ScheduleQuality quality(lessonTable, TARGET);
+  CandidateSearch::ScoreFunction score =
+      [&](size_t candidate, const vector<LessonRef>& lessons) {
+        return quality.score(lessons, candidateCredits[candidate]);
+      };
+
+  struct Run {
+    string name;
+    double budgetMs;
+    size_t threads;
+    bool cancelLater;
+    size_t solved = 0;
+    size_t found = CandidateSearch::NOT_FOUND;
+    double bestScore = 0;
+    vector<double> published{};  // Each new best's score, in order
+    double firstMs = -1;
+    double stoppedMs = 0;
+  };
+  vector<Run> runs = {{"Full search", 0, 1, false},
+                      {"Full search", 0, loadPool.size(), false},
+                      {"50 ms budget", 50, loadPool.size(), false},
+                      {"5 ms budget", 5, loadPool.size(), false},
+                      {"Cancel at 10 ms", 0, loadPool.size(), true}};
+
+  for (Run& run : runs) {
+    WorkerPool pool(run.threads);
+    CandidateSearch search(lessonIndex, compatibility, pool);
+    CancellationToken token;
+    CandidateSearch::ImprovementFunction improved =
+        [&](size_t, double value, const vector<LessonRef>&, double elapsed) {
+          if (run.published.empty()) run.firstMs = elapsed;
+          run.published.push_back(value);
+        };
+
+    // The front end's side: it cancels from its own thread
+    thread canceller;
+    SearchBudget budget(run.budgetMs, run.cancelLater ? &token : nullptr);
+    if (run.cancelLater) {
+      canceller = thread([&token]() {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        token.cancel();
+      });
+    }
+    vector<LessonRef> assignment;
+    run.found = search.findBest(candidates, score, budget, improved,
+                                assignment);
+    run.stoppedMs = budget.elapsedMs();
+    if (canceller.joinable()) canceller.join();
+    run.solved = search.candidatesSolved();
+    run.bestScore = run.published.empty() ? 0 : run.published.back();
+  }
+
+  cout << GRAY << candidates.size() << " course loads of " << TARGET
+       << " +/- 1 credits, " << loadPool.size() << " hardware threads"
+       << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(17) << "Run" << setw(9)
+       << "Threads" << setw(9) << "Solved" << setw(8) << "Bests" << setw(12)
+       << "First (ms)" << setw(14) << "Stopped (ms)" << setw(8) << "Score"
+       << "Of full" << RESET << endl;
+  cout << GRAY << string(84, '-') << RESET << endl;
+  double fullScore = runs[0].bestScore;
+  for (const Run& run : runs) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(17)
+         << run.name << RESET << setw(9) << run.threads << setw(9)
+         << run.solved << setw(8) << run.published.size() << setw(12)
+         << run.firstMs << setw(14) << run.stoppedMs << setprecision(3)
+         << setw(8) << run.bestScore << setprecision(1)
+         << (fullScore > 0 ? 100 * run.bestScore / fullScore : 0) << "%"
+         << endl;
+  }
+  cout << right;
+
+  bool increasing = true;
+  for (const Run& run : runs) {
+    for (size_t i = 1; i < run.published.size(); i++) {
+      increasing = increasing && run.published[i] >= run.published[i - 1];
+    }
+  }
+  auto msText = [](double ms) {
+    ostringstream text;
+    text << fixed << setprecision(2) << ms << " ms";
+    return text.str();
+  };
+  const Run& budgeted = runs[2];
+  const Run& cancelled = runs[4];
+  printTestResult("First schedule published within 50 ms",
+                  budgeted.firstMs >= 0 && budgeted.firstMs <= 50,
+                  msText(budgeted.firstMs));
+  printTestResult("50 ms budget stops close to its deadline",
+                  budgeted.stoppedMs <= 50 + 25, msText(budgeted.stoppedMs));
+  printTestResult("Published schedules only get better", increasing);
+  printTestResult("Full search gives the same best on 1 thread and the pool",
+                  runs[0].found == runs[1].found &&
+                      runs[0].bestScore == runs[1].bestScore,
+                  "candidate " + to_string(runs[0].found));
+  printTestResult("Cancelled search keeps its best so far",
+                  cancelled.found != CandidateSearch::NOT_FOUND &&
+                      cancelled.stoppedMs < runs[1].stoppedMs,
+                  to_string(cancelled.solved) + " candidates solved");
+}
+
+void ScheduleManager::runTopSchedulesBenchmark() {
+  printTestHeader("TOP-K DIVERSE SCHEDULES BENCHMARK (STORE ALL vs HEAP)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  const double TARGET = 15;
+  const double TOLERANCE = 1.0;
+  const double MIN_DISTANCE = 0.5;
+  vector<double> credits;
+  unordered_map<int, double> creditsById;
+  for (const Course& course : courses) {
+    credits.push_back(course.getCredits());
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+  CreditSubsets subsets(credits, TARGET, TOLERANCE, 2, 6);
+  size_t setCount = static_cast<size_t>(subsets.count());
+  ScheduleQuality quality(lessonTable, TARGET);
+  CandidateSearch::CandidateFunction candidate =
+      [&](size_t rank, vector<int>& courseIds) {
+        for (int course : subsets.at(static_cast<double>(rank))) {
+          courseIds.push_back(courses[course].getCourseId());
+        }
+        sort(courseIds.begin(), courseIds.end());
+      };
+  auto makeOption = [&](size_t rank, const vector<int>& courseIds,
+                        const vector<LessonRef>& lessons) {
+    TopSchedules::Option option;
+    option.candidate = rank;
+    option.courseIds = courseIds;
+    option.lessons = lessons;
+    for (int courseId : courseIds) option.credits += creditsById[courseId];
+    option.score = quality.score(lessons, option.credits);
+    return option;
+  };
+  auto bestFirst = [](const TopSchedules::Option& a,
+                      const TopSchedules::Option& b) {
+    return a.score != b.score ? a.score > b.score : a.candidate < b.candidate;
+  };
+
+  cout << GRAY << setCount << " course sets of " << TARGET << " +/- "
+       << TOLERANCE << " credits, minimum Jaccard distance " << MIN_DISTANCE
+       << ", " << loadPool.size() << " hardware threads" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(6) << "K" << setw(20)
+       << "Method" << setw(12) << "Schedules" << setw(12) << "Time (ms)"
+       << setw(16) << "Peak heap (KB)" << "Options" << RESET << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+
+  bool sameBest = true;
+  bool diverse = true;
+  bool full = true;
+  bool bounded = true;
+  size_t sharedWithGreedy = 0;
+  size_t greedyTotal = 0;
+  for (size_t k : {10, 50}) {
+    mutex lock;
+    SearchBudget unlimited;
+
+    // Before: keep every schedulable set, then sort and pick greedily
+    size_t base = heapLiveBytes();
+    size_t storePeak = 0;
+    auto start = chrono::steady_clock::now();
+    vector<TopSchedules::Option> all;
+    CandidateSearch storeSearch(lessonIndex, compatibility, loadPool);
+    storeSearch.solveEach(
+        setCount, candidate, unlimited,
+        [&](size_t rank, const vector<int>& courseIds,
+            const vector<LessonRef>& lessons) {
+          TopSchedules::Option option = makeOption(rank, courseIds, lessons);
+          lock_guard<mutex> guard(lock);
+          all.push_back(move(option));
+          storePeak = max(storePeak, heapLiveBytes() - base);
+        });
+    sort(all.begin(), all.end(), bestFirst);
+    vector<TopSchedules::Option> greedy;
+    for (const TopSchedules::Option& option : all) {
+      if (greedy.size() == k) break;
+      bool farEnough = true;
+      for (const TopSchedules::Option& kept : greedy) {
+        double distance =
+            TopSchedules::jaccardDistance(option.courseIds, kept.courseIds);
+        farEnough = farEnough && distance >= MIN_DISTANCE && distance > 0;
+      }
+      if (farEnough) greedy.push_back(option);
+    }
+    double storeMs = elapsedMs(start);
+    size_t schedulable = all.size();
+    all.clear();
+    all.shrink_to_fit();
+
+    // After: the bounded heap, offered to as the search runs
+    base = heapLiveBytes();
+    size_t heapPeak = 0;
+    size_t offered = 0;
+    start = chrono::steady_clock::now();
+    TopSchedules top(k, MIN_DISTANCE);
+    CandidateSearch heapSearch(lessonIndex, compatibility, loadPool);
+    heapSearch.solveEach(
+        setCount, candidate, unlimited,
+        [&](size_t rank, const vector<int>& courseIds,
+            const vector<LessonRef>& lessons) {
+          TopSchedules::Option option = makeOption(rank, courseIds, lessons);
+          lock_guard<mutex> guard(lock);
+          offered++;
+          top.offer(option);
+          heapPeak = max(heapPeak, heapLiveBytes() - base);
+        });
+    vector<TopSchedules::Option> kept = top.sorted();
+    double heapMs = elapsedMs(start);
+
+    // The analytics entry point the advisors' tools call, over every set
+    start = chrono::steady_clock::now();
+    vector<TopSchedules::Option> found =
+        analytics.findTopSchedules(TARGET, TOLERANCE, k, MIN_DISTANCE, 0);
+    double analyticsMs = elapsedMs(start);
+
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(6) << k
+         << RESET << setw(20) << "Store all + sort" << setw(12)
+         << schedulable << setw(12) << storeMs << setw(16)
+         << storePeak / 1024.0 << greedy.size() << endl;
+    cout << setw(6) << "" << setw(20) << "Bounded heap" << setw(12)
+         << offered << setw(12) << heapMs << setw(16)
+         << heapPeak / 1024.0 << kept.size() << endl;
+    cout << setw(6) << "" << setw(20) << "findTopSchedules" << setw(12)
+         << "" << setw(12) << analyticsMs << setw(16) << "" << found.size()
+         << endl;
+
+    for (const vector<TopSchedules::Option>* list : {&kept, &found}) {
+      sameBest = sameBest && !list->empty() && !greedy.empty() &&
+                 (*list)[0].score == greedy[0].score &&
+                 (*list)[0].courseIds == greedy[0].courseIds;
+      full = full && list->size() == greedy.size();
+      for (size_t i = 0; i < list->size(); i++) {
+        for (size_t j = i + 1; j < list->size(); j++) {
+          diverse = diverse && TopSchedules::jaccardDistance(
+                                   (*list)[i].courseIds,
+                                   (*list)[j].courseIds) >= MIN_DISTANCE;
+        }
+      }
+    }
+    for (const TopSchedules::Option& option : kept) {
+      for (const TopSchedules::Option& pick : greedy) {
+        if (pick.courseIds == option.courseIds) sharedWithGreedy++;
+      }
+    }
+    greedyTotal += greedy.size();
+    bounded = bounded && heapPeak * 10 < storePeak;
+  }
+  cout << right;
+
+  printTestResult("Heap keeps the same best schedule as sorting them all",
+                  sameBest);
+  printTestResult("Every pair of options is far enough apart", diverse);
+  printTestResult("Heap returns as many options as the greedy pick", full);
+  if (heapCountingEnabled()) {
+    printTestResult("Heap memory is a small fraction of storing them all",
+                    bounded,
+                    to_string(sharedWithGreedy) + "/" + to_string(greedyTotal) +
+                        " options shared with the greedy pick");
+  } else {
+    cout << GRAY << "  [i] Peak heap comparison: skipped, needs a "
+         << "BENCHMARK_ALLOCATIONS build" << RESET << endl;
+  }
+}
+
+void ScheduleManager::runPreferencesBenchmark() {
+  printTestHeader("PREFERENCE MASKS BENCHMARK (SOLVER AND SCORING)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  const string SPEC = "after=10:00 off=Friday max=6 gaps";
+  const int EARLIEST = 10 * 60;
+  const int FRIDAY = 5;
+  const int MAX_MINUTES = 6 * 60;
+  SchedulePreferences::Spec spec;
+  string error;
+  SchedulePreferences::parse(SPEC, spec, error);
+  SchedulePreferences preferences;
+  preferences.compile(spec, lessonTable, compatibility.size());
+
+  const int CANDIDATES = 20000;
+  mt19937 random(20240715);
+  vector<vector<int>> candidates;
+  vector<int> courseIds;
+  unordered_map<int, double> creditsById;
+  for (const Course& course : courses) {
+    courseIds.push_back(course.getCourseId());
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+  uniform_int_distribution<int> pickCount(2, 6);
+  for (int i = 0; i < CANDIDATES; i++) {
+    shuffle(courseIds.begin(), courseIds.end(), random);
+    candidates.emplace_back(courseIds.begin(),
+                            courseIds.begin() + pickCount(random));
+  }
+
+  // The rules checked straight from the lesson table, no masks involved
+  auto breaksRules = [&](LessonRef lesson) {
+    return lessonTable.dayIndex(lesson) == FRIDAY ||
+           (lessonTable.startMinute(lesson) != LessonTable::NO_START &&
+            lessonTable.startMinute(lesson) < EARLIEST);
+  };
+  auto followsRules = [&](const vector<LessonRef>& lessons) {
+    int dayMinutes[8] = {0};
+    for (LessonRef lesson : lessons) {
+      if (breaksRules(lesson)) return false;
+      int day = min<int>(lessonTable.dayIndex(lesson), 7);
+      dayMinutes[day] += lessonTable.durationMinutes(lesson);
+      if (day < 7 && dayMinutes[day] > MAX_MINUTES) return false;
+    }
+    return true;
+  };
+
+  struct Result {
+    string name;
+    const SchedulePreferences* preferences;
+    double solveMs;
+    size_t schedulable;
+    double scoreNs;
+  };
+  vector<Result> results = {{"No preferences", nullptr, 0, 0, 0},
+                            {SPEC, &preferences, 0, 0, 0}};
+  bool rulesHold = true;
+  bool measuresMatch = true;
+  for (Result& result : results) {
+    WorkerPool single(1);
+    CandidateSearch search(lessonIndex, compatibility, single,
+                           result.preferences);
+    vector<char> schedulable;
+    auto start = chrono::steady_clock::now();
+    search.solveAll(candidates, schedulable);
+    result.solveMs = elapsedMs(start);
+    result.schedulable = count(schedulable.begin(), schedulable.end(), 1);
+
+    // Keep the assignments to check them and to time scoring
+    vector<vector<LessonRef>> assignments;
+    vector<double> assignmentCredits;
+    SearchBudget unlimited;
+    search.solveEach(
+        candidates.size(),
+        [&](size_t i, vector<int>& ids) { ids = candidates[i]; },
+        unlimited,
+        [&](size_t, const vector<int>& ids,
+            const vector<LessonRef>& lessons) {
+          double total = 0;
+          for (int id : ids) total += creditsById[id];
+          assignments.push_back(lessons);
+          assignmentCredits.push_back(total);
+        });
+
+    ScheduleQuality quality(lessonTable, 15, result.preferences);
+    ScheduleQuality sorted(lessonTable, 15);
+    double checksum = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < assignments.size(); i++) {
+      checksum += quality.score(assignments[i], assignmentCredits[i]);
+    }
+    result.scoreNs = elapsedMs(start) * 1e6 / max<size_t>(1,
+                                                          assignments.size());
+
+    for (size_t i = 0; i < assignments.size(); i++) {
+      if (result.preferences) {
+        rulesHold = rulesHold && followsRules(assignments[i]);
+      }
+      ScheduleQuality::Metrics bits =
+          quality.measure(assignments[i], assignmentCredits[i]);
+      ScheduleQuality::Metrics walked =
+          sorted.measure(assignments[i], assignmentCredits[i]);
+      measuresMatch = measuresMatch && bits.daysUsed == walked.daysUsed &&
+                      bits.gapMinutes == walked.gapMinutes &&
+                      bits.earlyStarts == walked.earlyStarts;
+    }
+    if (checksum < 0) cout << "";  // Keep the scoring loop
+  }
+
+  // Exhaustive search under the same rules for the first candidates
+  const int CHECKED = 2000;
+  bool answersMatch = true;
+  {
+    WorkerPool single(1);
+    CandidateSearch search(lessonIndex, compatibility, single, &preferences);
+    vector<vector<int>> firstCandidates(candidates.begin(),
+                                        candidates.begin() + CHECKED);
+    vector<char> schedulable;
+    search.solveAll(firstCandidates, schedulable);
+    for (int i = 0; i < CHECKED; i++) {
+      vector<vector<LessonRef>> types =
+          lessonTypeGroups(lessonIndex, firstCandidates[i]);
+      vector<LessonRef> chosen;
+      function<bool(size_t)> place = [&](size_t type) {
+        if (type == types.size()) return followsRules(chosen);
+        for (LessonRef group : types[type]) {
+          bool fits = !breaksRules(group);
+          for (LessonRef other : chosen) {
+            fits = fits && !compatibility.clash(group, other);
+          }
+          if (!fits) continue;
+          chosen.push_back(group);
+          if (place(type + 1)) return true;
+          chosen.pop_back();
+        }
+        return false;
+      };
+      answersMatch = answersMatch && place(0) == (schedulable[i] == 1);
+    }
+  }
+
+  size_t allowed = 0;
+  for (size_t section = 0; section < compatibility.size(); section++) {
+    if (preferences.allowed(static_cast<LessonRef>(section))) allowed++;
+  }
+  cout << GRAY << CANDIDATES << " random combinations of 2-6 courses, "
+       << allowed << "/" << compatibility.size()
+       << " sections allowed by the preferences" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(36) << "Preferences"
+       << setw(16) << "Solve all (ms)" << setw(14) << "Schedulable"
+       << "Score (ns)" << RESET << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  for (const Result& result : results) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(36)
+         << result.name << RESET << setw(16) << result.solveMs << setw(14)
+         << result.schedulable << setprecision(0) << result.scoreNs << endl;
+  }
+  cout << right;
+
+  printTestResult("Every schedule found follows the preferences", rulesHold);
+  printTestResult("Solver agrees with exhaustive search under the rules",
+                  answersMatch,
+                  "first " + to_string(CHECKED) + " candidates");
+  printTestResult("Mask days, gaps and early starts match sorting",
+                  measuresMatch);
+  printTestResult("Preferences do not slow the solver",
+                  results[1].solveMs <= results[0].solveMs * 1.1,
+                  "ratio " + to_string(results[1].solveMs /
+                                       max(results[0].solveMs, 1e-9)));
+}
+
+void ScheduleManager::runParetoFrontBenchmark() {
+  printTestHeader("PARETO FRONT BENCHMARK (PAIRWISE vs SORTED FRONT)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  const double TARGET = 15;
+  const double TOLERANCE = 1.0;
+  vector<double> credits;
+  unordered_map<int, double> creditsById;
+  for (const Course& course : courses) {
+    credits.push_back(course.getCredits());
+    creditsById[course.getCourseId()] = course.getCredits();
+  }
+  CreditSubsets subsets(credits, TARGET, TOLERANCE, 2, 6);
+  size_t setCount = static_cast<size_t>(subsets.count());
+  ScheduleQuality quality(lessonTable, TARGET);
+
+  // Every schedulable set's objectives, without its lessons
+  vector<ParetoFront::Point> all;
+  mutex lock;
+  SearchBudget unlimited;
+  auto start = chrono::steady_clock::now();
+  CandidateSearch search(lessonIndex, compatibility, loadPool);
+  search.solveEach(
+      setCount,
+      [&](size_t rank, vector<int>& courseIds) {
+        for (int course : subsets.at(static_cast<double>(rank))) {
+          courseIds.push_back(courses[course].getCourseId());
+        }
+        sort(courseIds.begin(), courseIds.end());
+      },
+      unlimited,
+      [&](size_t rank, const vector<int>& courseIds,
+          const vector<LessonRef>& lessons) {
+        ParetoFront::Point point;
+        point.candidate = rank;
+        for (int courseId : courseIds) point.credits += creditsById[courseId];
+        ScheduleQuality::Metrics metrics =
+            quality.measure(lessons, point.credits);
+        point.objectives[ParetoFront::CREDIT_DEVIATION] =
+            metrics.creditDeviation;
+        point.objectives[ParetoFront::IDLE_MINUTES] = metrics.gapMinutes;
+        point.objectives[ParetoFront::DAYS_USED] = metrics.daysUsed;
+        point.objectives[ParetoFront::EARLY_STARTS] = metrics.earlyStarts;
+        lock_guard<mutex> guard(lock);
+        all.push_back(move(point));
+      });
+  double solveMs = elapsedMs(start);
+  sort(all.begin(), all.end(),
+       [](const ParetoFront::Point& a, const ParetoFront::Point& b) {
+         return a.candidate < b.candidate;
+       });
+
+  // Before: test every point against every other one
+  start = chrono::steady_clock::now();
+  set<size_t> pairwise;
+  for (const ParetoFront::Point& point : all) {
+    bool beaten = false;
+    for (const ParetoFront::Point& other : all) {
+      if (ParetoFront::dominates(other.objectives, point.objectives) ||
+          (other.candidate < point.candidate &&
+           equal(other.objectives, other.objectives + ParetoFront::OBJECTIVES,
+                 point.objectives))) {
+        beaten = true;
+        break;
+      }
+    }
+    if (!beaten) pairwise.insert(point.candidate);
+  }
+  double pairwiseMs = elapsedMs(start);
+
+  // After: offer them one by one to the sorted front
+  start = chrono::steady_clock::now();
+  ParetoFront front;
+  for (const ParetoFront::Point& point : all) {
+    ParetoFront::Point offered = point;
+    front.offer(offered);
+  }
+  double frontMs = elapsedMs(start);
+  set<size_t> sorted;
+  for (const ParetoFront::Point& point : front.points()) {
+    sorted.insert(point.candidate);
+  }
+
+  // The analytics entry point: solve, measure and offer on the pool, over
+  // every set
+  start = chrono::steady_clock::now();
+  vector<ParetoFront::Point> found =
+      analytics.findParetoFront(TARGET, TOLERANCE, 0);
+  double analyticsMs = elapsedMs(start);
+  set<size_t> parallel;
+  for (const ParetoFront::Point& point : found) {
+    parallel.insert(point.candidate);
+  }
+
+  // A single weighted score is only ever as good as a point on the front
+  auto scoreOf = [&](const ParetoFront::Point& point) {
+    ScheduleQuality::Metrics metrics;
+    metrics.creditDeviation = point.objectives[ParetoFront::CREDIT_DEVIATION];
+    metrics.gapMinutes =
+        static_cast<int>(point.objectives[ParetoFront::IDLE_MINUTES]);
+    metrics.daysUsed =
+        static_cast<int>(point.objectives[ParetoFront::DAYS_USED]);
+    return quality.score(metrics);
+  };
+  double bestScore = 0;
+  double bestOnFront = 0;
+  for (const ParetoFront::Point& point : all) {
+    bestScore = max(bestScore, scoreOf(point));
+  }
+  for (const ParetoFront::Point& point : found) {
+    bestOnFront = max(bestOnFront, scoreOf(point));
+  }
+
+  cout << GRAY << setCount << " course sets of " << TARGET << " +/- "
+       << TOLERANCE << " credits, " << all.size() << " schedulable (solved in "
+       << fixed << setprecision(2) << solveMs << " ms), "
+       << loadPool.size() << " hardware threads" << RESET << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(34) << "Method" << setw(14)
+       << "Points" << setw(14) << "Time (ms)" << "Front" << RESET << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  cout << left << BRIGHT_CYAN << setw(34) << "Pairwise filter" << RESET
+       << setw(14) << all.size() << setw(14) << pairwiseMs << pairwise.size()
+       << endl;
+  cout << BRIGHT_CYAN << setw(34) << "Sorted front, offered in turn"
+       << RESET << setw(14) << all.size() << setw(14) << frontMs
+       << sorted.size() << endl;
+  cout << BRIGHT_CYAN << setw(34) << "findParetoFront (solve + offer)"
+       << RESET << setw(14) << setCount << setw(14) << analyticsMs
+       << parallel.size() << endl;
+  cout << right;
+
+  printTestResult("Sorted front matches the pairwise filter",
+                  sorted == pairwise,
+                  to_string(front.displaced()) + " points displaced");
+  printTestResult("Parallel search returns the same front",
+                  parallel == pairwise);
+  printTestResult("Best weighted score is on the front",
+                  fabs(bestOnFront - bestScore) < 1e-12);
+  printTestResult("Sorted front is faster than the pairwise filter",
+                  frontMs < pairwiseMs,
+                  "speedup " + to_string(pairwiseMs / max(frontMs, 1e-9)));
+}
+
+void ScheduleManager::runFeasibilityCacheBenchmark() {
+  printTestHeader("FEASIBILITY CACHE BENCHMARK (SOLVE vs REMEMBER)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  // Two batches of random course sets: the second overlaps the first only
+  // where the draws happen to share courses
+  const int CANDIDATES = 20000;
+  mt19937 random(20240715);
+  vector<int> courseIds;
+  for (const Course& course : courses) {
+    courseIds.push_back(course.getCourseId());
+  }
+  uniform_int_distribution<int> pickCount(2, 6);
+  vector<vector<int>> batches[2];
+  for (vector<vector<int>>& batch : batches) {
+    for (int i = 0; i < CANDIDATES; i++) {
+      shuffle(courseIds.begin(), courseIds.end(), random);
+      batch.emplace_back(courseIds.begin(),
+                         courseIds.begin() + pickCount(random));
+    }
+  }
+
+  FeasibilityCache cache;
+  cache.reset(courseIds);
+  struct Run {
+    string name;
+    int batch;
+    FeasibilityCache* cache;
+    double ms;
+    double hitRate;
+    vector<char> schedulable;
+  };
+  vector<Run> runs = {{"No cache, first batch", 0, nullptr, 0, 0, {}},
+                      {"No cache, second batch", 1, nullptr, 0, 0, {}},
+                      {"Cold cache, first batch", 0, &cache, 0, 0, {}},
+                      {"Warm, first batch again", 0, &cache, 0, 0, {}},
+                      {"Warm, second batch", 1, &cache, 0, 0, {}}};
+  for (Run& run : runs) {
+    cache.resetStats();
+    CandidateSearch search(lessonIndex, compatibility, loadPool, nullptr,
+                           run.cache);
+    auto start = chrono::steady_clock::now();
+    search.solveAll(batches[run.batch], run.schedulable);
+    run.ms = elapsedMs(start);
+    FeasibilityCache::Stats stats = cache.stats();
+    size_t lookups = stats.hits + stats.proofHits + stats.misses;
+    run.hitRate = run.cache && lookups
+                      ? 100.0 * (stats.hits + stats.proofHits) / lookups
+                      : 0;
+  }
+  FeasibilityCache::Stats stored = cache.stats();
+
+  // Every cached assignment must still be a full, conflict-free schedule
+  bool assignmentsValid = true;
+  size_t checked = 0;
+  mutex lock;
+  SearchBudget unlimited;
+  CandidateSearch cached(lessonIndex, compatibility, loadPool, nullptr,
+                         &cache);
+  cached.solveEach(
+      batches[1].size(),
+      [&](size_t i, vector<int>& ids) { ids = batches[1][i]; }, unlimited,
+      [&](size_t, const vector<int>& ids, const vector<LessonRef>& lessons) {
+        bool valid =
+            lessons.size() == lessonTypeGroups(lessonIndex, ids).size();
+        for (size_t a = 0; a < lessons.size() && valid; a++) {
+          valid = find(ids.begin(), ids.end(),
+                       lessonTable.courseId(lessons[a])) != ids.end();
+          for (size_t b = a + 1; b < lessons.size() && valid; b++) {
+            valid = !compatibility.clash(lessons[a], lessons[b]);
+          }
+        }
+        lock_guard<mutex> guard(lock);
+        assignmentsValid = assignmentsValid && valid;
+        checked++;
+      });
+
+  cache.invalidate();
+  FeasibilityCache::Stats cleared = cache.stats();
+
+  cout << GRAY << CANDIDATES << " random combinations of 2-6 courses per "
+       << "batch, " << loadPool.size() << " hardware threads" << RESET
+       << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(28) << "Run" << setw(14)
+       << "Time (ms)" << setw(14) << "us per set" << setw(14) << "Hit rate"
+       << "Schedulable" << RESET << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  for (const Run& run : runs) {
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(28)
+         << run.name << RESET << setw(14) << run.ms << setw(14)
+         << run.ms * 1000 / CANDIDATES << setprecision(1) << setw(14)
+         << (run.cache ? to_string(static_cast<int>(run.hitRate + 0.5)) + "%"
+                       : string("-"))
+         << count(run.schedulable.begin(), run.schedulable.end(), 1) << endl;
+  }
+  cout << right;
+  cout << GRAY << "Stored " << stored.entries << " schedulable sets and "
+       << stored.cores << " unschedulable cores" << RESET << endl;
+
+  printTestResult("Cached answers match solving every set",
+                  runs[2].schedulable == runs[0].schedulable &&
+                      runs[3].schedulable == runs[0].schedulable &&
+                      runs[4].schedulable == runs[1].schedulable);
+  printTestResult("Cached assignments are complete and conflict-free",
+                  assignmentsValid,
+                  to_string(checked) + " schedules checked");
+  printTestResult("Repeated batch is answered from the cache",
+                  runs[3].hitRate == 100.0,
+                  to_string(runs[3].ms * 1000 / CANDIDATES) + " us per set");
+  printTestResult("Overlapping batch is faster than solving",
+                  runs[4].ms < runs[1].ms,
+                  "speedup " + to_string(runs[1].ms / max(runs[4].ms, 1e-9)));
+  printTestResult("Invalidation drops every answer",
+                  cleared.entries == 0 && cleared.cores == 0);
+}
+
+void ScheduleManager::runBulkScheduleBenchmark() {
+  printTestHeader("BULK SCHEDULING BENCHMARK (STUDENTS PER SECOND)");
+
+  if (courses.size() < 6) {
+    cout << RED << "[ERROR] Need at least 6 courses loaded." << RESET << endl;
+    return;
+  }
+
+  // A registration office's worth of students, 3-6 courses each
+  const int STUDENTS = 5000;
+  const vector<string> SPECS = {"",
+                                "after=10:00",
+                                "off=Friday",
+                                "after=09:00 off=Monday max=6",
+                                "gaps",
+                                "max=5 off=Wednesday"};
+  const string requestsPath = dataDirectory + "bench_bulk_requests.csv";
+  const string resultsPath[2] = {dataDirectory + "bench_bulk_serial.csv",
+                                 dataDirectory + "bench_bulk_pool.csv"};
+  mt19937 random(20240715);
+  vector<int> courseIds;
+  for (const Course& course : courses) {
+    courseIds.push_back(course.getCourseId());
+  }
+  uniform_int_distribution<int> pickCount(3, 6);
+  uniform_int_distribution<size_t> pickSpec(0, SPECS.size() - 1);
+  {
+    ofstream requests(requestsPath);
+    requests << "student_id,courses,preferences\n";
+    for (int student = 0; student < STUDENTS; student++) {
+      shuffle(courseIds.begin(), courseIds.end(), random);
+      requests << 100000 + student << ',';
+      int count = pickCount(random);
+      for (int i = 0; i < count; i++) {
+        requests << (i ? " " : "") << courseIds[i];
+      }
+      requests << ',' << SPECS[pickSpec(random)] << '\n';
+    }
+  }
+
+  WorkerPool single(1);
+  WorkerPool* pools[2] = {&single, &loadPool};
+  BulkScheduler::Summary summaries[2];
+  bool ran = true;
+  for (int run = 0; run < 2; run++) {
+    BulkScheduler scheduler(courses, lessonTable, lessonIndex, compatibility,
+                            *pools[run]);
+    string error;
+    ran = scheduler.run(requestsPath, resultsPath[run], summaries[run],
+                        error) &&
+          ran;
+  }
+
+  auto readLines = [](const string& path) {
+    vector<string> lines;
+    ifstream file(path);
+    string line;
+    while (getline(file, line)) lines.push_back(line);
+    return lines;
+  };
+  vector<string> requestRows = readLines(requestsPath);
+  vector<string> serialRows = readLines(resultsPath[0]);
+  vector<string> poolRows = readLines(resultsPath[1]);
+
+  // Check every result row against the catalog and its student's request
+  bool rowsValid = serialRows.size() == requestRows.size();
+  bool unschedulableConfirmed = true;
+  size_t confirmed = 0;
+  for (size_t row = 1; row < serialRows.size() && rowsValid; row++) {
+    vector<string> request;
+    vector<string> result;
+    stringstream requestText(requestRows[row]);
+    stringstream resultText(serialRows[row]);
+    for (string field; getline(requestText, field, ',');) {
+      request.push_back(field);
+    }
+    for (string field; getline(resultText, field, ',');) {
+      result.push_back(field);
+    }
+    vector<int> wanted;
+    istringstream ids(request[1]);
+    for (int id; ids >> id;) wanted.push_back(id);
+    SchedulePreferences::Spec spec;
+    string error;
+    SchedulePreferences::parse(request.size() > 2 ? request[2] : "", spec,
+                               error);
+    rowsValid = result[0] == request[0];
+    vector<vector<LessonRef>> types = lessonTypeGroups(lessonIndex, wanted);
+
+    if (result[1] == "UNSCHEDULABLE") {
+      // Without preferences the exhaustive search must agree
+      if (request.size() < 3 || request[2].empty()) {
+        vector<LessonRef> chosen;
+        unschedulableConfirmed = unschedulableConfirmed &&
+                                 !backtrackGroups(compatibility, types,
+                                                  chosen);
+        confirmed++;
+      }
+      continue;
+    }
+    if (result[1] != "SCHEDULED") {
+      rowsValid = false;
+      continue;
+    }
+
+    // courseId:groupId back to catalog groups, one per lesson type
+    vector<LessonRef> lessons;
+    istringstream sections(result[5]);
+    for (string section; sections >> section;) {
+      size_t colon = section.find(':');
+      int courseId = stoi(section.substr(0, colon));
+      string groupId = section.substr(colon + 1);
+      for (const vector<LessonRef>& groups : types) {
+        for (LessonRef group : groups) {
+          if (lessonTable.courseId(group) == courseId &&
+              lessonTable.groupId(group) == groupId) {
+            lessons.push_back(group);
+          }
+        }
+      }
+    }
+    rowsValid = rowsValid && lessons.size() == types.size();
+    int dayMinutes[8] = {0};
+    for (size_t a = 0; a < lessons.size() && rowsValid; a++) {
+      LessonRef lesson = lessons[a];
+      int day = min<int>(lessonTable.dayIndex(lesson), 7);
+      int start = lessonTable.startMinute(lesson);
+      dayMinutes[day] += lessonTable.durationMinutes(lesson);
+      rowsValid = !(day < 7 && (spec.daysOff & (1 << day))) &&
+                  (start == LessonTable::NO_START ||
+                   start >= spec.earliestStart) &&
+                  (spec.maxDailyMinutes == 0 || day == 7 ||
+                   dayMinutes[day] <= spec.maxDailyMinutes);
+      for (size_t b = a + 1; b < lessons.size() && rowsValid; b++) {
+        rowsValid = !compatibility.clash(lesson, lessons[b]);
+      }
+    }
+  }
+
+  remove(requestsPath.c_str());
+  remove(resultsPath[0].c_str());
+  remove(resultsPath[1].c_str());
+
+  cout << GRAY << STUDENTS << " students of 3-6 courses, " << SPECS.size()
+       << " preference specs, blocks of " << BulkScheduler::BLOCK << RESET
+       << endl;
+  cout << "\n"
+       << BRIGHT_WHITE << BOLD << left << setw(10) << "Threads" << setw(14)
+       << "Time (ms)" << setw(16) << "Students/sec" << setw(12)
+       << "Scheduled" << setw(16) << "Unschedulable" << "Invalid" << RESET
+       << endl;
+  cout << GRAY << string(76, '-') << RESET << endl;
+  for (int run = 0; run < 2; run++) {
+    const BulkScheduler::Summary& summary = summaries[run];
+    cout << left << fixed << setprecision(2) << BRIGHT_CYAN << setw(10)
+         << pools[run]->size() << RESET << setw(14) << summary.elapsedMs
+         << setprecision(0) << setw(16) << summary.studentsPerSecond()
+         << setw(12) << summary.scheduled << setw(16)
+         << summary.unschedulable << summary.invalid << endl;
+  }
+  cout << right;
+
+  printTestResult("Every student gets one result row",
+                  ran && summaries[1].students == STUDENTS &&
+                      poolRows.size() == STUDENTS + 1);
+  printTestResult("Output is the same for any thread count",
+                  serialRows == poolRows);
+  printTestResult("Scheduled rows are valid under their preferences",
+                  rowsValid);
+  printTestResult("Unschedulable rows agree with exhaustive search",
+                  unschedulableConfirmed,
+                  to_string(confirmed) + " rows without preferences");
+}
@@ -0,0 +1,249 @@
+#include "PersistenceQueue.h"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Flush a closed file's data to the device (fsync / _commit)
+bool syncFile(const string& path) {
+#ifdef _WIN32
+  int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+  if (fd < 0) return false;
+  bool synced = _commit(fd) == 0;
+  _close(fd);
+#else
+  int fd = open(path.c_str(), O_WRONLY);
+  if (fd < 0) return false;
+  bool synced = fsync(fd) == 0;
+  close(fd);
+#endif
+  return synced;
+}
+
+#ifndef _WIN32
+// Make a rename inside `path`'s directory durable; best effort, since some
+// file systems refuse to sync a directory
+void syncParentDirectory(const string& path) {
+  size_t slash = path.find_last_of('/');
+  string directory = slash == string::npos ? "." : path.substr(0, slash + 1);
+  int fd = open(directory.c_str(), O_RDONLY);
+  if (fd < 0) return;
+  fsync(fd);
+  close(fd);
+}
+#endif
+
+}  // namespace
+
+PersistenceQueue::PersistenceQueue(chrono::milliseconds flushInterval,
+                                   size_t flushThreshold)
+    : interval(flushInterval),
+      flushBytes(flushThreshold),
+      queuedBytes(0),
+      queuedSequence(0),
+      writtenSequence(0),
+      flushRequested(false),
+      stopping(false),
+      counters() {
+  flusher = thread(&PersistenceQueue::flusherLoop, this);
+}
+
+PersistenceQueue::~PersistenceQueue() {
+  {
+    lock_guard<mutex> lock(queueMutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  flusher.join();
+}
+
+void PersistenceQueue::configure(chrono::milliseconds flushInterval,
+                                 size_t flushThreshold) {
+  {
+    lock_guard<mutex> lock(queueMutex);
+    interval = flushInterval;
+    flushBytes = flushThreshold;
+  }
+  wake.notify_one();
+}
+
+// =================== QUEUEING ===================
+
+void PersistenceQueue::replaceFile(const string& path,
+                                   const string& content) {
+  enqueue(REPLACE, path, content);
+}
+
+void PersistenceQueue::appendFile(const string& path, const string& text) {
+  enqueue(APPEND, path, text);
+}
+
+void PersistenceQueue::removeFile(const string& path) {
+  enqueue(REMOVE, path, string());
+}
+
+void PersistenceQueue::runTask(const function<void()>& task) {
+  {
+    lock_guard<mutex> lock(queueMutex);
+    if (queue.empty()) oldestQueued = chrono::steady_clock::now();
+    Request request = {TASK, string(), string(), task};
+    queue.push_back(request);
+    // A task may read files back, so nothing queued later merges into a
+    // request ahead of it
+    slots.clear();
+    queuedSequence++;
+    counters.requests++;
+  }
+  wake.notify_one();
+}
+
+void PersistenceQueue::enqueue(Kind kind, const string& path,
+                               const string& data) {
+  bool full = false;
+  {
+    lock_guard<mutex> lock(queueMutex);
+    if (queue.empty()) oldestQueued = chrono::steady_clock::now();
+    queuedSequence++;
+    counters.requests++;
+    queuedBytes += data.size();
+
+    auto slot = slots.find(path);
+    if (slot != slots.end() && kind == APPEND) {
+      // Join the queued request; appending after a remove recreates the file
+      Request& queued = queue[slot->second];
+      if (queued.kind == REMOVE) queued.kind = REPLACE;
+      queued.data += data;
+    } else {
+      if (slot != slots.end()) {
+        Request& superseded = queue[slot->second];
+        queuedBytes -= superseded.data.size();
+        superseded.kind = SUPERSEDED;
+        superseded.data.clear();
+      }
+      Request request = {kind, path, data, nullptr};
+      queue.push_back(request);
+      slots[path] = queue.size() - 1;
+    }
+    full = queuedBytes >= flushBytes;
+  }
+  if (full) wake.notify_one();
+}
+
+void PersistenceQueue::flush() {
+  unique_lock<mutex> lock(queueMutex);
+  uint64_t target = queuedSequence;
+  if (writtenSequence >= target) return;
+  flushRequested = true;
+  wake.notify_one();
+  flushed.wait(lock, [this, target] { return writtenSequence >= target; });
+}
+
+PersistenceQueue::Stats PersistenceQueue::stats() const {
+  lock_guard<mutex> lock(queueMutex);
+  return counters;
+}
+
+// =================== FLUSHER ===================
+
+void PersistenceQueue::flusherLoop() {
+  unique_lock<mutex> lock(queueMutex);
+  while (true) {
+    wake.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (queue.empty()) break;  // Stopping with nothing left
+
+    // Group commit: let requests gather until the oldest one is due
+    wake.wait_until(lock, oldestQueued + interval, [this] {
+      return stopping || flushRequested || queuedBytes >= flushBytes;
+    });
+
+    vector<Request> batch;
+    batch.swap(queue);
+    slots.clear();
+    queuedBytes = 0;
+    flushRequested = false;
+    uint64_t batchSequence = queuedSequence;
+
+    lock.unlock();
+    size_t writes = 0;
+    size_t failures = 0;
+    for (const Request& request : batch) {
+      if (request.kind == SUPERSEDED) continue;
+      writes++;
+      if (!write(request)) failures++;
+    }
+    lock.lock();
+
+    counters.fileWrites += writes;
+    counters.failedWrites += failures;
+    counters.batches++;
+    writtenSequence = batchSequence;
+    flushed.notify_all();
+  }
+}
+
+bool PersistenceQueue::commitFile(const string& tempPath,
+                                  const string& path) {
+  if (!syncFile(tempPath)) return false;
+#ifdef _WIN32
+  return MoveFileExA(tempPath.c_str(), path.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  if (rename(tempPath.c_str(), path.c_str()) != 0) return false;
+  syncParentDirectory(path);
+  return true;
+#endif
+}
+
+bool PersistenceQueue::write(const Request& request) {
+  switch (request.kind) {
+    case REPLACE: {
+      // Write next to the target and move it over, so a crash never leaves
+      // the target torn or missing
+      string tempPath = request.path + ".tmp";
+      {
+        ofstream file(tempPath, ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(request.data.data(),
+                   static_cast<streamsize>(request.data.size()));
+        if (!file.good()) return false;
+      }
+      return commitFile(tempPath, request.path);
+    }
+    case APPEND: {
+      ofstream file(request.path, ios::app);
+      if (!file.is_open()) return false;
+      file.write(request.data.data(),
+                 static_cast<streamsize>(request.data.size()));
+      return file.good();
+    }
+    case REMOVE:
+      remove(request.path.c_str());
+      return true;
+    case TASK:
+      try {
+        request.task();
+      } catch (const exception&) {
+        return false;
+      }
+      return true;
+    default:
+      return true;
+  }
+}
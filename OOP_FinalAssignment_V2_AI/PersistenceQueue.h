@@ -0,0 +1,121 @@
+#ifndef PERSISTENCE_QUEUE_H
+#define PERSISTENCE_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class PersistenceQueue
+ * @brief Group-commit file writer with a background flusher thread
+ *
+ * Callers queue whole-file replacements, appends and removals and return
+ * at once; the flusher thread writes them in batches. A batch goes to disk
+ * when the oldest queued request is `interval` old, when the queued bytes
+ * pass `flushBytes`, on flush(), and on destruction.
+ *
+ * Requests for the same file coalesce while they wait: appends join the
+ * queued request for that file, and a replace or remove drops it and moves
+ * the file to the back of the batch. Batches are written front to back, so
+ * "compact the store, then append to it" reaches the disk in that order.
+ *
+ * Replacements are written to a temp file, forced to disk and moved over
+ * the target in one step, so a crash leaves either the old or the new
+ * file, never a torn one.
+ */
+class PersistenceQueue {
+ public:
+  struct Stats {
+    size_t requests;      // Replace / append / remove / task calls
+    size_t fileWrites;    // File operations actually performed
+    size_t batches;       // Flusher wake-ups that wrote something
+    size_t failedWrites;  // File operations that reported an error
+  };
+
+  explicit PersistenceQueue(
+      chrono::milliseconds interval = chrono::milliseconds(200),
+      size_t flushBytes = 256 * 1024);
+
+  /** @brief Writes everything still queued, then stops the flusher */
+  ~PersistenceQueue();
+
+  /** @brief Change the flush interval and size threshold */
+  void configure(chrono::milliseconds interval, size_t flushBytes);
+
+  /** @brief Replace a file's contents atomically (temp file + rename) */
+  void replaceFile(const string& path, const string& content);
+
+  /** @brief Append text to a file, creating it if needed */
+  void appendFile(const string& path, const string& text);
+
+  /** @brief Delete a file; a missing file is not an error */
+  void removeFile(const string& path);
+
+  /**
+   * @brief Run a task on the flusher thread once the requests queued before
+   *        it are on disk, e.g. to compact files it reads back
+   */
+  void runTask(const function<void()>& task);
+
+  /** @brief Block until everything queued before this call is on disk */
+  void flush();
+
+  Stats stats() const;
+
+  /**
+   * @brief Force a finished temp file to disk, then move it over `path` in
+   *        one step (rename / MoveFileEx); the target is never removed first
+   * @return false if either step failed; `path` is then left as it was
+   */
+  static bool commitFile(const string& tempPath, const string& path);
+
+ private:
+  PersistenceQueue(const PersistenceQueue&) = delete;
+  PersistenceQueue& operator=(const PersistenceQueue&) = delete;
+
+  enum Kind { REPLACE, APPEND, REMOVE, TASK, SUPERSEDED };
+
+  struct Request {
+    Kind kind;
+    string path;
+    string data;
+    function<void()> task;
+  };
+
+  void enqueue(Kind kind, const string& path, const string& data);
+  void flusherLoop();
+  bool write(const Request& request);
+
+  mutable mutex queueMutex;
+  condition_variable wake;     // Flusher: work queued, flush asked, stop
+  condition_variable flushed;  // flush(): a batch reached the disk
+
+  chrono::milliseconds interval;
+  size_t flushBytes;
+
+  // Queued requests in order; `slots` maps a path to its live request so
+  // later requests for the same file can merge into it
+  vector<Request> queue;
+  unordered_map<string, size_t> slots;
+  size_t queuedBytes;
+  chrono::steady_clock::time_point oldestQueued;
+
+  uint64_t queuedSequence;   // Requests accepted so far
+  uint64_t writtenSequence;  // Requests known to be on disk
+  bool flushRequested;
+  bool stopping;
+  Stats counters;
+
+  thread flusher;  // Last, so it starts after everything above
+};
+
+#endif  // PERSISTENCE_QUEUE_H
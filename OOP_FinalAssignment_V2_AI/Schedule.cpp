@@ -9,75 +9,246 @@
 #include <sstream>
 
 #include "Course.h"
-#include "Lab.h"
-#include "Lecture.h"
-#include "Tutorial.h"
+#include "CsvReader.h"
 
-// Initialize static member
+// Initialize static members
 map<int, Course> Schedule::courseDatabase;
+LessonTable* Schedule::lessonTable = nullptr;
 
 // Constructor
 Schedule::Schedule(int id) : scheduleId(id) {}
 
 // Copy constructor
 Schedule::Schedule(const Schedule& other)
-    : scheduleId(other.scheduleId), lessons(other.lessons) {}
+    : scheduleId(other.scheduleId),
+      lessons(other.lessons),
+      dayIntervals(other.dayIntervals),
+      occupancy(other.occupancy) {}
 
 // Assignment operator
 Schedule& Schedule::operator=(const Schedule& other) {
   if (this != &other) {
     scheduleId = other.scheduleId;
     lessons = other.lessons;
+    dayIntervals = other.dayIntervals;
+    occupancy = other.occupancy;
   }
   return *this;
 }
 
+// Move constructor
+Schedule::Schedule(Schedule&& other) noexcept
+    : scheduleId(other.scheduleId),
+      lessons(move(other.lessons)),
+      dayIntervals(move(other.dayIntervals)),
+      occupancy(move(other.occupancy)) {}
+
+// Move assignment operator
+Schedule& Schedule::operator=(Schedule&& other) noexcept {
+  scheduleId = other.scheduleId;
+  lessons = move(other.lessons);
+  dayIntervals = move(other.dayIntervals);
+  occupancy = move(other.occupancy);
+  return *this;
+}
+
 // Destructor
 Schedule::~Schedule() {}
 
 // Getters
 int Schedule::getScheduleId() const { return scheduleId; }
 
-const vector<shared_ptr<Lesson>>& Schedule::getLessons() const {
-  return lessons;
-}
+const vector<LessonRef>& Schedule::getLessons() const { return lessons; }
 
 // Setters
 void Schedule::setScheduleId(int id) { scheduleId = id; }
 
 // Add lesson to schedule
-void Schedule::addLesson(shared_ptr<Lesson> lesson) {
-  if (lesson != nullptr) {
-    lessons.push_back(lesson);
-  }
+void Schedule::addLesson(LessonRef lesson) {
+  lessons.push_back(lesson);
+  indexLesson(lesson);
 }
 
 // Remove lesson from schedule by course and group
 bool Schedule::removeLesson(int courseId, const string& groupId) {
+  const LessonTable& table = getLessonTable();
+  uint16_t groupCode = 0;
+  if (!table.findGroupCode(groupId, groupCode)) return false;
+
   auto it = find_if(lessons.begin(), lessons.end(),
-                    [courseId, groupId](const shared_ptr<Lesson>& lesson) {
-                      return lesson->getCourseId() == courseId &&
-                             lesson->getGroupId() == groupId;
+                    [&table, courseId, groupCode](LessonRef lesson) {
+                      return table.courseId(lesson) == courseId &&
+                             table.groupCode(lesson) == groupCode;
                     });
 
   if (it != lessons.end()) {
+    unindexLesson(*it);
     lessons.erase(it);
     return true;
   }
   return false;
 }
 
-// Check if there's a conflict with new lesson
-bool Schedule::hasConflict(const Lesson& newLesson) const {
-  for (const auto& lesson : lessons) {
-    if (lesson->getDay() == newLesson.getDay()) {
-      // Simple time conflict check (this can be improved)
-      if (lesson->getStartTime() == newLesson.getStartTime()) {
-        return true;
-      }
+// =================== OVERLAP INDEX ===================
+
+namespace {
+
+const LessonRef NO_LESSON = 0xFFFFFFFF;
+
+}  // namespace
+
+// Insert a lesson into its day's start-sorted intervals
+void Schedule::indexLesson(LessonRef lesson) {
+  const LessonTable& table = getLessonTable();
+  uint16_t start = table.startMinute(lesson);
+  if (start == LessonTable::NO_START) return;  // No time, cannot overlap
+
+  size_t day = table.dayIndex(lesson);
+  if (day >= dayIntervals.size()) dayIntervals.resize(day + 1);
+  vector<Interval>& intervals = dayIntervals[day];
+
+  int end = min(start + table.durationMinutes(lesson), 0xFFFF);
+  Interval entry = {start, static_cast<uint16_t>(end), 0, lesson};
+  auto position = upper_bound(
+      intervals.begin(), intervals.end(), start,
+      [](uint16_t minute, const Interval& other) {
+        return minute < other.start;
+      });
+  size_t inserted = position - intervals.begin();
+  intervals.insert(position, entry);
+  updateReach(intervals, inserted);
+  occupancy.set(static_cast<int>(day), start, end - start);
+}
+
+// Reach is a running maximum, so only entries from `from` on change
+void Schedule::updateReach(vector<Interval>& intervals, size_t from) {
+  for (size_t i = from; i < intervals.size(); i++) {
+    uint16_t before = i > 0 ? intervals[i - 1].reach : 0;
+    intervals[i].reach = max(intervals[i].end, before);
+  }
+}
+
+// Drop a lesson from its day's intervals
+void Schedule::unindexLesson(LessonRef lesson) {
+  const LessonTable& table = getLessonTable();
+  size_t day = table.dayIndex(lesson);
+  if (day >= dayIntervals.size()) return;
+  vector<Interval>& intervals = dayIntervals[day];
+
+  auto it = find_if(intervals.begin(), intervals.end(),
+                    [lesson](const Interval& entry) {
+                      return entry.lesson == lesson;
+                    });
+  if (it == intervals.end()) return;
+  Interval gone = *it;
+  size_t removed = it - intervals.begin();
+  intervals.erase(it);
+  updateReach(intervals, removed);
+
+  // Free the slots, then take back those still held by any lesson that
+  // shares one, so the range is rounded out to whole slots
+  occupancy.clear(static_cast<int>(day), gone.start, gone.end - gone.start);
+  const int SLOT = WeekOccupancy::SLOT_MINUTES;
+  int slotStart = gone.start / SLOT * SLOT;
+  int slotEnd = (gone.end + SLOT - 1) / SLOT * SLOT;
+  vector<LessonRef> overlapping;
+  collectOverlaps(static_cast<int>(day), slotStart, slotEnd, NO_LESSON,
+                  overlapping);
+  for (LessonRef other : overlapping) {
+    occupancy.set(static_cast<int>(day), table.startMinute(other),
+                  table.durationMinutes(other));
+  }
+}
+
+// Binary search for the last interval starting before `endMinute`, then
+// walk back while the running maximum end still reaches past
+// `startMinute`. O(log n + k), where k counts the intervals walked: the
+// overlaps, plus any that end before `startMinute` but sit behind a longer
+// earlier lesson that does not.
+void Schedule::collectOverlaps(int dayIndex, int startMinute, int endMinute,
+                               LessonRef exclude,
+                               vector<LessonRef>& found) const {
+  if (dayIndex < 0 || static_cast<size_t>(dayIndex) >= dayIntervals.size()) {
+    return;
+  }
+  const vector<Interval>& intervals = dayIntervals[dayIndex];
+  auto last = lower_bound(intervals.begin(), intervals.end(), endMinute,
+                          [](const Interval& entry, int minute) {
+                            return entry.start < minute;
+                          });
+
+  size_t firstFound = found.size();
+  for (auto it = last; it != intervals.begin();) {
+    --it;
+    if (it->reach <= startMinute) break;
+    if (it->end > startMinute && it->lesson != exclude) {
+      found.push_back(it->lesson);
     }
   }
-  return false;
+  reverse(found.begin() + firstFound, found.end());
+}
+
+// O(log n): an interval starting inside [startMinute, endMinute) overlaps
+// it, and the reach of the last one starting before `startMinute` says
+// whether any earlier interval runs into it
+bool Schedule::overlapsAny(int dayIndex, int startMinute, int endMinute,
+                           LessonRef exclude) const {
+  if (dayIndex < 0 || static_cast<size_t>(dayIndex) >= dayIntervals.size()) {
+    return false;
+  }
+  const vector<Interval>& intervals = dayIntervals[dayIndex];
+  auto byStart = [](const Interval& entry, int minute) {
+    return entry.start < minute;
+  };
+  auto first =
+      lower_bound(intervals.begin(), intervals.end(), startMinute, byStart);
+  auto last = lower_bound(first, intervals.end(), endMinute, byStart);
+
+  // Only `exclude` itself can start inside without counting
+  if (last - first > 1 || (last != first && first->lesson != exclude)) {
+    return true;
+  }
+  return first != intervals.begin() && (first - 1)->reach > startMinute;
+}
+
+// Check if a new lesson's time overlaps any lesson on the same day
+bool Schedule::hasConflict(LessonRef newLesson) const {
+  const LessonTable& table = getLessonTable();
+  int start = table.startMinute(newLesson);
+  if (start == LessonTable::NO_START) return false;
+  int day = table.dayIndex(newLesson);
+  int duration = table.durationMinutes(newLesson);
+
+  // A few word ANDs rule out most lessons; the bitmap only over-reports
+  // within one 5-minute slot, so a hit is confirmed on the intervals
+  if (day < WeekOccupancy::DAYS &&
+      !occupancy.hasConflict(day, start, duration)) {
+    return false;
+  }
+  return overlapsAny(day, start, start + duration, newLesson);
+}
+
+// Slots taken by the schedule's lessons over the week
+const WeekOccupancy& Schedule::getOccupancy() const { return occupancy; }
+
+// Every lesson whose time overlaps the new lesson, earliest first
+vector<LessonRef> Schedule::getConflicts(LessonRef newLesson) const {
+  const LessonTable& table = getLessonTable();
+  vector<LessonRef> conflicts;
+  int start = table.startMinute(newLesson);
+  if (start == LessonTable::NO_START) return conflicts;
+  collectOverlaps(table.dayIndex(newLesson), start,
+                  start + table.durationMinutes(newLesson), newLesson,
+                  conflicts);
+  return conflicts;
+}
+
+// Lessons on a day overlapping [start, end)
+vector<LessonRef> Schedule::getOverlapping(int dayIndex, int startMinute,
+                                           int endMinute) const {
+  vector<LessonRef> overlapping;
+  collectOverlaps(dayIndex, startMinute, endMinute, NO_LESSON, overlapping);
+  return overlapping;
 }
 
 // Print schedule in enhanced format with rich details
@@ -136,14 +307,15 @@ void Schedule::printSchedule() const {
   }
 
   // Calculate statistics
+  const LessonTable& table = getLessonTable();
   int totalCredits = getTotalCredits();
   int totalLessons = static_cast<int>(lessons.size());
   int totalWeeklyHours = 0;
   map<string, int> lessonTypeCounts;
 
-  for (const auto& lesson : lessons) {
-    totalWeeklyHours += lesson->getDuration();
-    lessonTypeCounts[lesson->getLessonType()]++;
+  for (LessonRef lesson : lessons) {
+    totalWeeklyHours += table.durationMinutes(lesson);
+    lessonTypeCounts[table.lessonType(lesson)]++;
   }
 
   int weeklyHours = totalWeeklyHours / 60;
@@ -170,9 +342,9 @@ void Schedule::printSchedule() const {
 
   // Find time range (dynamic based on actual lesson times)
   int startHour = 24, endHour = 0;
-  for (const auto& lesson : lessons) {
-    int lessonStart = stoi(lesson->getStartTime().substr(0, 2));
-    int duration = lesson->getDuration();
+  for (LessonRef lesson : lessons) {
+    int lessonStart = table.startMinute(lesson) / 60;
+    int duration = table.durationMinutes(lesson);
     int lessonEnd =
         lessonStart + (duration / 60) + ((duration % 60) > 0 ? 1 : 0);
 
@@ -185,13 +357,12 @@ void Schedule::printSchedule() const {
   endHour = min(23, endHour + 1);
 
   // Create grid: [hour][day] = lessons in that slot
-  map<int, map<string, vector<shared_ptr<Lesson>>>> grid;
+  map<int, map<string, vector<LessonView>>> grid;
 
   // Fill the grid
-  for (const auto& lesson : lessons) {
-    int lessonStartHour = stoi(lesson->getStartTime().substr(0, 2));
-    int lessonStartMin = stoi(lesson->getStartTime().substr(3, 2));
-    int duration = lesson->getDuration();
+  for (LessonRef lesson : lessons) {
+    int lessonStartHour = table.startMinute(lesson) / 60;
+    int duration = table.durationMinutes(lesson);
 
     // Calculate how many hour slots this lesson spans
     int slotsNeeded = (duration / 60) + ((duration % 60) > 0 ? 1 : 0);
@@ -200,7 +371,8 @@ void Schedule::printSchedule() const {
     for (int i = 0; i < slotsNeeded; i++) {
       int currentHour = lessonStartHour + i;
       if (currentHour >= startHour && currentHour <= endHour) {
-        grid[currentHour][lesson->getDay()].push_back(lesson);
+        grid[currentHour][table.dayName(lesson)].push_back(
+            table.view(lesson));
       }
     }
   }
@@ -212,8 +384,8 @@ void Schedule::printSchedule() const {
   int colorIndex = 0;
 
   set<int> uniqueCourses;
-  for (const auto& lesson : lessons) {
-    uniqueCourses.insert(lesson->getCourseId());
+  for (LessonRef lesson : lessons) {
+    uniqueCourses.insert(table.courseId(lesson));
   }
 
   for (int courseId : uniqueCourses) {
@@ -254,12 +426,12 @@ void Schedule::printSchedule() const {
         dayLines[dayIndex].push_back(vector<string>{""});
       } else if (grid[hour][day].size() == 1) {
         // Single lesson - show all details with word wrapping
-        auto lesson = grid[hour][day][0];
-        string courseColor = courseColors[lesson->getCourseId()];
+        const LessonView& lesson = grid[hour][day][0];
+        string courseColor = courseColors[lesson.getCourseId()];
 
         // Line 1: Course ID and Name with word wrapping
-        string courseId = to_string(lesson->getCourseId());
-        string courseName = Schedule::getCourseNameById(lesson->getCourseId());
+        string courseId = to_string(lesson.getCourseId());
+        string courseName = Schedule::getCourseNameById(lesson.getCourseId());
         string fullLine1 = courseId + " " + courseName;
 
         // Word wrap function for line 1
@@ -287,9 +459,9 @@ void Schedule::printSchedule() const {
 
         // Line 2: Type, Group and Room
         string lessonType =
-            lesson->getLessonType().substr(0, 3);  // Lec/Tut/Lab
-        string groupId = lesson->getGroupId();
-        string room = lesson->getClassroom();
+            lesson.getLessonType().substr(0, 3);  // Lec/Tut/Lab
+        string groupId = lesson.getGroupId();
+        string room = lesson.getClassroom();
         string fullLine2 = lessonType + " G:" + groupId + " " + room;
 
         vector<string> wrappedLine2;
@@ -311,8 +483,8 @@ void Schedule::printSchedule() const {
         }
 
         // Line 3: Teacher and Building
-        string teacher = lesson->getTeacher();
-        string building = lesson->getBuilding();
+        string teacher = lesson.getTeacher();
+        string building = lesson.getBuilding();
         string fullLine3 = teacher + " (" + building + ")";
 
         vector<string> wrappedLine3;
@@ -362,7 +534,7 @@ void Schedule::printSchedule() const {
         string courses = "";
         for (size_t i = 0; i < grid[hour][day].size() && i < 3; i++) {
           if (i > 0) courses += ", ";
-          courses += to_string(grid[hour][day][i]->getCourseId());
+          courses += to_string(grid[hour][day][i].getCourseId());
         }
         if (grid[hour][day].size() > 3) courses += ", more";
 
@@ -433,8 +605,8 @@ void Schedule::printSchedule() const {
           cout << setw(22) << " " << "|";
         } else if (grid[hour][day].size() == 1) {
           // Single lesson with color
-          auto lesson = grid[hour][day][0];
-          string courseColor = courseColors[lesson->getCourseId()];
+          const LessonView& lesson = grid[hour][day][0];
+          string courseColor = courseColors[lesson.getCourseId()];
           cout << courseColor << WHITE << BOLD << " " << setw(20) << left
                << content << " " << RESET << "|";
         } else {
@@ -473,18 +645,18 @@ void Schedule::printSchedule() const {
   cout << "\n" << BRIGHT_WHITE << BOLD << "COURSE COLORS:" << RESET << endl;
   set<int> displayedCourses;
   int legendCount = 0;
-  for (const auto& lesson : lessons) {
-    if (displayedCourses.find(lesson->getCourseId()) ==
-        displayedCourses.end()) {
-      string courseColor = courseColors[lesson->getCourseId()];
-      string courseName = Schedule::getCourseNameById(lesson->getCourseId());
+  for (LessonRef lesson : lessons) {
+    int lessonCourseId = table.courseId(lesson);
+    if (displayedCourses.find(lessonCourseId) == displayedCourses.end()) {
+      string courseColor = courseColors[lessonCourseId];
+      string courseName = Schedule::getCourseNameById(lessonCourseId);
 
       // Format the legend entry nicely
       cout << courseColor << WHITE << BOLD << " " << setw(6) << left
-           << lesson->getCourseId() << " " << RESET;
+           << lessonCourseId << " " << RESET;
       cout << courseName.substr(0, 20);  // Truncate long names
 
-      displayedCourses.insert(lesson->getCourseId());
+      displayedCourses.insert(lessonCourseId);
       legendCount++;
 
       if (legendCount % 2 == 0) {
@@ -507,10 +679,11 @@ void Schedule::printSchedule() const {
 }
 
 // Get lessons for specific day
-vector<shared_ptr<Lesson>> Schedule::getLessonsForDay(const string& day) const {
-  vector<shared_ptr<Lesson>> dayLessons;
-  for (const auto& lesson : lessons) {
-    if (lesson->getDay() == day) {
+vector<LessonRef> Schedule::getLessonsForDay(const string& day) const {
+  const LessonTable& table = getLessonTable();
+  vector<LessonRef> dayLessons;
+  for (LessonRef lesson : lessons) {
+    if (table.dayName(lesson) == day) {
       dayLessons.push_back(lesson);
     }
   }
@@ -518,7 +691,11 @@ vector<shared_ptr<Lesson>> Schedule::getLessonsForDay(const string& day) const {
 }
 
 // Clear all lessons
-void Schedule::clearSchedule() { lessons.clear(); }
+void Schedule::clearSchedule() {
+  lessons.clear();
+  dayIntervals.clear();
+  occupancy.reset();
+}
 
 // Get number of lessons
 int Schedule::getLessonCount() const {
@@ -532,12 +709,14 @@ void Schedule::saveToCSV(const string& filename) const {
     file << "ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,"
             "Building,Teacher,GroupID"
          << endl;
-    for (const auto& lesson : lessons) {
-      file << scheduleId << "," << lesson->getLessonType() << ","
-           << lesson->getCourseId() << "," << lesson->getDay() << ","
-           << lesson->getStartTime() << "," << lesson->getDuration() << ","
-           << lesson->getClassroom() << "," << lesson->getBuilding() << ","
-           << lesson->getTeacher() << "," << lesson->getGroupId() << endl;
+    const LessonTable& table = getLessonTable();
+    for (LessonRef ref : lessons) {
+      LessonView lesson = table.view(ref);
+      file << scheduleId << "," << lesson.getLessonType() << ","
+           << lesson.getCourseId() << "," << lesson.getDay() << ","
+           << lesson.getStartTime() << "," << lesson.getDuration() << ","
+           << lesson.getClassroom() << "," << lesson.getBuilding() << ","
+           << lesson.getTeacher() << "," << lesson.getGroupId() << endl;
     }
     file.close();
   }
@@ -545,54 +724,33 @@ void Schedule::saveToCSV(const string& filename) const {
 
 // Load schedule from CSV
 void Schedule::loadFromCSV(const string& filename) {
-  ifstream file(filename);
-  if (file.is_open()) {
-    string line;
-    getline(file, line);  // Skip header
-
-    while (getline(file, line)) {
-      if (line.empty()) continue;
-
-      stringstream ss(line);
-      string item;
-      vector<string> tokens;
-
-      while (getline(ss, item, ',')) {
-        tokens.push_back(item);
-      }
+  CsvReader reader(filename);
+  if (reader.isOpen()) {
+    reader.nextRow();  // Skip header
 
-      if (tokens.size() >= 10) {
+    while (reader.nextRow()) {
+      if (reader.fieldCount() >= 10) {
         try {
           // Parse with correct field order:
           // ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,GroupID
-          int schedId = stoi(tokens[0]);   // ScheduleID
-          string lessonType = tokens[1];   // LessonType
-          int courseId = stoi(tokens[2]);  // CourseID
-          string day = tokens[3];          // Day
-          string startTime = tokens[4];    // StartTime
-          int duration = stoi(tokens[5]);  // Duration
-          string classroom = tokens[6];    // Classroom
-          string building = tokens[7];     // Building
-          string teacher = tokens[8];      // Teacher
-          string groupId = tokens[9];      // GroupID
-
-          // Create appropriate lesson objects based on type
-          shared_ptr<Lesson> lesson;
-          if (lessonType == "Lecture") {
-            lesson =
-                make_shared<Lecture>(courseId, day, startTime, duration,
-                                     classroom, building, teacher, groupId);
-          } else if (lessonType == "Tutorial") {
-            lesson =
-                make_shared<Tutorial>(courseId, day, startTime, duration,
-                                      classroom, building, teacher, groupId);
-          } else if (lessonType == "Lab") {
-            lesson = make_shared<Lab>(courseId, day, startTime, duration,
-                                      classroom, building, teacher, groupId);
-          }
-
-          if (lesson && schedId == scheduleId) {
-            lessons.push_back(lesson);
+          int schedId = reader[0].toInt();           // ScheduleID
+          string lessonType = reader[1].str();       // LessonType
+          int courseId = reader[2].toInt();          // CourseID
+          string day = reader[3].str();              // Day
+          string startTime = reader[4].str();        // StartTime
+          int duration = reader[5].toInt();          // Duration
+          string classroom = reader[6].str();        // Classroom
+          string building = reader[7].str();         // Building
+          string teacher = reader[8].str();          // Teacher
+          string groupId = reader[9].str();          // GroupID
+
+          // Store the row in the shared table under its lesson type
+          LessonTable::Kind kind;
+          if (lessonTable && LessonTable::parseKind(lessonType, kind) &&
+              schedId == scheduleId) {
+            addLesson(lessonTable->add(courseId, kind, day, startTime,
+                                       duration, classroom, building, teacher,
+                                       groupId));
           }
         } catch (const exception&) {
           // Skip malformed lines
@@ -600,15 +758,15 @@ void Schedule::loadFromCSV(const string& filename) {
         }
       }
     }
-    file.close();
   }
 }
 
 // Get total credits for the schedule
 int Schedule::getTotalCredits() const {
   set<int> uniqueCourses;
-  for (const auto& lesson : lessons) {
-    uniqueCourses.insert(lesson->getCourseId());
+  const LessonTable& table = getLessonTable();
+  for (LessonRef lesson : lessons) {
+    uniqueCourses.insert(table.courseId(lesson));
   }
   // For now, assume each course is 3 credits (this would need to be calculated
   // properly with course data)
@@ -630,3 +788,10 @@ string Schedule::getCourseNameById(int courseId) {
   }
   return "Course " + to_string(courseId);  // Fallback if not found
 }
+
+void Schedule::setLessonTable(LessonTable* table) { lessonTable = table; }
+
+const LessonTable& Schedule::getLessonTable() {
+  static const LessonTable emptyTable;
+  return lessonTable ? *lessonTable : emptyTable;
+}
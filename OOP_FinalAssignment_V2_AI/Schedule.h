@@ -6,14 +6,34 @@
 #include <vector>
 
 #include "Course.h"
-#include "Lesson.h"
+#include "LessonTable.h"
+#include "WeekOccupancy.h"
 using namespace std;
 
 class Schedule {
  private:
+  // One timed lesson in the per-day overlap index
+  struct Interval {
+    uint16_t start;  // Minutes after midnight
+    uint16_t end;
+    uint16_t reach;  // Latest end of this and every earlier interval
+    LessonRef lesson;
+  };
+
   int scheduleId;
-  vector<shared_ptr<Lesson>> lessons;
+  vector<LessonRef> lessons;
+  vector<vector<Interval>> dayIntervals;   // By day index, sorted by start
+  WeekOccupancy occupancy;                 // Taken 5-minute slots
   static map<int, Course> courseDatabase;  // Static course lookup
+  static LessonTable* lessonTable;         // Rows behind the lesson refs
+
+  void indexLesson(LessonRef lesson);
+  void unindexLesson(LessonRef lesson);
+  static void updateReach(vector<Interval>& intervals, size_t from);
+  void collectOverlaps(int dayIndex, int startMinute, int endMinute,
+                       LessonRef exclude, vector<LessonRef>& found) const;
+  bool overlapsAny(int dayIndex, int startMinute, int endMinute,
+                   LessonRef exclude) const;
 
  public:
   // Constructor
@@ -25,30 +45,44 @@ class Schedule {
   // Assignment operator
   Schedule& operator=(const Schedule& other);
 
+  // Move constructor and assignment (schedules are moved when one is removed)
+  Schedule(Schedule&& other) noexcept;
+  Schedule& operator=(Schedule&& other) noexcept;
+
   // Destructor
   ~Schedule();
 
   // Getters
   int getScheduleId() const;
-  const vector<shared_ptr<Lesson>>& getLessons() const;
+  const vector<LessonRef>& getLessons() const;
 
   // Setters
   void setScheduleId(int id);
 
   // Add lesson to schedule
-  void addLesson(shared_ptr<Lesson> lesson);
+  void addLesson(LessonRef lesson);
 
   // Remove lesson from schedule by course and group
   bool removeLesson(int courseId, const string& groupId);
 
-  // Check if there's a conflict with new lesson
-  bool hasConflict(const Lesson& newLesson) const;
+  // Check if a new lesson's time overlaps any lesson on the same day
+  bool hasConflict(LessonRef newLesson) const;
+
+  // Slots taken by the schedule's lessons over the week
+  const WeekOccupancy& getOccupancy() const;
+
+  // Every lesson whose time overlaps the new lesson, earliest first
+  vector<LessonRef> getConflicts(LessonRef newLesson) const;
+
+  // Lessons on a day (LessonTable day index) overlapping [start, end)
+  vector<LessonRef> getOverlapping(int dayIndex, int startMinute,
+                                   int endMinute) const;
 
   // Print schedule in table format
   void printSchedule() const;
 
   // Get lessons for specific day
-  vector<shared_ptr<Lesson>> getLessonsForDay(const string& day) const;
+  vector<LessonRef> getLessonsForDay(const string& day) const;
 
   // Clear all lessons
   void clearSchedule();
@@ -68,6 +102,10 @@ class Schedule {
   // Static methods for course database
   static void setCourseDatabase(const vector<Course>& courses);
   static string getCourseNameById(int courseId);
+
+  // Static methods for the shared lesson table
+  static void setLessonTable(LessonTable* table);
+  static const LessonTable& getLessonTable();
 };
 
 #endif
@@ -0,0 +1,44 @@
+#include "ScheduleIndex.h"
+
+#include <algorithm>
+
+#include "Schedule.h"
+
+const size_t ScheduleIndex::NOT_FOUND;
+const uint32_t ScheduleIndex::EMPTY;
+
+ScheduleIndex::ScheduleIndex() : count(0) {}
+
+void ScheduleIndex::set(int scheduleId, size_t slot) {
+  if (scheduleId <= 0) return;
+  size_t id = static_cast<size_t>(scheduleId);
+  if (id >= slots.size()) {
+    // Double so IDs handed out one by one cost amortized O(1)
+    slots.resize(max(id + 1, slots.size() * 2), EMPTY);
+  }
+  if (slots[id] == EMPTY) count++;
+  slots[id] = static_cast<uint32_t>(slot);
+}
+
+void ScheduleIndex::erase(int scheduleId) {
+  if (find(scheduleId) == NOT_FOUND) return;
+  slots[scheduleId] = EMPTY;
+  count--;
+}
+
+void ScheduleIndex::rebuild(const vector<Schedule>& schedules) {
+  clear();
+  for (size_t slot = 0; slot < schedules.size(); slot++) {
+    set(schedules[slot].getScheduleId(), slot);
+  }
+}
+
+void ScheduleIndex::clear() {
+  slots.clear();
+  count = 0;
+}
+
+void ScheduleIndex::swap(ScheduleIndex& other) {
+  slots.swap(other.slots);
+  std::swap(count, other.count);
+}
@@ -0,0 +1,70 @@
+#ifndef SCHEDULE_INDEX_H
+#define SCHEDULE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class Schedule;
+
+/**
+ * @class ScheduleIndex
+ * @brief Schedule ID -> position in ScheduleManager's schedules vector
+ *
+ * Every command that names a schedule used to find_if over all of them.
+ * The ScheduleStore hands out small IDs and reuses freed ones first, so
+ * the live IDs stay dense and a flat array indexed by ID is both smaller
+ * and faster than a hash table: one bounds check and one load per lookup,
+ * 4 bytes per ID up to the highest one in use.
+ *
+ * The owner keeps it in sync: set() after appending a schedule, and on
+ * delete move the last schedule into the freed position, set() its new
+ * slot and erase() the deleted ID.
+ */
+class ScheduleIndex {
+ public:
+  /** @brief find() result for an ID with no schedule */
+  static const size_t NOT_FOUND = static_cast<size_t>(-1);
+
+  ScheduleIndex();
+
+  /** @return The slot of `scheduleId`, or NOT_FOUND */
+  size_t find(int scheduleId) const {
+    if (scheduleId <= 0 || static_cast<size_t>(scheduleId) >= slots.size()) {
+      return NOT_FOUND;
+    }
+    uint32_t slot = slots[scheduleId];
+    return slot == EMPTY ? NOT_FOUND : slot;
+  }
+
+  /** @brief Point `scheduleId` at `slot`; IDs must be positive */
+  void set(int scheduleId, size_t slot);
+
+  /** @brief Forget `scheduleId` */
+  void erase(int scheduleId);
+
+  /** @brief Index every schedule at its position in `schedules` */
+  void rebuild(const vector<Schedule>& schedules);
+
+  void clear();
+  void swap(ScheduleIndex& other);
+
+  /** @brief Number of indexed schedules */
+  size_t size() const { return count; }
+
+  /** @brief One past the highest ID the index has room for */
+  int idLimit() const { return static_cast<int>(slots.size()); }
+
+  /** @brief Bytes held by the slot array */
+  size_t memoryBytes() const { return slots.capacity() * sizeof(uint32_t); }
+
+ private:
+  static const uint32_t EMPTY = 0xFFFFFFFF;
+
+  vector<uint32_t> slots;  // Indexed by schedule ID
+  size_t count;
+};
+
+#endif  // SCHEDULE_INDEX_H
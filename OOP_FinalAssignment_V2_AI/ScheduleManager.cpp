@@ -1,6 +1,7 @@
 #include "ScheduleManager.h"
 
 #include <cmath>
+#include <cstdio>
 
 // Modern Color Scheme Implementation
 const string ScheduleManager::RESET = "\033[0m";
@@ -41,14 +42,14 @@ const string ScheduleManager::BG_WHITE = "\033[47m";
 const string ScheduleManager::BG_GRAY = "\033[100m";
 
 ScheduleManager::ScheduleManager() {
-  loadCourses();
-  loadLessons();
+  Schedule::setLessonTable(&lessonTable);
+  loadCatalog();
   loadSchedules();
-  loadScheduleData();
 
   // Initialize analytics engine with data references and callback functions
   analytics.setDataReferences(
-      courses, schedules, courseLessons,
+      courses, schedules, lessonTable, courseLessons, lessonIndex,
+      compatibility,
       [this](int schedId, int courseId, const string& groupId) -> bool {
         return addLessonToSchedule(schedId, courseId, groupId);
       },
@@ -61,243 +62,358 @@ ScheduleManager::ScheduleManager() {
       });
 }
 
-void ScheduleManager::loadCourses() {
-  ifstream file("data/courses.csv");
-  if (!file.is_open()) {
-    cout << RED << "Error: Cannot open courses.csv file." << RESET << endl;
+void ScheduleManager::loadCatalog() {
+  if (CatalogSnapshot::load(dataDirectory, courses, lessonTable,
+                            courseLessons)) {
+    cout << GREEN << "Loaded " << courses.size()
+         << " courses from catalog snapshot." << RESET << endl;
+    Schedule::setCourseDatabase(courses);
+    buildCatalogIndexes();
     return;
   }
 
-  string line;
-  getline(file, line);  // Skip header
+  loadCourses();
+  loadLessons();
+  buildCatalogIndexes();
 
-  while (getline(file, line)) {
-    stringstream ss(line);
-    string item;
-    vector<string> tokens;
+  if (!courses.empty() &&
+      !CatalogSnapshot::save(dataDirectory, courses, lessonTable,
+                             courseLessons)) {
+    cout << YELLOW << "[WARN] Could not write catalog snapshot." << RESET
+         << endl;
+  }
+}
 
-    while (getline(ss, item, ',')) {
-      tokens.push_back(item);
-    }
+void ScheduleManager::buildCatalogIndexes() {
+  lessonIndex.build(lessonTable, courseLessons);
+  // Before any schedule is loaded the table holds only catalog rows
+  compatibility.build(lessonTable);
+  analytics.catalogChanged();
+}
+
+void ScheduleManager::loadCourses() {
+  CsvReader reader(dataDirectory + "courses.csv");
+  if (!reader.isOpen()) {
+    cout << RED << "Error: Cannot open courses.csv file." << RESET << endl;
+    return;
+  }
+
+  reader.nextRow();  // Skip header
 
-    if (tokens.size() >= 10) {
-      int courseId = stoi(tokens[0]);
-      string courseName = tokens[1];
+  while (reader.nextRow()) {
+    if (reader.fieldCount() >= 10) {
+      int courseId = reader[0].toInt();
+      string courseName = reader[1].str();
       // Combine exam dates
-      string examDateA = tokens[2] + "/" + tokens[3] + "/" + tokens[4];
-      string examDateB = tokens[5] + "/" + tokens[6] + "/" + tokens[7];
+      string examDateA =
+          reader[2].str() + "/" + reader[3].str() + "/" + reader[4].str();
+      string examDateB =
+          reader[5].str() + "/" + reader[6].str() + "/" + reader[7].str();
       double credits =
-          stod(tokens[8]);  // Keep as double to preserve decimal precision
-      string lecturer = tokens[9];
+          reader[8].toDouble();  // Keep as double to preserve decimal precision
+      string lecturer = reader[9].str();
       courses.emplace_back(courseId, courseName, credits, examDateA, examDateB,
                            lecturer);
     }
   }
-  file.close();
   cout << GREEN << "Loaded " << courses.size() << " courses." << RESET << endl;
 
   // Populate Schedule's course database for name lookups
   Schedule::setCourseDatabase(courses);
 }
 
-void ScheduleManager::loadLessonsFromFile(const string& filename,
-                                          const string& type) {
-  ifstream file(filename);
-  if (!file.is_open()) {
+void ScheduleManager::readLessonFile(const string& filename,
+                                     const string& type, LessonTable& lessons) {
+  LessonTable::Kind kind;
+  if (type == "lectures") {
+    kind = LessonTable::LECTURE;
+  } else if (type == "tutorials") {
+    kind = LessonTable::TUTORIAL;
+  } else if (type == "labs") {
+    kind = LessonTable::LAB;
+  } else {
     return;
   }
 
-  string line;
-  getline(file, line);  // Skip header
+  CsvReader reader(filename);
+  if (!reader.isOpen()) {
+    return;
+  }
 
-  while (getline(file, line)) {
-    stringstream ss(line);
-    string item;
-    vector<string> tokens;
+  reader.nextRow();  // Skip header
 
-    while (getline(ss, item, ',')) {
-      tokens.push_back(item);
-    }
-
-    if (tokens.size() >= 8) {
-      int courseId = stoi(tokens[0]);
-      string day = tokens[1];
-      string startTime = tokens[2];
-      int durationHours = stoi(tokens[3]);  // Duration in hours from CSV
+  while (reader.nextRow()) {
+    if (reader.fieldCount() >= 8) {
+      int courseId = reader[0].toInt();
+      Symbol day = reader[1].symbol();
+      string startTime = reader[2].str();
+      int durationHours = reader[3].toInt();  // Duration in hours from CSV
       int duration = durationHours * 60;  // Convert to minutes for internal use
-      string classroom = tokens[4];
-      string building = tokens[5];
-      string teacher = tokens[6];
-      string groupId = tokens[7];
-
-      shared_ptr<Lesson> lesson;
-      if (type == "lectures") {
-        lesson = make_shared<Lecture>(courseId, day, startTime, duration,
-                                      classroom, building, teacher, groupId);
-      } else if (type == "tutorials") {
-        lesson = make_shared<Tutorial>(courseId, day, startTime, duration,
-                                       classroom, building, teacher, groupId);
-      } else if (type == "labs") {
-        lesson = make_shared<Lab>(courseId, day, startTime, duration, classroom,
-                                  building, teacher, groupId);
-      }
+      Symbol classroom = reader[4].symbol();
+      Symbol building = reader[5].symbol();
+      Symbol teacher = reader[6].symbol();
+      string groupId = reader[7].str();
 
-      if (lesson) {
-        courseLessons[courseId].push_back(lesson);
-      }
+      lessons.add(courseId, kind, day, startTime, duration, classroom,
+                  building, teacher, groupId);
     }
   }
-  file.close();
 }
 
-void ScheduleManager::loadLessons() {
-  for (const auto& course : courses) {
-    int courseId = course.getCourseId();
-    string basePath = "data/" + to_string(courseId) + "_";
-
-    loadLessonsFromFile(basePath + "lectures.csv", "lectures");
-    loadLessonsFromFile(basePath + "tutorials.csv", "tutorials");
-    loadLessonsFromFile(basePath + "labs.csv", "labs");
+void ScheduleManager::mergeLessons(const LessonTable& lessons) {
+  LessonRef first = lessonTable.append(lessons);
+
+  // Rows are filed under the course ID they carry, not the file they came
+  // from; consecutive rows nearly always share one, so cache the map slot
+  vector<LessonRef>* slot = nullptr;
+  int slotCourseId = 0;
+  for (LessonRef lesson = first; lesson < lessonTable.size(); lesson++) {
+    if (!slot || lessonTable.courseId(lesson) != slotCourseId) {
+      slotCourseId = lessonTable.courseId(lesson);
+      slot = &courseLessons[slotCourseId];
+    }
+    slot->push_back(lesson);
   }
-  cout << GREEN << "Loaded lessons for courses." << RESET << endl;
 }
 
-void ScheduleManager::loadSchedules() {
-  ifstream file("data/schedules.csv");
-  if (!file.is_open()) {
-    cout << YELLOW << "No existing schedules found. Starting fresh." << RESET
-         << endl;
-    return;
+LessonRef ScheduleManager::internScheduleLesson(const LessonTable& lessons,
+                                                LessonRef row) {
+  // Saved schedules normally hold unchanged copies of catalog lessons
+  uint16_t groupCode = 0;
+  LessonRef lesson = 0;
+  if (lessonTable.findGroupCode(lessons.groupId(row), groupCode) &&
+      lessonIndex.find(lessons.courseId(row), groupCode, lesson) &&
+      lessonTable.sameLesson(lesson, lessons, row)) {
+    return lesson;
   }
+  return lessonTable.copyRow(lessons, row);
+}
 
-  string line;
-  getline(file, line);  // Skip header
+void ScheduleManager::forEachLoadTask(size_t count,
+                                      const function<void(size_t)>& task) {
+  if (parallelLoading) {
+    loadPool.parallelFor(count, task);
+  } else {
+    for (size_t i = 0; i < count; i++) task(i);
+  }
+}
 
-  while (getline(file, line)) {
-    stringstream ss(line);
-    string item;
-    getline(ss, item, ',');
+void ScheduleManager::loadLessonsFromFile(const string& filename,
+                                          const string& type) {
+  LessonTable lessons;
+  readLessonFile(filename, type, lessons);
+  mergeLessons(lessons);
+}
 
-    if (!item.empty()) {
-      int scheduleId = stoi(item);
-      schedules.emplace_back(scheduleId);
-    }
+void ScheduleManager::loadLessons() {
+  // Each course's files are parsed into that course's own slot, then merged
+  // in catalog order so the result is identical to a sequential load
+  vector<LessonTable> parsed(courses.size());
+  forEachLoadTask(courses.size(), [this, &parsed](size_t index) {
+    string basePath =
+        dataDirectory + to_string(courses[index].getCourseId()) + "_";
+    readLessonFile(basePath + "lectures.csv", "lectures", parsed[index]);
+    readLessonFile(basePath + "tutorials.csv", "tutorials", parsed[index]);
+    readLessonFile(basePath + "labs.csv", "labs", parsed[index]);
+  });
+
+  for (const LessonTable& lessons : parsed) {
+    mergeLessons(lessons);
   }
-  file.close();
+  cout << GREEN << "Loaded lessons for courses." << RESET << endl;
 }
 
-void ScheduleManager::saveSchedules() {
-  ofstream file("data/schedules.csv");
-  if (file.is_open()) {
-    file << "schedule_id" << endl;
-    for (const auto& schedule : schedules) {
-      file << schedule.getScheduleId() << endl;
+void ScheduleManager::loadSchedules() {
+  string storePath = dataDirectory + ScheduleStore::FILE_NAME;
+  if (ScheduleStore::recover(storePath)) {
+    cout << YELLOW << "[WARN] Restored " << storePath
+         << " from an interrupted compaction" << RESET << endl;
+  }
+  ScheduleStore::Contents contents;
+  if (ScheduleStore::read(storePath, contents)) {
+    for (const string& line : contents.badLines) {
+      cout << YELLOW << "[WARN] Error parsing schedule record: " << line
+           << RESET << endl;
     }
-    file.close();
+    loadScheduleData(contents);
+    scheduleStore.attach(storePath, contents);
+    return;
   }
-}
 
-void ScheduleManager::loadScheduleData() {
-  // Load lesson data for each existing schedule
-  for (auto& schedule : schedules) {
-    string scheduleFilename =
-        "data/schedule_" + to_string(schedule.getScheduleId()) + ".csv";
-    ifstream scheduleFile(scheduleFilename);
+  if (importLegacySchedules()) return;
 
-    if (scheduleFile.is_open()) {
-      string line;
-      getline(scheduleFile, line);  // Skip header
-
-      while (getline(scheduleFile, line)) {
-        if (line.empty()) continue;
-
-        stringstream ss(line);
-        vector<string> tokens;
-        string token;
+  scheduleStore.attach(storePath, contents);
+  cout << YELLOW << "No existing schedules found. Starting fresh." << RESET
+       << endl;
+}
 
-        // Parse CSV line into tokens
-        while (getline(ss, token, ',')) {
-          tokens.push_back(token);
+void ScheduleManager::readScheduleFile(
+    const string& filename, const LessonTable& table,
+    const CourseLessonIndex& catalog, ScheduleFileData& data) {
+  CsvReader reader(filename);
+  data.opened = reader.isOpen();
+  if (!data.opened) return;
+
+  reader.nextRow();  // Skip header
+
+  while (reader.nextRow()) {
+    // Check if we have enough fields for the new format
+    if (reader.fieldCount() >= 10) {
+      // New comprehensive format:
+      // ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,GroupID
+      try {
+        string lessonType = reader[1].str();
+        int courseId = reader[2].toInt();
+        Symbol day = reader[3].symbol();
+        string startTime = reader[4].str();
+        int durationHours = reader[5].toInt();  // Duration in hours from CSV
+        int duration =
+            durationHours * 60;  // Convert to minutes for internal use
+        Symbol classroom = reader[6].symbol();
+        Symbol building = reader[7].symbol();
+        Symbol teacher = reader[8].symbol();
+        string groupId = reader[9].str();
+
+        // Add lesson to schedule (ignore ScheduleID column, use filename
+        // instead)
+        LessonTable::Kind kind;
+        if (LessonTable::parseKind(lessonType, kind)) {
+          data.lessons.add(courseId, kind, day, startTime, duration,
+                           classroom, building, teacher, groupId);
         }
 
-        // Check if we have enough tokens for the new format
-        if (tokens.size() >= 10) {
-          // New comprehensive format:
-          // ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,GroupID
-          try {
-            int scheduleId = stoi(tokens[0]);
-            string lessonType = tokens[1];
-            int courseId = stoi(tokens[2]);
-            string day = tokens[3];
-            string startTime = tokens[4];
-            int durationHours = stoi(tokens[5]);  // Duration in hours from CSV
-            int duration =
-                durationHours * 60;  // Convert to minutes for internal use
-            string classroom = tokens[6];
-            string building = tokens[7];
-            string teacher = tokens[8];
-            string groupId = tokens[9];
-
-            // Create the appropriate lesson object
-            shared_ptr<Lesson> lesson;
-            if (lessonType == "Lecture") {
-              lesson =
-                  make_shared<Lecture>(courseId, day, startTime, duration,
-                                       classroom, building, teacher, groupId);
-            } else if (lessonType == "Tutorial") {
-              lesson =
-                  make_shared<Tutorial>(courseId, day, startTime, duration,
-                                        classroom, building, teacher, groupId);
-            } else if (lessonType == "Lab") {
-              lesson = make_shared<Lab>(courseId, day, startTime, duration,
-                                        classroom, building, teacher, groupId);
-            }
-
-            // Add lesson to schedule (ignore ScheduleID column, use filename
-            // instead)
-            if (lesson) {
-              schedule.addLesson(lesson);
-            }
-
-          } catch (const std::exception&) {
-            cout << YELLOW << "[WARN] Error parsing schedule line: " << line
-                 << RESET << endl;
-          }
-        } else if (tokens.size() >= 2) {
-          // Old simple format: course_id,group_id (fallback compatibility)
-          try {
-            int courseId = stoi(tokens[0]);
-            string groupId = tokens[1];
-
-            if (courseLessons.find(courseId) != courseLessons.end()) {
-              auto lessonIt =
-                  find_if(courseLessons[courseId].begin(),
-                          courseLessons[courseId].end(),
-                          [groupId](const shared_ptr<Lesson>& lesson) {
-                            return lesson->getGroupId() == groupId;
-                          });
-
-              if (lessonIt != courseLessons[courseId].end()) {
-                schedule.addLesson(*lessonIt);
-              }
-            }
-          } catch (const std::exception&) {
-            cout << YELLOW << "[WARN] Error parsing schedule line: " << line
-                 << RESET << endl;
-          }
+      } catch (const std::exception&) {
+        data.badLines.push_back(reader.row().str());
+      }
+    } else if (reader.fieldCount() >= 2) {
+      // Old simple format: course_id,group_id (fallback compatibility)
+      try {
+        int courseId = reader[0].toInt();
+        string groupId = reader[1].str();
+
+        uint16_t groupCode = 0;
+        LessonRef lesson = 0;
+        if (table.findGroupCode(groupId, groupCode) &&
+            catalog.find(courseId, groupCode, lesson)) {
+          data.lessons.copyRow(table, lesson);
         }
+      } catch (const std::exception&) {
+        data.badLines.push_back(reader.row().str());
       }
-      scheduleFile.close();
+    }
+  }
+}
 
-      cout << GREEN << "  [OK] Loaded " << schedule.getLessons().size()
-           << " lessons for Schedule " << schedule.getScheduleId() << RESET
-           << endl;
+void ScheduleManager::loadScheduleData(
+    const ScheduleStore::Contents& contents) {
+  schedules.clear();
+  schedules.reserve(contents.scheduleIds.size());
+  for (size_t i = 0; i < contents.scheduleIds.size(); i++) {
+    schedules.emplace_back(contents.scheduleIds[i]);
+    Schedule& schedule = schedules.back();
+    for (LessonRef row : contents.scheduleLessons[i]) {
+      schedule.addLesson(internScheduleLesson(contents.lessons, row));
     }
+
+    cout << GREEN << "  [OK] Loaded " << schedule.getLessons().size()
+         << " lessons for Schedule " << schedule.getScheduleId() << RESET
+         << endl;
   }
+  scheduleIndex.rebuild(schedules);
   cout << GREEN << "Loaded schedule data for existing schedules." << RESET
        << endl;
 }
 
+bool ScheduleManager::importLegacySchedules() {
+  CsvReader reader(dataDirectory + "schedules.csv");
+  if (!reader.isOpen()) return false;
+
+  vector<int> scheduleIds;
+  reader.nextRow();  // Skip header
+  while (reader.nextRow()) {
+    if (!reader[0].empty()) {
+      try {
+        scheduleIds.push_back(reader[0].toInt());
+      } catch (const std::exception&) {
+        cout << YELLOW << "[WARN] Error parsing schedule ID: "
+             << reader.row().str() << RESET << endl;
+      }
+    }
+  }
+  reader.close();
+
+  // Parse every schedule file into its own slot; the catalog is only read
+  vector<ScheduleFileData> parsed(scheduleIds.size());
+  forEachLoadTask(scheduleIds.size(), [this, &scheduleIds,
+                                       &parsed](size_t index) {
+    string scheduleFilename = dataDirectory + "schedule_" +
+                              to_string(scheduleIds[index]) + ".csv";
+    readScheduleFile(scheduleFilename, lessonTable, lessonIndex,
+                     parsed[index]);
+  });
+
+  // Merge and record in schedule order
+  scheduleStore.attach(dataDirectory + ScheduleStore::FILE_NAME,
+                       ScheduleStore::Contents());
+  schedules.clear();
+  for (size_t i = 0; i < scheduleIds.size(); i++) {
+    if (scheduleStore.createSchedule(scheduleIds[i]) == -1) {
+      bool listedTwice = scheduleStore.contains(scheduleIds[i]);
+      cout << YELLOW << "[WARN] Skipped schedule " << scheduleIds[i] << ": "
+           << (listedTwice ? "listed twice"
+                           : "ID outside 1.." +
+                                 to_string(ScheduleStore::MAX_SCHEDULE_ID))
+           << RESET << endl;
+      continue;
+    }
+    schedules.emplace_back(scheduleIds[i]);
+    Schedule& schedule = schedules.back();
+    const ScheduleFileData& data = parsed[i];
+
+    for (const string& line : data.badLines) {
+      cout << YELLOW << "[WARN] Error parsing schedule line: " << line << RESET
+           << endl;
+    }
+    for (LessonRef row = 0; row < data.lessons.size(); row++) {
+      LessonRef lesson = internScheduleLesson(data.lessons, row);
+      schedule.addLesson(lesson);
+      scheduleStore.recordAdd(schedule.getScheduleId(),
+                              lessonTable.view(lesson));
+    }
+
+    cout << GREEN << "  [OK] Loaded " << schedule.getLessons().size()
+         << " lessons for Schedule " << schedule.getScheduleId() << RESET
+         << endl;
+  }
+  scheduleIndex.rebuild(schedules);
+
+  // Once the store is on disk, retire the old files so that losing the
+  // store can never bring them back. schedules.csv goes first: without it
+  // nothing is imported. Files of skipped schedules keep their names.
+  size_t failedWrites = persistence.stats().failedWrites;
+  persistence.flush();
+  if (persistence.stats().failedWrites != failedWrites) {
+    cout << YELLOW << "[WARN] Could not write " << dataDirectory
+         << ScheduleStore::FILE_NAME << "; the old schedule files were kept"
+         << RESET << endl;
+    return true;
+  }
+  retireLegacyFile(dataDirectory + "schedules.csv");
+  for (const Schedule& schedule : schedules) {
+    retireLegacyFile(dataDirectory + "schedule_" +
+                     to_string(schedule.getScheduleId()) + ".csv");
+  }
+  cout << GREEN << "[OK] Moved " << schedules.size() << " schedules into "
+       << dataDirectory << ScheduleStore::FILE_NAME << RESET << endl;
+  return true;
+}
+
+void ScheduleManager::retireLegacyFile(const string& path) {
+  string retiredPath = path + ".imported";
+  remove(retiredPath.c_str());  // rename() will not replace it on Windows
+  if (rename(path.c_str(), retiredPath.c_str()) != 0) remove(path.c_str());
+}
+
 void ScheduleManager::printCourse(int courseId) {
   auto it =
       find_if(courses.begin(), courses.end(), [courseId](const Course& course) {
@@ -335,27 +451,28 @@ void ScheduleManager::printCourse(int courseId) {
 
     if (courseLessons.find(courseId) != courseLessons.end()) {
       // Calculate lesson statistics
-      map<string, vector<shared_ptr<Lesson>>> lessonsByType;
+      map<string, vector<LessonView>> lessonsByType;
       int totalWeeklyHours = 0;
       map<string, int> dayCount;
 
       // Track if we've already counted one lesson of each type for weekly hours
       bool hasLecture = false, hasTutorial = false, hasLab = false;
 
-      for (const auto& lesson : courseLessons[courseId]) {
-        lessonsByType[lesson->getLessonType()].push_back(lesson);
-        dayCount[lesson->getDay()]++;
+      for (LessonRef ref : courseLessons[courseId]) {
+        LessonView lesson = lessonTable.view(ref);
+        lessonsByType[lesson.getLessonType()].push_back(lesson);
+        dayCount[lesson.getDay()]++;
 
         // Only count one lesson of each type for weekly hours calculation
-        string lessonType = lesson->getLessonType();
-        if (lessonType == "Lecture" && !hasLecture) {
-          totalWeeklyHours += lesson->getDuration();
+        LessonTable::Kind kind = lesson.getKind();
+        if (kind == LessonTable::LECTURE && !hasLecture) {
+          totalWeeklyHours += lesson.getDuration();
           hasLecture = true;
-        } else if (lessonType == "Tutorial" && !hasTutorial) {
-          totalWeeklyHours += lesson->getDuration();
+        } else if (kind == LessonTable::TUTORIAL && !hasTutorial) {
+          totalWeeklyHours += lesson.getDuration();
           hasTutorial = true;
-        } else if (lessonType == "Lab" && !hasLab) {
-          totalWeeklyHours += lesson->getDuration();
+        } else if (kind == LessonTable::LAB && !hasLab) {
+          totalWeeklyHours += lesson.getDuration();
           hasLab = true;
         }
       }
@@ -385,19 +502,19 @@ void ScheduleManager::printCourse(int courseId) {
              << lessonType << " Sessions (" << lessons.size()
              << " groups):" << RESET << endl;
 
-        for (const auto& lesson : lessons) {
+        for (const LessonView& lesson : lessons) {
           string endTime =
-              calculateEndTime(lesson->getStartTime(), lesson->getDuration());
-          int hours = lesson->getDuration() / 60;
-          int mins = lesson->getDuration() % 60;
+              calculateEndTime(lesson.getStartTime(), lesson.getDuration());
+          int hours = lesson.getDuration() / 60;
+          int mins = lesson.getDuration() % 60;
 
-          cout << "    " << BRIGHT_WHITE << "Group " << lesson->getGroupId()
-               << RESET << " | " << CYAN << lesson->getDay() << RESET << " | "
-               << BRIGHT_BLUE << lesson->getStartTime() << "-" << endTime
+          cout << "    " << BRIGHT_WHITE << "Group " << lesson.getGroupId()
+               << RESET << " | " << CYAN << lesson.getDay() << RESET << " | "
+               << BRIGHT_BLUE << lesson.getStartTime() << "-" << endTime
                << RESET << " | " << BRIGHT_YELLOW << hours << "h " << mins
-               << "m" << RESET << " | " << GRAY << lesson->getBuilding() << " "
-               << lesson->getClassroom() << RESET << " | " << DIM
-               << "Instructor: " << lesson->getTeacher() << RESET << endl;
+               << "m" << RESET << " | " << GRAY << lesson.getBuilding() << " "
+               << lesson.getClassroom() << RESET << " | " << DIM
+               << "Instructor: " << lesson.getTeacher() << RESET << endl;
         }
       }
 
@@ -490,26 +607,26 @@ void ScheduleManager::printNext10Courses() {
     bool hasLecture = false, hasTutorial = false, hasLab = false;
 
     if (courseLessons.find(courseId) != courseLessons.end()) {
-      for (const auto& lesson : courseLessons[courseId]) {
+      for (LessonRef lesson : courseLessons[courseId]) {
         totalLessons++;
 
-        string lessonType = lesson->getLessonType();
-        if (lessonType == "Lecture") {
+        LessonTable::Kind kind = lessonTable.kind(lesson);
+        if (kind == LessonTable::LECTURE) {
           lectureCount++;
           if (!hasLecture) {
-            totalWeeklyHours += lesson->getDuration();
+            totalWeeklyHours += lessonTable.durationMinutes(lesson);
             hasLecture = true;
           }
-        } else if (lessonType == "Tutorial") {
+        } else if (kind == LessonTable::TUTORIAL) {
           tutorialCount++;
           if (!hasTutorial) {
-            totalWeeklyHours += lesson->getDuration();
+            totalWeeklyHours += lessonTable.durationMinutes(lesson);
             hasTutorial = true;
           }
-        } else if (lessonType == "Lab") {
+        } else if (kind == LessonTable::LAB) {
           labCount++;
           if (!hasLab) {
-            totalWeeklyHours += lesson->getDuration();
+            totalWeeklyHours += lessonTable.durationMinutes(lesson);
             hasLab = true;
           }
         }
@@ -578,13 +695,10 @@ void ScheduleManager::printNext10Courses() {
 }
 
 void ScheduleManager::printSchedule(int scheduleId) {
-  auto it = find_if(schedules.begin(), schedules.end(),
-                    [scheduleId](const Schedule& schedule) {
-                      return schedule.getScheduleId() == scheduleId;
-                    });
+  Schedule* schedule = getScheduleById(scheduleId);
 
-  if (it != schedules.end()) {
-    it->printSchedule();
+  if (schedule) {
+    schedule->printSchedule();
   } else {
     cout << RED << "[ERROR] Schedule with ID " << scheduleId << " not found."
          << RESET << endl;
@@ -618,9 +732,13 @@ void ScheduleManager::printSchedules() {
           "==========="
        << RESET << endl;
 
-  for (size_t i = 0; i < schedules.size(); i++) {
-    const auto& schedule = schedules[i];
-    int scheduleId = schedule.getScheduleId();
+  // schedules is unordered; walk the index to list them by ID
+  size_t i = 0;
+  for (int scheduleId = 1; scheduleId < scheduleIndex.idLimit();
+       scheduleId++) {
+    size_t slot = scheduleIndex.find(scheduleId);
+    if (slot == ScheduleIndex::NOT_FOUND) continue;
+    const auto& schedule = schedules[slot];
     const auto& lessons = schedule.getLessons();
 
     // Calculate detailed statistics
@@ -630,16 +748,16 @@ void ScheduleManager::printSchedules() {
     int totalWeeklyHours = 0;
     map<string, int> dayDistribution;
 
-    for (const auto& lesson : lessons) {
-      totalWeeklyHours += lesson->getDuration();
-      dayDistribution[lesson->getDay()]++;
+    for (LessonRef lesson : lessons) {
+      totalWeeklyHours += lessonTable.durationMinutes(lesson);
+      dayDistribution[lessonTable.dayName(lesson)]++;
 
-      string lessonType = lesson->getLessonType();
-      if (lessonType == "Lecture")
+      LessonTable::Kind kind = lessonTable.kind(lesson);
+      if (kind == LessonTable::LECTURE)
         lectureCount++;
-      else if (lessonType == "Tutorial")
+      else if (kind == LessonTable::TUTORIAL)
         tutorialCount++;
-      else if (lessonType == "Lab")
+      else if (kind == LessonTable::LAB)
         labCount++;
     }
 
@@ -687,6 +805,7 @@ void ScheduleManager::printSchedules() {
     if (i < schedules.size() - 1 && schedules.size() > 1) {
       cout << GRAY << "      " << string(75, '-') << RESET << endl;
     }
+    i++;
   }
 
   cout << "\n"
@@ -700,157 +819,61 @@ void ScheduleManager::printSchedules() {
 }
 
 int ScheduleManager::addSchedule(int specificId) {
-  int newId;
-  if (specificId != -1) {
-    // Check if this ID already exists
-    auto it = find_if(schedules.begin(), schedules.end(),
-                      [specificId](const Schedule& schedule) {
-                        return schedule.getScheduleId() == specificId;
-                      });
-
-    if (it != schedules.end()) {
-      cout << RED << "[ERROR] Schedule with ID " << specificId
-           << " already exists." << RESET << endl;
-      return -1;
-    }
-    newId = specificId;
-  } else {
-    newId = schedules.empty() ? 1 : schedules.back().getScheduleId() + 1;
+  if (specificId != -1 && scheduleStore.contains(specificId)) {
+    cout << RED << "[ERROR] Schedule with ID " << specificId
+         << " already exists." << RESET << endl;
+    return -1;
   }
 
-  schedules.emplace_back(newId);
-  saveSchedules();
-
-  // Create empty schedule CSV file with comprehensive header
-  string scheduleFilename = "data/schedule_" + to_string(newId) + ".csv";
-  ofstream scheduleFile(scheduleFilename);
-  if (scheduleFile.is_open()) {
-    scheduleFile << "ScheduleID,LessonType,CourseID,Day,StartTime,Duration,"
-                    "Classroom,Building,Teacher,GroupID"
-                 << endl;
-    scheduleFile.close();
+  // Deleted IDs are reused before new ones are handed out
+  int newId = scheduleStore.createSchedule(specificId);
+  if (newId == -1) {
+    cout << RED << "[ERROR] Could not create schedule " << specificId << "."
+         << RESET << endl;
+    return -1;
   }
 
+  schedules.emplace_back(newId);
+  scheduleIndex.set(newId, schedules.size() - 1);
+
   cout << BRIGHT_GREEN << "[OK] Created new schedule with ID: " << BOLD << newId
        << RESET << endl;
   return newId;
 }
 
 void ScheduleManager::removeSchedule(int scheduleId) {
-  // First, check if the schedule exists in memory
-  auto it = find_if(schedules.begin(), schedules.end(),
-                    [scheduleId](const Schedule& schedule) {
-                      return schedule.getScheduleId() == scheduleId;
-                    });
-
-  if (it == schedules.end()) {
+  size_t slot = scheduleIndex.find(scheduleId);
+  if (slot == ScheduleIndex::NOT_FOUND) {
     cout << RED << "[ERROR] Schedule with ID " << scheduleId << " not found."
          << RESET << endl;
     return;
   }
 
-  // Step 1: Remove from memory
-  schedules.erase(it);
-
-  // Step 2: Find all existing schedule files on disk by scanning directory
-  vector<int> actualFileIds;
-
-  // Check for schedule files from 1 to 20 (reasonable upper limit)
-  for (int i = 1; i <= 20; i++) {
-    string filename = "data/schedule_" + to_string(i) + ".csv";
-    ifstream file(filename);
-    if (file.good()) {
-      actualFileIds.push_back(i);
-    }
-    file.close();
-  }
-
-  // Sort the IDs to ensure proper ordering
-  sort(actualFileIds.begin(), actualFileIds.end());
-
-  // Step 3: Delete the target schedule file
-  string scheduleFileToDelete =
-      "data/schedule_" + to_string(scheduleId) + ".csv";
-  remove(scheduleFileToDelete.c_str());
-
-  // Step 4: Renumber all files that come after the deleted one
-  // First, create a list of files that need to be renamed
-  vector<int> filesToProcess;
-  for (int id : actualFileIds) {
-    if (id > scheduleId) {
-      filesToProcess.push_back(id);
-    }
-  }
-
-  // Sort in ascending order for proper renaming
-  sort(filesToProcess.begin(), filesToProcess.end());
-
-  // Rename files one by one from lowest to highest
-  for (int id : filesToProcess) {
-    string oldName = "data/schedule_" + to_string(id) + ".csv";
-    string newName = "data/schedule_" + to_string(id - 1) + ".csv";
-
-    if (rename(oldName.c_str(), newName.c_str()) != 0) {
-      cout << YELLOW << "[WARN] Warning: Could not rename " << oldName << " to "
-           << newName << RESET << endl;
-    }
+  // Move the last schedule into the hole instead of shifting the rest
+  if (slot != schedules.size() - 1) {
+    schedules[slot] = move(schedules.back());
+    scheduleIndex.set(schedules[slot].getScheduleId(), slot);
   }
+  schedules.pop_back();
+  scheduleIndex.erase(scheduleId);
 
-  // Step 5: Renumber schedules in memory
-  for (int i = 0; i < static_cast<int>(schedules.size()); i++) {
-    if (schedules[i].getScheduleId() > scheduleId) {
-      schedules[i] = Schedule(schedules[i].getScheduleId() - 1);
-      // Re-add all lessons to the renumbered schedule
-      string oldScheduleFile = "data/schedule_" +
-                               to_string(schedules[i].getScheduleId() + 1) +
-                               ".csv";
-      string newScheduleFile =
-          "data/schedule_" + to_string(schedules[i].getScheduleId()) + ".csv";
-      // The file should already be renamed above
-    }
-  }  // Sort schedules in memory by ID to maintain order
-  sort(schedules.begin(), schedules.end(),
-       [](const Schedule& a, const Schedule& b) {
-         return a.getScheduleId() < b.getScheduleId();
-       });
-
-  // Step 6: Update the schedules.csv file
-  saveSchedules();
+  // Other schedules keep their IDs; this one goes on the free list
+  scheduleStore.deleteSchedule(scheduleId);
 
   cout << BRIGHT_GREEN << "[OK] Schedule " << scheduleId
        << " removed successfully." << RESET << endl;
 }
 
-// Helper function to save individual schedule to file in comprehensive format
-void ScheduleManager::saveScheduleToFile(int scheduleId) {
-  auto scheduleIt = find_if(schedules.begin(), schedules.end(),
-                            [scheduleId](const Schedule& schedule) {
-                              return schedule.getScheduleId() == scheduleId;
-                            });
-
-  if (scheduleIt == schedules.end()) return;
-
-  string scheduleFilename = "data/schedule_" + to_string(scheduleId) + ".csv";
-  ofstream scheduleFile(scheduleFilename);
-
-  if (scheduleFile.is_open()) {
-    // Write comprehensive header
-    scheduleFile << "ScheduleID,LessonType,CourseID,Day,StartTime,Duration,"
-                    "Classroom,Building,Teacher,GroupID"
-                 << endl;
-
-    // Write all lessons in the comprehensive format
-    for (const auto& lesson : scheduleIt->getLessons()) {
-      int durationHours =
-          lesson->getDuration() / 60;  // Convert minutes back to hours for CSV
-      scheduleFile << scheduleId << "," << lesson->getLessonType() << ","
-                   << lesson->getCourseId() << "," << lesson->getDay() << ","
-                   << lesson->getStartTime() << "," << durationHours << ","
-                   << lesson->getClassroom() << "," << lesson->getBuilding()
-                   << "," << lesson->getTeacher() << "," << lesson->getGroupId()
-                   << endl;
-    }
-    scheduleFile.close();
+void ScheduleManager::flushPersistence() {
+  persistence.flush();
+  PersistenceQueue::Stats stats = persistence.stats();
+  cout << BRIGHT_GREEN << "[OK] All changes written to disk." << RESET << endl;
+  cout << GRAY << "  " << stats.requests << " write requests coalesced into "
+       << stats.fileWrites << " file operations in " << stats.batches
+       << " batches" << RESET << endl;
+  if (stats.failedWrites > 0) {
+    cout << YELLOW << "[WARN] " << stats.failedWrites
+         << " file operations failed." << RESET << endl;
   }
 }
 
@@ -859,12 +882,8 @@ bool ScheduleManager::addLessonToSchedule(int scheduleId, int courseId,
   cout << BRIGHT_BLUE << "  [AutoFix] Adding Course " << courseId << " Group "
        << groupId << " to Schedule " << scheduleId << RESET << endl;
 
-  auto scheduleIt = find_if(schedules.begin(), schedules.end(),
-                            [scheduleId](const Schedule& schedule) {
-                              return schedule.getScheduleId() == scheduleId;
-                            });
-
-  if (scheduleIt == schedules.end()) {
+  Schedule* schedule = getScheduleById(scheduleId);
+  if (!schedule) {
     cout << RED << "[ERROR] Schedule with ID " << scheduleId << " not found."
          << RESET << endl;
     return false;
@@ -876,20 +895,18 @@ bool ScheduleManager::addLessonToSchedule(int scheduleId, int courseId,
     return false;
   }
 
-  auto lessonIt =
-      find_if(courseLessons[courseId].begin(), courseLessons[courseId].end(),
-              [groupId](const shared_ptr<Lesson>& lesson) {
-                return lesson->getGroupId() == groupId;
-              });
-
-  if (lessonIt != courseLessons[courseId].end()) {
+  // Groups are looked up by packed code rather than compared by name
+  uint16_t groupCode = 0;
+  LessonRef catalogLesson = 0;
+  if (lessonTable.findGroupCode(groupId, groupCode) &&
+      lessonIndex.find(courseId, groupCode, catalogLesson)) {
     // Check for duplicate lesson before adding
-    const auto& lessonsInSchedule = scheduleIt->getLessons();
+    const auto& lessonsInSchedule = schedule->getLessons();
     auto duplicateCheck =
         find_if(lessonsInSchedule.begin(), lessonsInSchedule.end(),
-                [courseId, groupId](const shared_ptr<Lesson>& existingLesson) {
-                  return existingLesson->getCourseId() == courseId &&
-                         existingLesson->getGroupId() == groupId;
+                [this, courseId, groupCode](LessonRef existingLesson) {
+                  return lessonTable.courseId(existingLesson) == courseId &&
+                         lessonTable.groupCode(existingLesson) == groupCode;
                 });
 
     if (duplicateCheck != lessonsInSchedule.end()) {
@@ -899,10 +916,22 @@ bool ScheduleManager::addLessonToSchedule(int scheduleId, int courseId,
       return false;  // Return false to indicate duplicate was not added
     }
 
-    scheduleIt->addLesson(*lessonIt);
+    // Overlaps are reported, not refused; conflict resolution fixes them
+    for (LessonRef overlap : schedule->getConflicts(catalogLesson)) {
+      cout << YELLOW << "[WARN] Overlaps Course "
+           << lessonTable.courseId(overlap) << " Group "
+           << lessonTable.groupId(overlap) << " ("
+           << lessonTable.dayName(overlap) << " "
+           << lessonTable.startTime(overlap) << ")" << RESET << endl;
+    }
 
-    // Save entire schedule to file in comprehensive format
-    saveScheduleToFile(scheduleId);
+    schedule->addLesson(catalogLesson);
+
+    if (!scheduleStore.recordAdd(scheduleId,
+                                 lessonTable.view(catalogLesson))) {
+      cout << YELLOW << "[WARN] Could not write the schedule store." << RESET
+           << endl;
+    }
 
     cout << BRIGHT_GREEN << "[OK] Lesson added successfully!" << RESET << endl;
     return true;
@@ -918,29 +947,22 @@ bool ScheduleManager::removeLessonFromSchedule(int scheduleId, int courseId,
   cout << BRIGHT_BLUE << "  [AutoFix] Removing Course " << courseId << " Group "
        << groupId << " from Schedule " << scheduleId << RESET << endl;
 
-  auto scheduleIt = find_if(schedules.begin(), schedules.end(),
-                            [scheduleId](const Schedule& schedule) {
-                              return schedule.getScheduleId() == scheduleId;
-                            });
-
-  if (scheduleIt != schedules.end()) {
-    if (courseLessons.find(courseId) != courseLessons.end()) {
-      auto lessonIt = find_if(courseLessons[courseId].begin(),
-                              courseLessons[courseId].end(),
-                              [groupId](const shared_ptr<Lesson>& lesson) {
-                                return lesson->getGroupId() == groupId;
-                              });
-
-      if (lessonIt != courseLessons[courseId].end()) {
-        scheduleIt->removeLesson(courseId, groupId);
-
-        // Update file by rewriting it in comprehensive format
-        saveScheduleToFile(scheduleId);
+  Schedule* schedule = getScheduleById(scheduleId);
+  if (schedule) {
+    uint16_t groupCode = 0;
+    LessonRef catalogLesson = 0;
+    if (lessonTable.findGroupCode(groupId, groupCode) &&
+        lessonIndex.find(courseId, groupCode, catalogLesson)) {
+      schedule->removeLesson(courseId, groupId);
 
-        cout << BRIGHT_GREEN << "[OK] Lesson removed successfully!" << RESET
+      if (!scheduleStore.recordRemove(scheduleId, courseId, groupId)) {
+        cout << YELLOW << "[WARN] Could not write the schedule store." << RESET
              << endl;
-        return true;
       }
+
+      cout << BRIGHT_GREEN << "[OK] Lesson removed successfully!" << RESET
+           << endl;
+      return true;
     }
     cout << RED << "[ERROR] Lesson not found in schedule." << RESET << endl;
     return false;
@@ -953,15 +975,8 @@ bool ScheduleManager::removeLessonFromSchedule(int scheduleId, int courseId,
 
 // Helper method to get schedule by ID
 Schedule* ScheduleManager::getScheduleById(int scheduleId) {
-  auto scheduleIt = find_if(schedules.begin(), schedules.end(),
-                            [scheduleId](const Schedule& schedule) {
-                              return schedule.getScheduleId() == scheduleId;
-                            });
-
-  if (scheduleIt != schedules.end()) {
-    return &(*scheduleIt);
-  }
-  return nullptr;
+  size_t slot = scheduleIndex.find(scheduleId);
+  return slot == ScheduleIndex::NOT_FOUND ? nullptr : &schedules[slot];
 }
 
 // Public method for analytics to perform automatic conflict resolution
@@ -1059,13 +1074,23 @@ void ScheduleManager::showMainMenu() {
   // Advanced Analytics Section
   cout << BRIGHT_WHITE << "  [AI] " << BOLD << "ADVANCED ANALYTICS" << RESET
        << endl;
-  cout << BRIGHT_MAGENTA << "  [12] " << WHITE << "ConflictAnalysis <sched_id> "
+  cout << BRIGHT_MAGENTA << "  [12] " << WHITE << "ConflictAnalysis <id> [ms]  "
        << GRAY << "- AI-powered conflict detection       " << RESET << endl;
   cout << BRIGHT_MAGENTA << "  [13] " << WHITE
-       << "OptimalGeneration <credits> [tolerance] " << GRAY
+       << "OptimalGeneration <credits> [tol] [ms] " << GRAY
        << "- AI schedule optimization" << RESET << endl;
   cout << BRIGHT_MAGENTA << "  [14] " << WHITE << "AcademicAnalytics <sched>   "
        << GRAY << "- ML-based performance analysis       " << RESET << endl;
+  cout << BRIGHT_MAGENTA << "  [19] " << WHITE << "TopSchedules <credits> [k]  "
+       << GRAY << "- K best distinct options to compare  " << RESET << endl;
+  cout << BRIGHT_MAGENTA << "  [20] " << WHITE << "Preferences [spec|clear]    "
+       << GRAY << "- e.g. after=10:00 off=Friday max=6 gaps" << RESET << endl;
+  cout << BRIGHT_MAGENTA << "  [21] " << WHITE << "ParetoFront <credits> [tol] "
+       << GRAY << "- Every credits/gaps/days trade-off   " << RESET << endl;
+  cout << BRIGHT_MAGENTA << "  [22] " << WHITE << "CacheStats [clear]          "
+       << GRAY << "- Feasibility cache hits and misses   " << RESET << endl;
+  cout << BRIGHT_MAGENTA << "  [23] " << WHITE << "BulkGenerate <in> <out>     "
+       << GRAY << "- Schedule a file of student requests " << RESET << endl;
 
   cout << CYAN
        << "===================================================================="
@@ -1079,6 +1104,14 @@ void ScheduleManager::showMainMenu() {
        << GRAY << "- Comprehensive core functions test   " << RESET << endl;
   cout << BRIGHT_YELLOW << "  [16] " << WHITE << "AnalyticsTest              "
        << GRAY << "- Advanced analytics testing suite     " << RESET << endl;
+  cout << BRIGHT_YELLOW << "  [17] " << WHITE << "Benchmark <name>            "
+       << GRAY
+       << "- Benchmarks: catalog, csv, load, lessons, strings, store, "
+          "persistence, index, compat, solver, optimizer, search, credits, "
+          "anytime, topk, prefs, pareto, cache, bulk"
+       << RESET << endl;
+  cout << BRIGHT_YELLOW << "  [18] " << WHITE << "Flush                       "
+       << GRAY << "- Write pending changes to disk      " << RESET << endl;
 
   cout << CYAN
        << "===================================================================="
@@ -1143,6 +1176,7 @@ void ScheduleManager::run() {
     transform(command.begin(), command.end(), command.begin(), ::tolower);
 
     if (command == "exit" || command == "11") {
+      persistence.flush();
       cout << BRIGHT_GREEN
            << "[EXIT] Thank you for using the Schedule Management System!"
            << RESET << endl;
@@ -1201,21 +1235,27 @@ void ScheduleManager::run() {
       }
     } else if (command == "conflictanalysis" || command == "12") {
       int scheduleId;
+      double budgetMs = 0;  // No time limit
       if (ss >> scheduleId) {
-        analytics.intelligentConflictResolution(scheduleId);
+        ss >> budgetMs;  // Optional parameter
+        analytics.intelligentConflictResolution(scheduleId, budgetMs);
       } else {
-        cout << RED << "[ERROR] Usage: ConflictAnalysis <schedule_id>" << RESET
-             << endl;
+        cout << RED
+             << "[ERROR] Usage: ConflictAnalysis <schedule_id> [budget_ms]"
+             << RESET << endl;
       }
     } else if (command == "optimalgeneration" || command == "13") {
       int targetCredits;
       double tolerance = 0.15;  // Default tolerance
+      double budgetMs = 0;      // First schedulable candidate
       if (ss >> targetCredits) {
-        ss >> tolerance;  // Optional parameter
-        analytics.aiOptimalScheduleGeneration(targetCredits, tolerance);
+        ss >> tolerance >> budgetMs;  // Optional parameters
+        analytics.aiOptimalScheduleGeneration(targetCredits, tolerance,
+                                              budgetMs);
       } else {
         cout << RED
-             << "[ERROR] Usage: OptimalGeneration <target_credits> [tolerance]"
+             << "[ERROR] Usage: OptimalGeneration <target_credits> "
+                "[tolerance] [budget_ms]"
              << RESET << endl;
       }
     } else if (command == "academicanalytics" || command == "14") {
@@ -1230,6 +1270,78 @@ void ScheduleManager::run() {
       runComprehensiveSystemTest();
     } else if (command == "analyticstest" || command == "16") {
       runAdvancedAnalyticsTest();
+    } else if (command == "benchmark" || command == "17") {
+      string name;
+      if (ss >> name) {
+        runPerformanceBenchmark(name);
+      } else {
+        cout << RED << "[ERROR] Usage: Benchmark <name>" << RESET << endl;
+      }
+    } else if (command == "flush" || command == "18") {
+      flushPersistence();
+    } else if (command == "preferences" || command == "20") {
+      string spec;
+      getline(ss, spec);
+      size_t first = spec.find_first_not_of(" \t");
+      spec = first == string::npos ? "" : spec.substr(first);
+      if (spec.empty()) {
+        cout << BRIGHT_WHITE << "Preferences: " << RESET
+             << analytics.describePreferences() << endl;
+        cout << GRAY
+             << "  Usage: Preferences [after=HH:MM] [off=<Day>] [max=<hours>] "
+                "[gaps] | clear"
+             << RESET << endl;
+      } else if (spec == "clear") {
+        analytics.clearPreferences();
+        cout << GREEN << "Preferences cleared." << RESET << endl;
+      } else {
+        analytics.setPreferences(spec);
+      }
+    } else if (command == "bulkgenerate" || command == "23") {
+      string requestsPath;
+      string resultsPath;
+      if (ss >> requestsPath >> resultsPath) {
+        analytics.bulkScheduleGeneration(requestsPath, resultsPath);
+      } else {
+        cout << RED
+             << "[ERROR] Usage: BulkGenerate <requests.csv> <results.csv>"
+             << RESET << endl;
+      }
+    } else if (command == "cachestats" || command == "22") {
+      string option;
+      ss >> option;
+      transform(option.begin(), option.end(), option.begin(), ::tolower);
+      analytics.feasibilityCacheReport(option == "clear");
+    } else if (command == "paretofront" || command == "21") {
+      double targetCredits;
+      double tolerance = 1.0;
+      double budgetMs = AdvancedScheduleAnalytics::ADVISOR_SEARCH_MS;
+      if (ss >> targetCredits) {
+        ss >> tolerance >> budgetMs;
+        analytics.paretoFrontComparison(targetCredits, tolerance, budgetMs);
+      } else {
+        cout << RED
+             << "[ERROR] Usage: ParetoFront <credits> [tolerance] "
+                "[budget_ms, 0 = every set]"
+             << RESET << endl;
+      }
+    } else if (command == "topschedules" || command == "19") {
+      double targetCredits;
+      int count = 10;             // Options to compare
+      double minDistance = 0.5;   // Jaccard distance between course sets
+      double tolerance = 1.0;
+      double budgetMs = AdvancedScheduleAnalytics::ADVISOR_SEARCH_MS;
+      if (ss >> targetCredits) {
+        ss >> count >> minDistance >> tolerance >> budgetMs;
+        analytics.topScheduleComparison(targetCredits,
+                                        static_cast<size_t>(max(count, 1)),
+                                        minDistance, tolerance, budgetMs);
+      } else {
+        cout << RED
+             << "[ERROR] Usage: TopSchedules <credits> [count] [min_distance] "
+                "[tolerance] [budget_ms, 0 = every set]"
+             << RESET << endl;
+      }
     } else {
       cout << RED << "[ERROR] Unknown command: " << input << RESET << endl;
       cout << BRIGHT_GREEN
@@ -1421,12 +1533,15 @@ void ScheduleManager::runComprehensiveSystemTest() {
     failedTests++;
 
   // Test schedule file persistence
-  string scheduleFile = "data/schedule_" + to_string(testScheduleId) + ".csv";
-  ifstream file(scheduleFile);
-  bool scheduleFileTest = file.good();
-  file.close();
+  string storeFile = dataDirectory + ScheduleStore::FILE_NAME;
+  persistence.flush();  // Writes are queued for the flusher thread
+  ScheduleStore::Contents stored;
+  bool scheduleFileTest =
+      ScheduleStore::read(storeFile, stored) &&
+      binary_search(stored.scheduleIds.begin(), stored.scheduleIds.end(),
+                    testScheduleId);
   printTestResult("Schedule file persistence", scheduleFileTest,
-                  "CSV file created: " + scheduleFile);
+                  "Schedule recorded in: " + storeFile);
   totalTests++;
   if (scheduleFileTest)
     passedTests++;
@@ -1491,19 +1606,12 @@ void ScheduleManager::runComprehensiveSystemTest() {
   if (!courses.empty()) {
     int courseId = courses[0].getCourseId();
     string filename = "data/" + to_string(courseId) + "_lectures.csv";
-    ifstream csvFile(filename);
-    if (csvFile.is_open()) {
-      string line;
-      getline(csvFile, line);  // Skip header
+    CsvReader csvFile(filename);
+    if (csvFile.isOpen()) {
+      csvFile.nextRow();  // Skip header
       int lineCount = 0;
-      while (getline(csvFile, line) && lineCount < 10) {  // Test first 10 lines
-        vector<string> fields;
-        stringstream ss(line);
-        string field;
-        while (getline(ss, field, ',')) {
-          fields.push_back(field);
-        }
-        if (fields.size() < 8) malformedLines++;
+      while (lineCount < 10 && csvFile.nextRow()) {  // Test first 10 lines
+        if (csvFile.fieldCount() < 8) malformedLines++;
         lineCount++;
       }
       csvFile.close();
@@ -1632,10 +1740,10 @@ void ScheduleManager::runComprehensiveSystemTest() {
               });
   if (consistencyScheduleIt != schedules.end()) {
     const auto& lessons = consistencyScheduleIt->getLessons();
-    for (const auto& lesson : lessons) {
+    for (LessonRef lesson : lessons) {
       bool courseExists = false;
       for (const auto& course : courses) {
-        if (course.getCourseId() == lesson->getCourseId()) {
+        if (course.getCourseId() == lessonTable.courseId(lesson)) {
           courseExists = true;
           break;
         }
@@ -1662,23 +1770,21 @@ void ScheduleManager::runComprehensiveSystemTest() {
                 return schedule.getScheduleId() == testScheduleId;
               });
   if (scheduleFileTest && syncScheduleIt != schedules.end()) {
-    ifstream file("data/schedule_" + to_string(testScheduleId) + ".csv");
-    if (file.is_open()) {
-      string line;
-      int fileLineCount = 0;
-      while (getline(file, line)) {
-        if (!line.empty() && line.find("ScheduleID") == string::npos) {
-          fileLineCount++;
-        }
+    persistence.flush();
+    ScheduleStore::Contents synced;
+    syncTest = false;
+    if (ScheduleStore::read(storeFile, synced)) {
+      auto idIt = lower_bound(synced.scheduleIds.begin(),
+                              synced.scheduleIds.end(), testScheduleId);
+      if (idIt != synced.scheduleIds.end() && *idIt == testScheduleId) {
+        size_t storedLessonCount =
+            synced.scheduleLessons[idIt - synced.scheduleIds.begin()].size();
+        syncTest = storedLessonCount == syncScheduleIt->getLessons().size();
       }
-      file.close();
-      int memoryLessonCount =
-          static_cast<int>(syncScheduleIt->getLessons().size());
-      syncTest = (fileLineCount == memoryLessonCount);
     }
   }
   printTestResult("Memory-file synchronization", syncTest,
-                  "Data consistent between memory and CSV");
+                  "Data consistent between memory and store");
   totalTests++;
   if (syncTest)
     passedTests++;
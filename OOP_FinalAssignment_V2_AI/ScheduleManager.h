@@ -14,11 +14,20 @@
 #include <vector>
 
 #include "AdvancedScheduleAnalytics.h"
+#include "CatalogSnapshot.h"
+#include "CsvReader.h"
 #include "Course.h"
+#include "CourseLessonIndex.h"
 #include "Lab.h"
 #include "Lecture.h"
+#include "LessonTable.h"
+#include "PersistenceQueue.h"
 #include "Schedule.h"
+#include "ScheduleIndex.h"
+#include "ScheduleStore.h"
+#include "SectionCompatibility.h"
 #include "Tutorial.h"
+#include "WorkerPool.h"
 
 using namespace std;
 
@@ -33,10 +42,33 @@ class ScheduleManager {
  private:
   // Core Data Members
   vector<Course> courses;
-  vector<Schedule> schedules;
-  map<int, vector<shared_ptr<Lesson>>> courseLessons;
+  vector<Schedule> schedules;    // Unordered; removal moves the last one
+  ScheduleIndex scheduleIndex;   // Schedule ID -> position in schedules
+  LessonTable lessonTable;  // Catalog and schedule lessons, by LessonRef
+  map<int, vector<LessonRef>> courseLessons;
+  CourseLessonIndex lessonIndex;  // courseLessons by (course, group), type
+  SectionCompatibility compatibility;  // Catalog section clashes
   int currentCourseIndex = 0;
   AdvancedScheduleAnalytics analytics;
+  string dataDirectory = "data/";  // Catalog CSVs and snapshot location
+
+  // Every schedule lives in one append-only store file, written by a
+  // background flusher thread
+  PersistenceQueue persistence;
+  ScheduleStore scheduleStore{&persistence};
+
+  // Lesson and schedule files are independent, so they load in parallel
+  bool parallelLoading = true;
+  WorkerPool loadPool;
+
+  /**
+   * @brief Lessons and diagnostics parsed from one schedule file
+   */
+  struct ScheduleFileData {
+    bool opened = false;
+    LessonTable lessons;      // Rows in file order, with their own strings
+    vector<string> badLines;  // Rows that failed to parse
+  };
 
   // ================= MODERN COLOR PALETTE =================
   // Text Formatting
@@ -84,6 +116,17 @@ class ScheduleManager {
   ScheduleManager();
 
   // ================= CORE DATA MANAGEMENT =================
+  /**
+   * @brief Load courses and lessons, preferring the binary catalog snapshot
+   *
+   * Falls back to the CSV files when the snapshot is missing or stale and
+   * rebuilds the snapshot from the freshly parsed catalog.
+   */
+  void loadCatalog();
+
+  /** @brief Rebuild the lookups derived from the loaded catalog */
+  void buildCatalogIndexes();
+
   /**
    * @brief Load course data from CSV file
    */
@@ -98,29 +141,84 @@ class ScheduleManager {
 
   /**
    * @brief Load all lesson data for all courses
+   *
+   * Course files are parsed across the worker pool and merged in catalog
+   * order, so the result does not depend on the thread count.
    */
   void loadLessons();
 
   /**
-   * @brief Load existing schedules from storage
+   * @brief Load existing schedules from the schedule store
+   *
+   * On the first start after the per-schedule file layout, those files are
+   * moved into the store.
    */
   void loadSchedules();
 
   /**
-   * @brief Save current schedules to storage
+   * @brief Wait until every queued write is on disk and report the
+   *        group-commit counters
+   */
+  void flushPersistence();
+
+  /**
+   * @brief Build the in-memory schedules from replayed store contents
+   */
+  void loadScheduleData(const ScheduleStore::Contents& contents);
+
+ private:
+  /**
+   * @brief Parse one lesson file without touching shared state
+   * @param lessons Receives the parsed lessons in file order
+   */
+  static void readLessonFile(const string& filename, const string& type,
+                             LessonTable& lessons);
+
+  /**
+   * @brief Parse one schedule file of the old layout without touching
+   *        shared state
+   * @param table, catalog Loaded lessons, for rows in the old course,group
+   *                       format
+   */
+  static void readScheduleFile(const string& filename,
+                               const LessonTable& table,
+                               const CourseLessonIndex& catalog,
+                               ScheduleFileData& data);
+
+  /**
+   * @brief Load data/schedules.csv and the schedule_N.csv files it lists
+   *        and record them in the store
+   *
+   * The files are parsed across the worker pool and merged in schedule
+   * order. Once the store is on disk each imported file is renamed to
+   * <name>.imported, so it is never imported twice. A schedule whose ID the
+   * store rejects is skipped with a warning and its file left in place.
+   * @return false if there is no schedules.csv to import
    */
-  void saveSchedules();
+  bool importLegacySchedules();
+
+  /** @brief Rename an imported file to <name>.imported (or delete it) */
+  static void retireLegacyFile(const string& path);
+
+  /**
+   * @brief Append parsed lessons to lessonTable and file them in
+   *        courseLessons under their course IDs
+   */
+  void mergeLessons(const LessonTable& lessons);
 
   /**
-   * @brief Save individual schedule to file in comprehensive format
-   * @param scheduleId The schedule ID to save
+   * @brief Ref of the catalog lesson equal to a parsed schedule row, adding
+   *        the row to lessonTable only when the catalog has no such lesson
    */
-  void saveScheduleToFile(int scheduleId);
+  LessonRef internScheduleLesson(const LessonTable& lessons, LessonRef row);
 
   /**
-   * @brief Load lesson data for existing schedules
+   * @brief Run task(0..count-1) on the load pool, or inline when
+   *        parallelLoading is off
    */
-  void loadScheduleData();
+  void forEachLoadTask(size_t count, const function<void(size_t)>& task);
+
+ public:
 
   // ================= DISPLAY FUNCTIONS =================
   /**
@@ -260,6 +358,149 @@ class ScheduleManager {
    * @brief Run advanced analytics test suite
    */
   void runAdvancedAnalyticsTest();
+
+  // ================= PERFORMANCE BENCHMARKS =================
+  /**
+   * @brief Run a named performance benchmark
+   * @param name Benchmark name (see showMainMenu for the list)
+   */
+  void runPerformanceBenchmark(const string& name);
+
+  /**
+   * @brief Compare CSV catalog loading with the binary snapshot
+   *
+   * Generates synthetic catalogs at 10x and 100x the loaded catalog size and
+   * times a cold CSV load against a snapshot load for each.
+   */
+  void runCatalogBenchmark();
+
+  /**
+   * @brief Compare the mapped CsvReader with the getline/stringstream parser
+   *
+   * Reports rows per second and heap allocations per row for both on a
+   * synthetic lesson file.
+   */
+  void runCsvBenchmark();
+
+  /**
+   * @brief Compare sequential and worker-pool loading of lesson and
+   *        schedule files
+   *
+   * Uses a synthetic data directory with tens of thousands of files and
+   * checks that both modes produce identical catalogs and schedules.
+   */
+  void runLoadBenchmark();
+
+  /**
+   * @brief Compare shared_ptr<Lesson> objects with the LessonTable
+   *
+   * Measures heap bytes per lesson for both representations and times an
+   * all-pairs same-day overlap scan over each.
+   */
+  void runLessonTableBenchmark();
+
+  /**
+   * @brief Report what the global StringPool saves
+   *
+   * Prints the pool counters accumulated since startup, then builds the
+   * same conflict records with string and with Symbol fields and compares
+   * their heap bytes and an all-pairs same-day / same-room scan.
+   */
+  void runStringPoolBenchmark();
+
+  /**
+   * @brief Time schedule create / delete / reload in the schedule store at
+   *        1k, 100k and 1M schedules, against renumbering one file per
+   *        schedule
+   */
+  void runScheduleStoreBenchmark();
+
+  /**
+   * @brief Compare command latency with synchronous writes and with the
+   *        group-commit flusher thread
+   *
+   * Replays 2k Add/Rm commands with a schedule created every tenth both
+   * ways, and checks that both leave the same store file.
+   */
+  void runPersistenceBenchmark();
+
+  /**
+   * @brief Time schedule lookup by ID through the ScheduleIndex and with
+   *        a linear find_if, at 1k, 100k and 1M schedules
+   */
+  void runScheduleIndexBenchmark();
+
+  /**
+   * @brief Build the section compatibility matrix for the catalog copied
+   *        1x, 10x and 50x, and compare a clash bit test with comparing
+   *        the sections' day and time strings
+   */
+  void runCompatibilityBenchmark();
+
+  /**
+   * @brief Solve random 5-8 course loads with the SectionSolver and with
+   *        first-fit group picking, checking the solver's answers against
+   *        a plain exhaustive backtracking search
+   */
+  void runSectionSolverBenchmark();
+
+  /**
+   * @brief Candidates/sec of the optimizer's combination test when it
+   *        re-reads every course's lesson files and in memory
+   */
+  void runOptimizerBenchmark();
+
+  /**
+   * @brief Candidates/sec of CandidateSearch on 1, 2, 4 and all hardware
+   *        threads, checking every thread count gives the same answers
+   */
+  void runCandidateSearchBenchmark();
+
+  /**
+   * @brief Course sets within credit targets 6-24 found by the old random
+   *        shuffles and by CreditSubsets, against an exhaustive count
+   */
+  void runCreditSubsetBenchmark();
+
+  /**
+   * @brief Anytime CandidateSearch with no limit, 50 ms and 5 ms budgets
+   *        and a cancellation, timing the first published schedule and
+   *        how close each stop gets to the full search's best
+   */
+  void runAnytimeSearchBenchmark();
+
+  /**
+   * @brief The 10 and 50 best diverse schedules at 15 credits, kept in a
+   *        TopSchedules heap and by storing every schedule and sorting,
+   *        comparing time, peak heap use and the options chosen
+   */
+  void runTopSchedulesBenchmark();
+
+  /**
+   * @brief Solve random course loads with and without compiled
+   *        preferences, checking every answer against the raw rules and an
+   *        exhaustive search, and time scoring with the slot masks
+   */
+  void runPreferencesBenchmark();
+
+  /**
+   * @brief Check the sorted Pareto front against a pairwise filter over
+   *        every schedulable course set, and time both
+   */
+  void runParetoFrontBenchmark();
+
+  /**
+   * @brief Solve two batches of random course sets with and without the
+   *        feasibility cache, cold, warm and overlapping, checking the
+   *        cached answers and assignments
+   */
+  void runFeasibilityCacheBenchmark();
+
+  /**
+   * @brief Schedule a generated file of students on one thread and on the
+   *        pool, checking every result row against the catalog
+   */
+  void runBulkScheduleBenchmark();
 };
 
 #endif  // SCHEDULE_MANAGER_H
@@ -0,0 +1,231 @@
+#include "SchedulePreferences.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const int SchedulePreferences::DAYS;
+const int SchedulePreferences::SLOT_MINUTES;
+const int SchedulePreferences::SLOTS_PER_DAY;
+const int SchedulePreferences::DAY_WORDS;
+
+namespace {
+
+// "friday" and "FRIDAY" to "Friday"
+string dayName(string text) {
+  for (size_t i = 0; i < text.size(); i++) {
+    text[i] = static_cast<char>(i == 0 ? toupper(text[i]) : tolower(text[i]));
+  }
+  return text;
+}
+
+// Bits [from, to) of one word, 0 <= from < to <= 64
+uint64_t wordMask(int from, int to) {
+  uint64_t high = to == 64 ? ~0ULL : (1ULL << to) - 1;
+  return high & ~((1ULL << from) - 1);
+}
+
+// Lowest and highest set bit of a non-zero word
+int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+int highestBit(uint64_t bits) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(bits);
+#endif
+}
+
+}  // namespace
+
+bool SchedulePreferences::parse(const string& text, Spec& spec,
+                                string& error) {
+  spec = Spec();
+  string spaced = text;
+  replace(spaced.begin(), spaced.end(), ',', ' ');
+  istringstream words(spaced);
+  string word;
+  while (words >> word) {
+    size_t equals = word.find('=');
+    string key = word.substr(0, equals);
+    string value = equals == string::npos ? "" : word.substr(equals + 1);
+    transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+    if (key == "gaps" && value.empty()) {
+      spec.minimizeGaps = true;
+    } else if (key == "after") {
+      if (value.find(':') == string::npos) value += ":00";
+      uint16_t minute = LessonTable::parseStartMinute(value);
+      if (minute == LessonTable::NO_START) {
+        error = "after= needs a time such as 10:00, not '" + value + "'";
+        return false;
+      }
+      spec.earliestStart = minute;
+    } else if (key == "off") {
+      int day = LessonTable::dayIndexOf(dayName(value));
+      if (day < 0) {
+        error = "off= needs a day such as Friday, not '" + value + "'";
+        return false;
+      }
+      spec.daysOff |= static_cast<uint8_t>(1 << day);
+    } else if (key == "max") {
+      double hours = 0;
+      istringstream number(value);
+      if (!(number >> hours) || hours <= 0 || hours > 24) {
+        error = "max= needs hours per day between 0 and 24, not '" + value +
+                "'";
+        return false;
+      }
+      spec.maxDailyMinutes = static_cast<int>(lround(hours * 60));
+    } else {
+      error = "unknown preference '" + word + "'";
+      return false;
+    }
+  }
+  return true;
+}
+
+string SchedulePreferences::describe(const Spec& spec) {
+  ostringstream text;
+  if (spec.earliestStart > 0) {
+    text << " after=" << setfill('0') << setw(2) << spec.earliestStart / 60
+         << ':' << setw(2) << spec.earliestStart % 60 << setfill(' ');
+  }
+  for (int day = 0; day < DAYS; day++) {
+    if (spec.daysOff & (1 << day)) {
+      text << " off=" << LessonTable::DAY_NAMES[day];
+    }
+  }
+  if (spec.maxDailyMinutes > 0) {
+    text << " max=" << spec.maxDailyMinutes / 60.0;
+  }
+  if (spec.minimizeGaps) text << " gaps";
+  string described = text.str();
+  return described.empty() ? "none" : described.substr(1);
+}
+
+void SchedulePreferences::compile(const Spec& spec, const LessonTable& table,
+                                  size_t sections) {
+  settings = spec;
+  scoring = Weights();
+  if (spec.minimizeGaps) {
+    scoring.credits = 0.4;
+    scoring.compactness = 0.45;
+    scoring.freeDays = 0.15;
+  }
+  isActive = spec.earliestStart > 0 || spec.daysOff != 0 ||
+             spec.maxDailyMinutes > 0 || spec.minimizeGaps;
+
+  // Forbidden slots: whole days off, and every slot before the earliest
+  // start on the other days
+  int earlySlots = min(spec.earliestStart / SLOT_MINUTES, SLOTS_PER_DAY);
+  for (int day = 0; day < DAYS; day++) {
+    memset(forbidden[day].words, 0, sizeof(forbidden[day].words));
+    int end = (spec.daysOff & (1 << day)) ? SLOTS_PER_DAY : earlySlots;
+    for (int word = 0; word * 64 < end; word++) {
+      forbidden[day].words[word] = wordMask(0, min(end - word * 64, 64));
+    }
+  }
+
+  sectionCount = min(sections, table.size());
+  allowedBits.assign((sectionCount + 63) / 64, 0);
+  days.assign(sectionCount, DAYS);
+  durations.assign(sectionCount, 0);
+  slots.assign(sectionCount, DayMask());
+  for (size_t section = 0; section < sectionCount; section++) {
+    LessonRef row = static_cast<LessonRef>(section);
+    int day = table.dayIndex(row);
+    int start = table.startMinute(row);
+    int length = table.durationMinutes(row);
+    DayMask& mask = slots[section];
+    memset(mask.words, 0, sizeof(mask.words));
+    durations[section] = static_cast<uint16_t>(length);
+
+    bool allowedHere = spec.maxDailyMinutes == 0 ||
+                       length <= spec.maxDailyMinutes;
+    if (day < DAYS) {
+      days[section] = static_cast<uint8_t>(day);
+      if (spec.daysOff & (1 << day)) allowedHere = false;
+      if (start != LessonTable::NO_START && length > 0) {
+        int end = min(start + length, 24 * 60);
+        int first = start / SLOT_MINUTES;
+        int last = (end + SLOT_MINUTES - 1) / SLOT_MINUTES;
+        for (int word = first / 64; word * 64 < last; word++) {
+          mask.words[word] = wordMask(max(first - word * 64, 0),
+                                      min(last - word * 64, 64));
+          if (mask.words[word] & forbidden[day].words[word]) {
+            allowedHere = false;
+          }
+        }
+      }
+    }
+    if (allowedHere) allowedBits[section / 64] |= 1ULL << (section % 64);
+  }
+}
+
+void SchedulePreferences::clear() {
+  settings = Spec();
+  scoring = Weights();
+  isActive = false;
+  sectionCount = 0;
+  allowedBits.clear();
+  days.clear();
+  durations.clear();
+  slots.clear();
+}
+
+bool SchedulePreferences::measure(const vector<LessonRef>& lessons,
+                                  int earlyBefore, int& daysUsed,
+                                  int& gapMinutes, int& earlyStarts) const {
+  DayMask week[DAYS];
+  memset(week, 0, sizeof(week));
+  for (LessonRef lesson : lessons) {
+    if (lesson >= sectionCount) return false;
+    int day = days[lesson];
+    if (day >= DAYS) continue;
+    for (int word = 0; word < DAY_WORDS; word++) {
+      week[day].words[word] |= slots[lesson].words[word];
+    }
+  }
+
+  // Idle slots of a day: its span from first to last taken slot, less the
+  // taken ones
+  daysUsed = 0;
+  gapMinutes = 0;
+  earlyStarts = 0;
+  for (int day = 0; day < DAYS; day++) {
+    int taken = 0;
+    int first = -1;
+    int last = -1;
+    for (int word = 0; word < DAY_WORDS; word++) {
+      uint64_t bits = week[day].words[word];
+      if (!bits) continue;
+      taken += static_cast<int>(bitset<64>(bits).count());  // popcount
+      if (first < 0) first = word * 64 + lowestBit(bits);
+      last = word * 64 + highestBit(bits);
+    }
+    if (taken == 0) continue;
+    daysUsed++;
+    if (first * SLOT_MINUTES < earlyBefore) earlyStarts++;
+    gapMinutes += (last - first + 1 - taken) * SLOT_MINUTES;
+  }
+  return true;
+}
@@ -0,0 +1,118 @@
+#ifndef SCHEDULE_PREFERENCES_H
+#define SCHEDULE_PREFERENCES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class SchedulePreferences
+ * @brief A student's time preferences, compiled into slot bitmasks
+ *
+ * The spec is a few words, e.g. "after=10:00 off=Friday max=6 gaps":
+ *   - after=HH:MM  no lesson before this time
+ *   - off=<Day>    no lesson on this day (repeatable)
+ *   - max=<hours>  at most this many hours of lessons a day
+ *   - gaps         weigh idle time between lessons more heavily
+ *
+ * compile() turns the first two into a forbidden-slot mask per day - 5-
+ * minute slots like WeekOccupancy, five words a day - and tests every
+ * catalog section against it once, keeping one "allowed" bit per section.
+ * It also keeps each section's slot mask, so the day count and idle time
+ * of a lesson set come from OR-ing masks and counting bits. The solver
+ * then pays one bit test per group for the hard limits and an add and a
+ * compare per choice for the daily maximum.
+ *
+ * Rebuild with compile() whenever the catalog changes.
+ */
+class SchedulePreferences {
+ public:
+  static const int DAYS = 7;
+  static const int SLOT_MINUTES = 5;
+  static const int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+  static const int DAY_WORDS = (SLOTS_PER_DAY + 63) / 64;
+
+  /** @brief What the student asked for */
+  struct Spec {
+    int earliestStart = 0;     // Minutes after midnight
+    uint8_t daysOff = 0;       // Bit d: no lesson on day d
+    int maxDailyMinutes = 0;   // 0 = no limit
+    bool minimizeGaps = false;
+  };
+
+  /** @brief ScheduleQuality's weights under these preferences */
+  struct Weights {
+    double credits = 0.5;
+    double compactness = 0.3;
+    double freeDays = 0.2;
+  };
+
+  /**
+   * @brief Read a spec
+   * @param error Receives what was wrong when it returns false
+   */
+  static bool parse(const string& text, Spec& spec, string& error);
+
+  /** @brief The spec in the form parse() reads; "none" when empty */
+  static string describe(const Spec& spec);
+
+  /** @brief Build the masks for the first `sections` rows of the table */
+  void compile(const Spec& spec, const LessonTable& table, size_t sections);
+
+  /** @brief Forget the spec; every section is allowed again */
+  void clear();
+
+  /** @brief True once a spec with any preference was compiled */
+  bool active() const { return isActive; }
+
+  const Spec& spec() const { return settings; }
+  const Weights& weights() const { return scoring; }
+
+  /** @brief False if the section breaks a time or day limit */
+  bool allowed(LessonRef section) const {
+    return section >= sectionCount ||
+           ((allowedBits[section / 64] >> (section % 64)) & 1);
+  }
+
+  /** @brief Daily maximum in minutes, 0 when there is none */
+  int maxDailyMinutes() const { return settings.maxDailyMinutes; }
+
+  /** @brief Weekday (0-6) of a compiled section, DAYS for any other day */
+  int day(LessonRef section) const { return days[section]; }
+
+  /** @brief Length of a compiled section in minutes */
+  int minutes(LessonRef section) const { return durations[section]; }
+
+  bool covers(LessonRef section) const { return section < sectionCount; }
+
+  /**
+   * @brief Days with a lesson, idle minutes between lessons and days whose
+   *        first lesson starts before earlyBefore, from the sections' slot
+   *        masks
+   * @return false if a lesson is not a compiled section
+   */
+  bool measure(const vector<LessonRef>& lessons, int earlyBefore,
+               int& daysUsed, int& gapMinutes, int& earlyStarts) const;
+
+ private:
+  struct DayMask {
+    uint64_t words[DAY_WORDS];
+  };
+
+  Spec settings;
+  Weights scoring;
+  bool isActive = false;
+  size_t sectionCount = 0;
+  DayMask forbidden[DAYS];
+  vector<uint64_t> allowedBits;  // One bit per section
+  vector<uint8_t> days;          // Per section
+  vector<uint16_t> durations;    // Per section
+  vector<DayMask> slots;         // Per section, slots of its day it covers
+};
+
+#endif  // SCHEDULE_PREFERENCES_H
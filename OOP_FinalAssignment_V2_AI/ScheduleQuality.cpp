@@ -0,0 +1,70 @@
+#include "ScheduleQuality.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct Meeting {
+  int day;
+  int start;
+  int end;
+
+  bool operator<(const Meeting& other) const {
+    return day != other.day ? day < other.day : start < other.start;
+  }
+};
+
+}  // namespace
+
+const int ScheduleQuality::EARLY_START;
+
+ScheduleQuality::ScheduleQuality(const LessonTable& lessonTable,
+                                 double targetCredits,
+                                 const SchedulePreferences* preferences)
+    : lessonTable(&lessonTable),
+      targetCredits(targetCredits),
+      preferences(preferences && preferences->active() ? preferences
+                                                       : nullptr) {
+  if (this->preferences) weights = this->preferences->weights();
+}
+
+ScheduleQuality::Metrics ScheduleQuality::measure(
+    const vector<LessonRef>& lessons, double credits) const {
+  Metrics metrics;
+  metrics.creditDeviation = fabs(credits - targetCredits);
+  if (preferences &&
+      preferences->measure(lessons, EARLY_START, metrics.daysUsed,
+                           metrics.gapMinutes, metrics.earlyStarts)) {
+    return metrics;
+  }
+
+  vector<Meeting> meetings;
+  meetings.reserve(lessons.size());
+  for (LessonRef lesson : lessons) {
+    int day = lessonTable->dayIndex(lesson);
+    int start = lessonTable->startMinute(lesson);
+    if (day >= 7 || start == LessonTable::NO_START) continue;
+    meetings.push_back(
+        {day, start, start + lessonTable->durationMinutes(lesson)});
+  }
+  sort(meetings.begin(), meetings.end());
+
+  for (size_t i = 0; i < meetings.size(); i++) {
+    if (i == 0 || meetings[i].day != meetings[i - 1].day) {
+      metrics.daysUsed++;
+      if (meetings[i].start < EARLY_START) metrics.earlyStarts++;
+      continue;
+    }
+    metrics.gapMinutes += max(0, meetings[i].start - meetings[i - 1].end);
+  }
+  return metrics;
+}
+
+double ScheduleQuality::score(const Metrics& metrics) const {
+  double creditFit = 1.0 / (1.0 + metrics.creditDeviation);
+  double compactness = 1.0 / (1.0 + metrics.gapMinutes / 60.0);
+  double freeDays = (7 - metrics.daysUsed) / 7.0;
+  return weights.credits * creditFit + weights.compactness * compactness +
+         weights.freeDays * freeDays;
+}
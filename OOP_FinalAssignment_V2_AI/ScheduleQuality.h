@@ -0,0 +1,57 @@
+#ifndef SCHEDULE_QUALITY_H
+#define SCHEDULE_QUALITY_H
+
+#include <vector>
+
+#include "LessonTable.h"
+#include "SchedulePreferences.h"
+
+using namespace std;
+
+/**
+ * @class ScheduleQuality
+ * @brief Scores a conflict-free lesson set, higher is better
+ *
+ * score = 0.5 * credit fit + 0.3 * compactness + 0.2 * free days by
+ * default, each part in [0, 1]:
+ *   - credit fit: 1 / (1 + |credits - target|)
+ *   - compactness: 1 / (1 + idle hours between lessons of the same day)
+ *   - free days: weekdays without a lesson, out of seven
+ * Early starts are measured for ParetoFront but not part of the score.
+ * With SchedulePreferences the three weights are the preferences' and the
+ * days and idle time come from their compiled slot masks (OR and popcount)
+ * instead of sorting the lessons.
+ *
+ * Scoring only reads the lesson table, so threads may share one instance.
+ */
+class ScheduleQuality {
+ public:
+  /** @brief Raw measurements the score is built from */
+  struct Metrics {
+    double creditDeviation = 0;  // |credits - target|
+    int gapMinutes = 0;          // Idle time between lessons, all days
+    int daysUsed = 0;            // Weekdays with at least one lesson
+    int earlyStarts = 0;         // Days whose first lesson is before 10:00
+  };
+
+  /** @brief A day's first lesson before this minute counts as early */
+  static const int EARLY_START = 10 * 60;
+
+  /** @param preferences Compiled for this catalog; may be null */
+  ScheduleQuality(const LessonTable& lessonTable, double targetCredits,
+                  const SchedulePreferences* preferences = nullptr);
+
+  Metrics measure(const vector<LessonRef>& lessons, double credits) const;
+  double score(const Metrics& metrics) const;
+  double score(const vector<LessonRef>& lessons, double credits) const {
+    return score(measure(lessons, credits));
+  }
+
+ private:
+  const LessonTable* lessonTable;
+  double targetCredits;
+  const SchedulePreferences* preferences;
+  SchedulePreferences::Weights weights;
+};
+
+#endif  // SCHEDULE_QUALITY_H
@@ -0,0 +1,329 @@
+#include "ScheduleStore.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "CatalogSnapshot.h"
+#include "CsvReader.h"
+
+const string ScheduleStore::FILE_NAME = "schedule_store.csv";
+
+const string ScheduleStore::HEADER =
+    "Record,ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,"
+    "Building,Teacher,GroupID";
+
+namespace {
+
+// One schedule while the log is replayed
+struct Slot {
+  int scheduleId = 0;
+  bool live = false;
+  vector<LessonRef> lessons;
+};
+
+const uint32_t NO_SLOT = 0xFFFFFFFF;
+
+bool parseScheduleId(const CsvField& field, int& scheduleId) {
+  try {
+    scheduleId = field.toInt();
+  } catch (const exception&) {
+    return false;
+  }
+  return scheduleId > 0 && scheduleId <= ScheduleStore::MAX_SCHEDULE_ID;
+}
+
+vector<LessonRef>::iterator findLesson(const LessonTable& lessons,
+                                       vector<LessonRef>& refs, int courseId,
+                                       const string& groupId) {
+  uint16_t groupCode = 0;
+  if (!lessons.findGroupCode(groupId, groupCode)) return refs.end();
+  return find_if(refs.begin(), refs.end(),
+                 [&lessons, courseId, groupCode](LessonRef lesson) {
+                   return lessons.courseId(lesson) == courseId &&
+                          lessons.groupCode(lesson) == groupCode;
+                 });
+}
+
+}  // namespace
+
+ScheduleStore::ScheduleStore(PersistenceQueue* persistenceQueue,
+                             size_t compactBytes)
+    : queue(persistenceQueue),
+      threshold(compactBytes),
+      nextId(1),
+      liveCount(0),
+      appendedBytes(0),
+      compactedBytes(make_shared<atomic<size_t>>(0)) {}
+
+// =================== REPLAY ===================
+
+bool ScheduleStore::read(const string& path, Contents& contents) {
+  CsvReader reader(path);
+  if (!reader.isOpen()) return false;
+  reader.nextRow();  // Skip header
+
+  // Slots are kept in first-seen order; only the ID to slot map is dense
+  vector<Slot> slots;
+  vector<uint32_t> slotOf;
+  while (reader.nextRow()) {
+    if (!reader.rowTerminated()) break;  // Torn last record
+
+    int scheduleId = 0;
+    if (reader.fieldCount() < 2 || !parseScheduleId(reader[1], scheduleId)) {
+      contents.badLines.push_back(reader.row().str());
+      continue;
+    }
+    if (static_cast<size_t>(scheduleId) >= slotOf.size()) {
+      slotOf.resize(scheduleId + 1, NO_SLOT);
+    }
+    if (slotOf[scheduleId] == NO_SLOT) {
+      slotOf[scheduleId] = static_cast<uint32_t>(slots.size());
+      slots.emplace_back();
+      slots.back().scheduleId = scheduleId;
+    }
+    Slot& slot = slots[slotOf[scheduleId]];
+    const CsvField& type = reader[0];
+
+    if (type == "S") {
+      slot.live = true;
+    } else if (type == "D") {
+      slot.live = false;
+      slot.lessons.clear();
+    } else if (type == "+" && reader.fieldCount() >= 11 && slot.live) {
+      // ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,
+      // Building,Teacher,GroupID after the record type
+      try {
+        LessonTable::Kind kind;
+        int courseId = reader[3].toInt();
+        string groupId = reader[10].str();
+        if (!LessonTable::parseKind(reader[2].str(), kind)) {
+          contents.badLines.push_back(reader.row().str());
+          continue;
+        }
+        if (findLesson(contents.lessons, slot.lessons, courseId, groupId) ==
+            slot.lessons.end()) {
+          slot.lessons.push_back(contents.lessons.add(
+              courseId, kind, reader[4].symbol(), reader[5].str(),
+              reader[6].toInt() * 60,  // Hours in the file
+              reader[7].symbol(), reader[8].symbol(), reader[9].symbol(),
+              groupId));
+        }
+      } catch (const exception&) {
+        contents.badLines.push_back(reader.row().str());
+        continue;
+      }
+    } else if (type == "-" && reader.fieldCount() >= 4 && slot.live) {
+      try {
+        auto lesson = findLesson(contents.lessons, slot.lessons,
+                                 reader[2].toInt(), reader[3].str());
+        if (lesson != slot.lessons.end()) slot.lessons.erase(lesson);
+      } catch (const exception&) {
+        contents.badLines.push_back(reader.row().str());
+        continue;
+      }
+    } else {
+      contents.badLines.push_back(reader.row().str());
+      continue;
+    }
+    contents.records++;
+  }
+
+  for (uint32_t index : slotOf) {
+    if (index == NO_SLOT || !slots[index].live) continue;
+    contents.scheduleIds.push_back(slots[index].scheduleId);
+    contents.scheduleLessons.push_back(move(slots[index].lessons));
+  }
+  return true;
+}
+
+bool ScheduleStore::compact(const string& path, size_t* bytesWritten) {
+  Contents contents;
+  if (!read(path, contents)) return false;
+
+  // Write next to the store and move it over, so a crash never leaves the
+  // store torn or missing
+  string tempPath = path + ".tmp";
+  size_t bytes = 0;
+  {
+    ofstream file(tempPath, ios::trunc);
+    if (!file.is_open()) return false;
+    string block = HEADER + '\n';
+    for (size_t i = 0; i < contents.scheduleIds.size(); i++) {
+      int scheduleId = contents.scheduleIds[i];
+      block += "S," + to_string(scheduleId) + '\n';
+      for (LessonRef lesson : contents.scheduleLessons[i]) {
+        block += "+," + formatRow(scheduleId, contents.lessons.view(lesson));
+        block += '\n';
+      }
+      if (block.size() >= 64 * 1024) {
+        file.write(block.data(), static_cast<streamsize>(block.size()));
+        bytes += block.size();
+        block.clear();
+      }
+    }
+    file.write(block.data(), static_cast<streamsize>(block.size()));
+    bytes += block.size();
+    if (!file.good()) return false;
+  }
+  if (!PersistenceQueue::commitFile(tempPath, path)) return false;
+
+  if (bytesWritten) *bytesWritten = bytes;
+  return true;
+}
+
+bool ScheduleStore::recover(const string& path) {
+  string tempPath = path + ".tmp";
+  int64_t size = 0;
+  int64_t mtime = 0;
+  if (!CatalogSnapshot::statFile(tempPath, size, mtime)) return false;
+  if (CatalogSnapshot::statFile(path, size, mtime)) {
+    remove(tempPath.c_str());
+    return false;
+  }
+  return PersistenceQueue::commitFile(tempPath, path);
+}
+
+string ScheduleStore::formatRow(int scheduleId, const LessonView& lesson) {
+  int durationHours =
+      lesson.getDuration() / 60;  // Convert minutes back to hours for CSV
+  ostringstream row;
+  row << scheduleId << "," << lesson.getLessonType() << ","
+      << lesson.getCourseId() << "," << lesson.getDay() << ","
+      << lesson.getStartTime() << "," << durationHours << ","
+      << lesson.getClassroom() << "," << lesson.getBuilding() << ","
+      << lesson.getTeacher() << "," << lesson.getGroupId();
+  return row.str();
+}
+
+// =================== SCHEDULE IDS ===================
+
+void ScheduleStore::attach(const string& storePath, const Contents& contents) {
+  path = storePath;
+  live.assign(1, false);
+  freeIds.clear();
+  nextId = 1;
+  liveCount = 0;
+  for (int scheduleId : contents.scheduleIds) {
+    if (static_cast<size_t>(scheduleId) >= live.size()) {
+      live.resize(scheduleId + 1, false);
+    }
+    live[scheduleId] = true;
+    liveCount++;
+    nextId = max(nextId, scheduleId + 1);
+  }
+  // Gaps are free; push them high to low so the smallest is reused first
+  for (int last = nextId - 1; last >= 1; last--) {
+    if (live[last]) continue;
+    int first = last;
+    while (first > 1 && !live[first - 1]) first--;
+    freeIds.push_back({first, last});
+    last = first;
+  }
+
+  int64_t size = 0;
+  int64_t mtime = 0;
+  if (!CatalogSnapshot::statFile(path, size, mtime)) {
+    size = static_cast<int64_t>(HEADER.size() + 1);
+    if (queue) {
+      queue->replaceFile(path, HEADER + '\n');
+    } else {
+      ofstream file(path, ios::trunc);
+      file << HEADER << '\n';
+    }
+  }
+  compactedBytes->store(static_cast<size_t>(size));
+  appendedBytes = 0;
+}
+
+int ScheduleStore::allocateId() {
+  while (!freeIds.empty()) {
+    IdRange& range = freeIds.back();
+    int id = range.first++;
+    if (range.first > range.last) freeIds.pop_back();
+    if (!contains(id)) return id;  // Else claimed explicitly meanwhile
+  }
+  while (contains(nextId)) nextId++;
+  return nextId <= MAX_SCHEDULE_ID ? nextId++ : -1;
+}
+
+int ScheduleStore::createSchedule(int scheduleId) {
+  if (scheduleId == -1) {
+    scheduleId = allocateId();
+    if (scheduleId == -1) return -1;
+  } else if (scheduleId <= 0 || scheduleId > MAX_SCHEDULE_ID ||
+             contains(scheduleId)) {
+    return -1;
+  } else {
+    // IDs skipped on the way to an explicit one become free
+    if (scheduleId > nextId) freeIds.push_back({nextId, scheduleId - 1});
+    nextId = max(nextId, scheduleId + 1);
+  }
+
+  if (static_cast<size_t>(scheduleId) >= live.size()) {
+    live.resize(max(static_cast<size_t>(scheduleId) + 1, live.size() * 2),
+                false);
+  }
+  live[scheduleId] = true;
+  liveCount++;
+  append("S," + to_string(scheduleId));
+  return scheduleId;
+}
+
+bool ScheduleStore::deleteSchedule(int scheduleId) {
+  if (!contains(scheduleId)) return false;
+  live[scheduleId] = false;
+  liveCount--;
+  freeIds.push_back({scheduleId, scheduleId});
+  append("D," + to_string(scheduleId));
+  return true;
+}
+
+bool ScheduleStore::contains(int scheduleId) const {
+  return scheduleId > 0 && static_cast<size_t>(scheduleId) < live.size() &&
+         live[scheduleId];
+}
+
+// =================== LESSON RECORDS ===================
+
+bool ScheduleStore::recordAdd(int scheduleId, const LessonView& lesson) {
+  return append("+," + formatRow(scheduleId, lesson));
+}
+
+bool ScheduleStore::recordRemove(int scheduleId, int courseId,
+                                 const string& groupId) {
+  return append("-," + to_string(scheduleId) + "," + to_string(courseId) +
+                "," + groupId);
+}
+
+bool ScheduleStore::append(const string& record) {
+  string line = record + '\n';
+  bool written = true;
+  if (queue) {
+    queue->appendFile(path, line);
+  } else {
+    ofstream file(path, ios::app);
+    file << line;
+    written = file.good();
+  }
+  if (!written) return false;
+
+  // Compact once the log has grown by as much as the file it started from
+  appendedBytes += line.size();
+  if (appendedBytes >= max(threshold, compactedBytes->load())) {
+    appendedBytes = 0;
+    string storePath = path;
+    shared_ptr<atomic<size_t>> sizeSlot = compactedBytes;
+    auto task = [storePath, sizeSlot] {
+      size_t bytes = 0;
+      if (compact(storePath, &bytes)) sizeSlot->store(bytes);
+    };
+    if (queue) {
+      queue->runTask(task);  // Runs after the records ahead of it
+    } else {
+      task();
+    }
+  }
+  return true;
+}
@@ -0,0 +1,171 @@
+#ifndef SCHEDULE_STORE_H
+#define SCHEDULE_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LessonTable.h"
+#include "PersistenceQueue.h"
+
+using namespace std;
+
+/**
+ * @class ScheduleStore
+ * @brief All schedules in one append-only file with stable IDs
+ *
+ * Every schedule used to live in its own data/schedule_N.csv, listed in
+ * data/schedules.csv. Deleting one renamed every later file down by one,
+ * and finding them meant probing schedule_1.csv to schedule_20.csv. The
+ * store keeps every schedule in data/schedule_store.csv as a log of
+ * records:
+ *   S,<scheduleId>                      schedule created
+ *   D,<scheduleId>                      schedule deleted
+ *   +,<schedule CSV row>                lesson added (row starts with the ID)
+ *   -,<scheduleId>,<courseId>,<groupId> lesson removed
+ * Creating or deleting a schedule appends one record, so both are O(1)
+ * however many schedules there are. IDs never change; deleted IDs go on a
+ * free list of ID ranges and are handed out again, smallest first after a
+ * restart.
+ *
+ * Once the records appended since the last compaction outgrow the file
+ * they were appended to, compact() replays the log into one S record per
+ * live schedule followed by its lessons. With a PersistenceQueue, records
+ * and compactions run on its flusher thread.
+ *
+ * Records act on (course, group) keys: an add is skipped when the key is
+ * already in the schedule and a remove drops the first row with the key.
+ * A record cut short by a crash has no line break and is ignored.
+ */
+class ScheduleStore {
+ public:
+  /** @brief Store file name inside the data directory */
+  static const string FILE_NAME;
+
+  /** @brief First line of a store file */
+  static const string HEADER;
+
+  /** @brief Log growth that triggers compaction, at minimum */
+  static const size_t DEFAULT_COMPACT_BYTES = 64 * 1024;
+
+  /**
+   * @brief Highest schedule ID a store accepts
+   *
+   * The store, read() and ScheduleIndex keep arrays indexed by ID, so this
+   * bounds them: at most 16 MB per 4-byte entry.
+   */
+  static const int MAX_SCHEDULE_ID = 1 << 22;
+
+  /**
+   * @brief Schedules and lessons replayed from a store file
+   */
+  struct Contents {
+    LessonTable lessons;                        // Rows of all schedules
+    vector<int> scheduleIds;                    // Live schedules, ascending
+    vector<vector<LessonRef>> scheduleLessons;  // Rows of each schedule
+    vector<string> badLines;                    // Records that did not parse
+    size_t records = 0;                         // Records applied
+  };
+
+  /**
+   * @param queue Writes records in the background when not null
+   * @param compactBytes Minimum log growth that triggers compaction
+   */
+  explicit ScheduleStore(PersistenceQueue* queue = nullptr,
+                         size_t compactBytes = DEFAULT_COMPACT_BYTES);
+
+  /**
+   * @brief Replay a store file
+   * @return false if the file does not exist or cannot be read
+   */
+  static bool read(const string& path, Contents& contents);
+
+  /**
+   * @brief Rewrite a store file as its live schedules only
+   * @param bytesWritten Receives the new file size (may be null)
+   * @return false if the file could not be rewritten; it is left as it was
+   */
+  static bool compact(const string& path, size_t* bytesWritten = nullptr);
+
+  /**
+   * @brief Finish or discard a replacement a crash left behind; call before
+   *        read()
+   *
+   * A leftover `path`.tmp beside a missing store was complete (earlier
+   * builds removed the store before renaming), so it takes the store's
+   * place. Beside an existing store it may be torn and is deleted.
+   * @return true if the store was restored from the temp file
+   */
+  static bool recover(const string& path);
+
+  /** @brief A lesson as a schedule CSV row, without a line break */
+  static string formatRow(int scheduleId, const LessonView& lesson);
+
+  /**
+   * @brief Start recording into `path`, which holds `contents` (as read()
+   *        returned them, or empty for a new file)
+   *
+   * Rebuilds the free list from the gaps between live IDs and creates the
+   * file if it does not exist yet.
+   */
+  void attach(const string& path, const Contents& contents);
+
+  /**
+   * @brief Create a schedule
+   * @param scheduleId The ID to use, or -1 for the next free one
+   * @return The new ID, or -1 if the ID is taken or out of range
+   */
+  int createSchedule(int scheduleId = -1);
+
+  /**
+   * @brief Delete a schedule and free its ID
+   * @return false if no such schedule exists
+   */
+  bool deleteSchedule(int scheduleId);
+
+  bool contains(int scheduleId) const;
+
+  /** @brief Number of live schedules */
+  size_t size() const { return liveCount; }
+
+  /**
+   * @brief Record an added lesson
+   * @return false if the record could not be written
+   */
+  bool recordAdd(int scheduleId, const LessonView& lesson);
+
+  /** @brief Record a removed lesson */
+  bool recordRemove(int scheduleId, int courseId, const string& groupId);
+
+ private:
+  ScheduleStore(const ScheduleStore&) = delete;
+  ScheduleStore& operator=(const ScheduleStore&) = delete;
+
+  // Free IDs as [first, last] ranges, so skipping to an explicit ID is
+  // O(1); the next one to reuse is the first of the last range
+  struct IdRange {
+    int first;
+    int last;
+  };
+
+  bool append(const string& record);
+  int allocateId();
+
+  PersistenceQueue* queue;
+  size_t threshold;
+  string path;
+
+  vector<bool> live;        // Indexed by schedule ID
+  vector<IdRange> freeIds;  // Released and skipped IDs
+  int nextId;               // Lowest ID never handed out
+  size_t liveCount;
+
+  // Bytes appended since the last compaction, and the size of the file
+  // that compaction wrote (set by the flusher thread)
+  size_t appendedBytes;
+  shared_ptr<atomic<size_t>> compactedBytes;
+};
+
+#endif  // SCHEDULE_STORE_H
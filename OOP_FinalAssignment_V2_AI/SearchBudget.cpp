@@ -0,0 +1,20 @@
+#include "SearchBudget.h"
+
+SearchBudget::SearchBudget(double milliseconds,
+                           const CancellationToken* token)
+    : start(chrono::steady_clock::now()),
+      limit(milliseconds > 0 ? milliseconds : 0),
+      token(token) {
+  deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(
+                         chrono::duration<double, milli>(limit));
+}
+
+bool SearchBudget::expired() const {
+  if (cancelled()) return true;
+  return limit > 0 && chrono::steady_clock::now() >= deadline;
+}
+
+double SearchBudget::elapsedMs() const {
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+      .count();
+}
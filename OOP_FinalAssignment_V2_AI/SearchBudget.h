@@ -0,0 +1,68 @@
+#ifndef SEARCH_BUDGET_H
+#define SEARCH_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+/**
+ * @class CancellationToken
+ * @brief Flag another thread raises to stop a running search
+ *
+ * The caller keeps the token and hands its address to the search; cancel()
+ * may be called from any thread, at any time, any number of times.
+ */
+class CancellationToken {
+ public:
+  CancellationToken() : cancelled(false) {}
+
+  void cancel() { cancelled.store(true); }
+  void reset() { cancelled.store(false); }
+  bool isCancelled() const { return cancelled.load(); }
+
+ private:
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  atomic<bool> cancelled;
+};
+
+/**
+ * @class SearchBudget
+ * @brief Wall-clock deadline plus an optional cancellation token
+ *
+ * The clock starts when the budget is constructed. An anytime search polls
+ * expired() between units of work and, once it is true, stops and keeps
+ * the best answer found so far. expired() only reads the clock and an
+ * atomic flag, so every thread of a search can poll the same budget.
+ */
+class SearchBudget {
+ public:
+  /**
+   * @param milliseconds Time allowed; 0 or less means no time limit
+   * @param token Stops the search early once cancelled; may be null
+   */
+  explicit SearchBudget(double milliseconds = 0,
+                        const CancellationToken* token = nullptr);
+
+  /** @brief The deadline has passed or the token was cancelled */
+  bool expired() const;
+
+  /** @brief True if the token, not the clock, stopped the search */
+  bool cancelled() const { return token && token->isCancelled(); }
+
+  /** @brief Time since the budget was constructed */
+  double elapsedMs() const;
+
+  /** @brief Time allowed, 0 when unlimited */
+  double limitMs() const { return limit; }
+
+ private:
+  chrono::steady_clock::time_point start;
+  chrono::steady_clock::time_point deadline;
+  double limit;
+  const CancellationToken* token;
+};
+
+#endif  // SEARCH_BUDGET_H
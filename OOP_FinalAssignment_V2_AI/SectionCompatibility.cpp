@@ -0,0 +1,54 @@
+#include "SectionCompatibility.h"
+
+#include <algorithm>
+
+void SectionCompatibility::build(const LessonTable& table) {
+  clear();
+  sections = table.size();
+  rowWords = (sections + 63) / 64;
+  bits.assign(sections * rowWords, 0);
+
+  // Timed sections in (day, start) order
+  vector<LessonRef> order;
+  order.reserve(sections);
+  for (LessonRef lesson = 0; lesson < sections; lesson++) {
+    if (table.startMinute(lesson) != LessonTable::NO_START &&
+        table.durationMinutes(lesson) > 0) {
+      order.push_back(lesson);
+    }
+  }
+  sort(order.begin(), order.end(), [&table](LessonRef a, LessonRef b) {
+    if (table.dayIndex(a) != table.dayIndex(b)) {
+      return table.dayIndex(a) < table.dayIndex(b);
+    }
+    return table.startMinute(a) < table.startMinute(b);
+  });
+
+  // Everything that starts before a section ends, on its day, clashes
+  for (size_t i = 0; i < order.size(); i++) {
+    LessonRef lesson = order[i];
+    int end = table.startMinute(lesson) + table.durationMinutes(lesson);
+    for (size_t j = i + 1; j < order.size(); j++) {
+      LessonRef other = order[j];
+      if (table.dayIndex(other) != table.dayIndex(lesson) ||
+          table.startMinute(other) >= end) {
+        break;
+      }
+      set(lesson, other);
+      set(other, lesson);
+    }
+  }
+}
+
+void SectionCompatibility::clear() {
+  sections = 0;
+  rowWords = 0;
+  bits.clear();
+  bits.shrink_to_fit();
+}
+
+void SectionCompatibility::swap(SectionCompatibility& other) {
+  std::swap(sections, other.sections);
+  std::swap(rowWords, other.rowWords);
+  bits.swap(other.bits);
+}
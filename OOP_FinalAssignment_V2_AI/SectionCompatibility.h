@@ -0,0 +1,68 @@
+#ifndef SECTION_COMPATIBILITY_H
+#define SECTION_COMPATIBILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class SectionCompatibility
+ * @brief Which catalog sections clash in time, one bit per pair
+ *
+ * The optimizer and the conflict resolver ask "does group A of course X
+ * overlap group B of course Y?" for the same catalog pairs over and over.
+ * build() answers all of them once: every catalog row gets a bitset row in
+ * which bit j is set when row j runs on the same day at an overlapping
+ * time. A section is its LessonRef, so rows added to the table after the
+ * build (copies kept only by a saved schedule) are not covered; callers
+ * check covers() and compare the times themselves for those.
+ *
+ * The rows are filled by sorting the sections by (day, start) and walking
+ * forward from each one while the next section starts before it ends, so
+ * the build costs O(n log n + k) for k clashing pairs on top of zeroing the
+ * n x n bits. Rebuild whenever the catalog changes.
+ */
+class SectionCompatibility {
+ public:
+  /** @brief Cover every row of `table`, all of them catalog sections */
+  void build(const LessonTable& table);
+
+  void clear();
+  void swap(SectionCompatibility& other);
+
+  /** @brief Number of covered sections */
+  size_t size() const { return sections; }
+
+  bool covers(LessonRef lesson) const { return lesson < sections; }
+
+  /** @brief True if two covered sections overlap in time */
+  bool clash(LessonRef first, LessonRef second) const {
+    return (row(first)[second / 64] >> (second % 64)) & 1;
+  }
+
+  /** @brief Clash bits of one covered section, wordsPerRow() words */
+  const uint64_t* row(LessonRef lesson) const {
+    return bits.data() + static_cast<size_t>(lesson) * rowWords;
+  }
+
+  size_t wordsPerRow() const { return rowWords; }
+
+  /** @brief Bytes held by the bit rows */
+  size_t memoryBytes() const { return bits.capacity() * sizeof(uint64_t); }
+
+ private:
+  void set(LessonRef first, LessonRef second) {
+    bits[static_cast<size_t>(first) * rowWords + second / 64] |=
+        1ULL << (second % 64);
+  }
+
+  size_t sections = 0;
+  size_t rowWords = 0;
+  vector<uint64_t> bits;  // sections rows of rowWords words
+};
+
+#endif  // SECTION_COMPATIBILITY_H
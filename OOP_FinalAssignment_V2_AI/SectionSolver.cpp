@@ -0,0 +1,116 @@
+#include "SectionSolver.h"
+
+#include <algorithm>
+
+SectionSolver::SectionSolver(const CourseLessonIndex& lessonIndex,
+                             const SectionCompatibility& compatibility,
+                             const SchedulePreferences* preferences)
+    : lessonIndex(&lessonIndex),
+      compatibility(&compatibility),
+      preferences(preferences && preferences->active() ? preferences
+                                                       : nullptr) {}
+
+bool SectionSolver::solve(const vector<int>& courseIds,
+                          vector<LessonRef>& assignment) {
+  assignment.clear();
+  variables.clear();
+  trail.clear();
+  nodes = 0;
+  fill(dayMinutes, dayMinutes + SchedulePreferences::DAYS + 1, 0);
+
+  for (int courseId : courseIds) {
+    for (LessonTable::Kind kind :
+         {LessonTable::LECTURE, LessonTable::TUTORIAL, LessonTable::LAB}) {
+      const vector<LessonRef>& groups = lessonIndex->groups(courseId, kind);
+      if (groups.empty()) continue;  // The course has no lessons of this type
+
+      Variable variable;
+      if (preferences) {
+        for (LessonRef group : groups) {
+          if (preferences->allowed(group)) variable.groups.push_back(group);
+        }
+        if (variable.groups.empty()) return false;  // Every group is ruled out
+      } else {
+        variable.groups = groups;
+      }
+      variable.live.assign(variable.groups.size(), 1);
+      variable.liveCount = variable.groups.size();
+      variables.push_back(move(variable));
+    }
+  }
+
+  if (!search(variables.size())) return false;
+  for (const Variable& variable : variables) {
+    assignment.push_back(variable.groups[variable.chosen]);
+  }
+  return true;
+}
+
+bool SectionSolver::search(size_t remaining) {
+  if (remaining == 0) return true;
+
+  // Branch on the unassigned variable with the fewest groups left
+  size_t best = variables.size();
+  for (size_t i = 0; i < variables.size(); i++) {
+    if (variables[i].assigned) continue;
+    if (best == variables.size() ||
+        variables[i].liveCount < variables[best].liveCount) {
+      best = i;
+    }
+  }
+
+  Variable& variable = variables[best];
+  variable.assigned = true;
+  int limit = preferences ? preferences->maxDailyMinutes() : 0;
+  for (size_t group = 0; group < variable.groups.size(); group++) {
+    if (!variable.live[group]) continue;
+    LessonRef section = variable.groups[group];
+    int day = 0;
+    int minutes = 0;
+    if (limit > 0 && preferences->covers(section)) {
+      day = preferences->day(section);
+      minutes = preferences->minutes(section);
+      if (day < SchedulePreferences::DAYS &&
+          dayMinutes[day] + minutes > limit) {
+        continue;
+      }
+    }
+    nodes++;
+    variable.chosen = group;
+    dayMinutes[day] += minutes;
+
+    size_t mark = trail.size();
+    if (forwardCheck(best, group) && search(remaining - 1)) return true;
+    undoTo(mark);
+    dayMinutes[day] -= minutes;
+  }
+  variable.assigned = false;
+  return false;
+}
+
+bool SectionSolver::forwardCheck(size_t variable, size_t group) {
+  LessonRef chosen = variables[variable].groups[group];
+  for (size_t i = 0; i < variables.size(); i++) {
+    Variable& other = variables[i];
+    if (other.assigned) continue;
+    for (size_t candidate = 0; candidate < other.groups.size(); candidate++) {
+      if (other.live[candidate] &&
+          compatibility->clash(chosen, other.groups[candidate])) {
+        other.live[candidate] = 0;
+        other.liveCount--;
+        trail.push_back({i, candidate});
+      }
+    }
+    if (other.liveCount == 0) return false;  // Wiped out; back out now
+  }
+  return true;
+}
+
+void SectionSolver::undoTo(size_t trailSize) {
+  while (trail.size() > trailSize) {
+    const Removal& removal = trail.back();
+    variables[removal.variable].live[removal.group] = 1;
+    variables[removal.variable].liveCount++;
+    trail.pop_back();
+  }
+}
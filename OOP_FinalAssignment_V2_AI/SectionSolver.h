@@ -0,0 +1,84 @@
+#ifndef SECTION_SOLVER_H
+#define SECTION_SOLVER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "CourseLessonIndex.h"
+#include "LessonTable.h"
+#include "SchedulePreferences.h"
+#include "SectionCompatibility.h"
+
+using namespace std;
+
+/**
+ * @class SectionSolver
+ * @brief Exact choice of one group per lesson type per course, without
+ *        any two chosen lessons overlapping
+ *
+ * Each (course, lesson type) the catalog offers is a variable whose values
+ * are the type's groups. The search is a DFS:
+ *   - most-constrained first: branch on the variable with the fewest
+ *     groups left
+ *   - forward checking: after choosing a group, drop every group of the
+ *     remaining variables that clashes with it - one bit of its
+ *     SectionCompatibility row - and back out as soon as a variable has
+ *     none left
+ * Dropped groups go on a trail and come back when the search backs out, so
+ * nothing is copied per node. The search either returns a conflict-free
+ * assignment or, having exhausted the tree, proves none exists.
+ *
+ * Groups come from the CourseLessonIndex, so they are catalog sections and
+ * the compatibility matrix covers all of them.
+ *
+ * With SchedulePreferences, groups outside the allowed times and days are
+ * left out of the domains up front (one bit test each), and a group that
+ * would push its day past the daily maximum is skipped while branching.
+ */
+class SectionSolver {
+ public:
+  /** @param preferences Compiled for this catalog; may be null */
+  SectionSolver(const CourseLessonIndex& lessonIndex,
+                const SectionCompatibility& compatibility,
+                const SchedulePreferences* preferences = nullptr);
+
+  /**
+   * @brief Choose groups for the courses
+   * @param assignment Receives one lesson per offered type, course by course
+   *        in Lecture, Tutorial, Lab order; empty when there is none
+   * @return false if every choice has two overlapping lessons or breaks
+   *         a preference
+   */
+  bool solve(const vector<int>& courseIds, vector<LessonRef>& assignment);
+
+  /** @brief Groups tried by the last solve() */
+  size_t nodesVisited() const { return nodes; }
+
+ private:
+  struct Variable {
+    vector<LessonRef> groups;
+    vector<char> live;  // Not dropped by forward checking
+    size_t liveCount = 0;
+    size_t chosen = 0;
+    bool assigned = false;
+  };
+
+  struct Removal {
+    size_t variable;
+    size_t group;
+  };
+
+  bool search(size_t remaining);
+  bool forwardCheck(size_t variable, size_t group);
+  void undoTo(size_t trailSize);
+
+  const CourseLessonIndex* lessonIndex;
+  const SectionCompatibility* compatibility;
+  const SchedulePreferences* preferences;
+  int dayMinutes[SchedulePreferences::DAYS + 1];  // Chosen so far, per day
+  vector<Variable> variables;
+  vector<Removal> trail;
+  size_t nodes = 0;
+};
+
+#endif  // SECTION_SOLVER_H
@@ -0,0 +1,121 @@
+#include "StringPool.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char* const DAY_NAMES[7] = {"Sunday",   "Monday", "Tuesday",
+                                  "Wednesday", "Thursday", "Friday",
+                                  "Saturday"};
+
+// Hash node of the ID map: key, ID and next pointer
+const size_t HASH_NODE_BYTES = 2 * sizeof(void*) + sizeof(size_t) +
+                               sizeof(uint32_t) + sizeof(void*);
+
+}  // namespace
+
+StringPool& StringPool::global() {
+  static StringPool pool;
+  return pool;
+}
+
+StringPool::StringPool() : count(0), internCalls(0), copyBytes(0) {
+  for (int i = 0; i < MAX_CHUNKS; i++) chunks[i] = nullptr;
+
+  // Fixed IDs: "" = 0, then the weekdays in day-index order
+  insert("", 0);
+  for (const char* day : DAY_NAMES) insert(day, strlen(day));
+}
+
+StringPool::~StringPool() {
+  for (int i = 0; i < MAX_CHUNKS; i++) delete[] chunks[i];
+}
+
+// =================== INTERNING ===================
+
+uint32_t StringPool::intern(const char* data, size_t size) {
+  lock_guard<mutex> lock(poolMutex);
+  internCalls++;
+  copyBytes += stringBytes(size);
+
+  Key key = {data, size};
+  auto it = ids.find(key);
+  if (it != ids.end()) return it->second;
+  return insert(data, size);
+}
+
+bool StringPool::find(const string& value, uint32_t& id) const {
+  lock_guard<mutex> lock(poolMutex);
+  Key key = {value.data(), value.size()};
+  auto it = ids.find(key);
+  if (it == ids.end()) return false;
+  id = it->second;
+  return true;
+}
+
+uint32_t StringPool::insert(const char* data, size_t size) {
+  if (count >= MAX_STRINGS) throw length_error("StringPool strings");
+
+  uint32_t id = count;
+  uint32_t offset = id + FIRST_CHUNK_SIZE;
+  int chunk = highestBit(offset) - FIRST_CHUNK_BITS;
+  if (chunks[chunk] == nullptr) {
+    chunks[chunk] = new string[FIRST_CHUNK_SIZE << chunk];
+  }
+  string& slot = chunks[chunk][offset - (FIRST_CHUNK_SIZE << chunk)];
+  slot.assign(data, size);
+
+  // The key views the stored copy, which never moves
+  Key key = {slot.data(), slot.size()};
+  ids.emplace(key, id);
+  count++;
+  return id;
+}
+
+// =================== STATISTICS ===================
+
+size_t StringPool::size() const {
+  lock_guard<mutex> lock(poolMutex);
+  return count;
+}
+
+StringPool::Stats StringPool::stats() const {
+  lock_guard<mutex> lock(poolMutex);
+  Stats result;
+  result.internCalls = internCalls;
+  result.uniqueStrings = count;
+  result.copyBytes = copyBytes;
+
+  size_t bytes = sizeof(StringPool);
+  for (int i = 0; i < MAX_CHUNKS && chunks[i] != nullptr; i++) {
+    bytes += (FIRST_CHUNK_SIZE << i) * sizeof(string);
+  }
+  for (uint32_t id = 0; id < count; id++) {
+    bytes += stringBytes(str(id).size()) - sizeof(string);  // Heap only
+  }
+  bytes += ids.size() * HASH_NODE_BYTES + ids.bucket_count() * sizeof(void*);
+  result.poolBytes = bytes;
+  return result;
+}
+
+size_t StringPool::stringBytes(size_t length) {
+  // Short values fit the small-string buffer (15 chars in libstdc++ and
+  // MSVC); longer ones add a heap block of length + 1
+  return sizeof(string) + (length > 15 ? length + 1 : 0);
+}
+
+size_t StringPool::KeyHash::operator()(const Key& key) const {
+  // FNV-1a
+  size_t hash = static_cast<size_t>(14695981039346656037ULL);
+  for (size_t i = 0; i < key.size; i++) {
+    hash ^= static_cast<unsigned char>(key.data[i]);
+    hash *= static_cast<size_t>(1099511628211ULL);
+  }
+  return hash;
+}
+
+bool StringPool::KeyEqual::operator()(const Key& a, const Key& b) const {
+  return a.size == b.size &&
+         (a.size == 0 || memcmp(a.data, b.data, a.size) == 0);
+}
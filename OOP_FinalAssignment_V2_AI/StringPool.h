@@ -0,0 +1,185 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @class StringPool
+ * @brief Process-wide store of unique strings with dense 32-bit IDs
+ *
+ * Teacher, room, building and day names repeat thousands of times across
+ * the catalog and the schedules. Each distinct value is kept once here and
+ * everything else holds its ID (see Symbol), so equality is an integer
+ * compare and copies never touch the heap.
+ *
+ * ID 0 is the empty string and IDs 1..7 are Sunday ... Saturday, which
+ * makes a day symbol its own day index.
+ *
+ * intern() is serialized by a mutex (the loaders run on a worker pool);
+ * str() takes no lock. Strings live in chunks of doubling size (64, 128,
+ * 256, ...) that are never reallocated, so a returned reference stays valid
+ * for the life of the process.
+ */
+class StringPool {
+ public:
+  /** @brief ID of the first day name; Sunday = FIRST_DAY, Saturday + 6 */
+  static const uint32_t FIRST_DAY = 1;
+
+  /** @brief Counters behind the "memory saved" report */
+  struct Stats {
+    size_t internCalls;    // Strings handed to intern()
+    size_t uniqueStrings;  // Distinct values stored
+    size_t copyBytes;      // Bytes the interned values would take as strings
+    size_t poolBytes;      // Bytes the pool itself holds
+  };
+
+  static StringPool& global();
+
+  /** @return ID of the value, adding it on first sight */
+  uint32_t intern(const char* data, size_t size);
+  uint32_t intern(const string& value) {
+    return intern(value.data(), value.size());
+  }
+
+  /**
+   * @brief ID of a value without adding it
+   * @return false if the value was never interned
+   */
+  bool find(const string& value, uint32_t& id) const;
+
+  /** @brief Value of an ID returned by intern() */
+  const string& str(uint32_t id) const {
+    uint32_t offset = id + FIRST_CHUNK_SIZE;
+    int chunk = highestBit(offset) - FIRST_CHUNK_BITS;
+    return chunks[chunk][offset - (FIRST_CHUNK_SIZE << chunk)];
+  }
+
+  size_t size() const;
+  Stats stats() const;
+
+  /** @brief Bytes a std::string of this length occupies, heap included */
+  static size_t stringBytes(size_t length);
+
+ private:
+  // Chunk k holds FIRST_CHUNK_SIZE << k strings; ID + FIRST_CHUNK_SIZE has
+  // its highest bit at FIRST_CHUNK_BITS + k
+  static const int FIRST_CHUNK_BITS = 6;
+  static const uint32_t FIRST_CHUNK_SIZE = 1u << FIRST_CHUNK_BITS;
+  static const int MAX_CHUNKS = 32 - FIRST_CHUNK_BITS;
+  static const uint32_t MAX_STRINGS = 0u - FIRST_CHUNK_SIZE;
+
+  static int highestBit(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return static_cast<int>(index);
+#else
+    return 31 - __builtin_clz(value);
+#endif
+  }
+
+  // Hash key viewing a stored string, so lookups need no temporary copy
+  struct Key {
+    const char* data;
+    size_t size;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct KeyEqual {
+    bool operator()(const Key& a, const Key& b) const;
+  };
+
+  StringPool();
+  ~StringPool();
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  uint32_t insert(const char* data, size_t size);
+
+  mutable mutex poolMutex;
+  string* chunks[MAX_CHUNKS];
+  uint32_t count;
+  unordered_map<Key, uint32_t, KeyHash, KeyEqual> ids;
+  size_t internCalls;
+  size_t copyBytes;
+};
+
+/**
+ * @class Symbol
+ * @brief Interned string handle: 4 bytes, integer compare
+ *
+ * Built implicitly from a string so it can replace string members without
+ * touching their producers; converts back to const string& for printing
+ * and for code that needs the text.
+ */
+class Symbol {
+ public:
+  Symbol() : id(0) {}
+  Symbol(const string& value) : id(StringPool::global().intern(value)) {}
+  Symbol(const char* value)
+      : id(StringPool::global().intern(value, char_traits<char>::length(
+                                                  value))) {}
+  Symbol(const char* data, size_t size)
+      : id(StringPool::global().intern(data, size)) {}
+
+  uint32_t getId() const { return id; }
+  const string& str() const { return StringPool::global().str(id); }
+  operator const string&() const { return str(); }
+  bool empty() const { return id == 0; }
+
+  /** @return 0 (Sunday) ... 6 (Saturday), or -1 if not a day name */
+  int dayIndex() const {
+    return id >= StringPool::FIRST_DAY && id < StringPool::FIRST_DAY + 7
+               ? static_cast<int>(id - StringPool::FIRST_DAY)
+               : -1;
+  }
+
+  friend bool operator==(const Symbol& a, const Symbol& b) {
+    return a.id == b.id;
+  }
+  friend bool operator!=(const Symbol& a, const Symbol& b) {
+    return a.id != b.id;
+  }
+  friend bool operator<(const Symbol& a, const Symbol& b) {
+    return a.str() < b.str();
+  }
+
+  // Text compares, so comparing with a literal never interns it
+  friend bool operator==(const Symbol& a, const string& b) {
+    return a.str() == b;
+  }
+  friend bool operator==(const string& a, const Symbol& b) {
+    return a == b.str();
+  }
+  friend bool operator==(const Symbol& a, const char* b) {
+    return a.str() == b;
+  }
+  friend bool operator!=(const Symbol& a, const string& b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const string& a, const Symbol& b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const Symbol& a, const char* b) { return !(a == b); }
+
+  friend ostream& operator<<(ostream& out, const Symbol& symbol) {
+    return out << symbol.str();
+  }
+
+ private:
+  uint32_t id;
+};
+
+#endif  // STRING_POOL_H
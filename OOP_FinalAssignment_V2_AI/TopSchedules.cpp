@@ -0,0 +1,77 @@
+#include "TopSchedules.h"
+
+#include <algorithm>
+
+TopSchedules::TopSchedules(size_t capacity, double minDistance)
+    : capacity(capacity), minDistance(minDistance) {
+  heap.reserve(capacity + 1);
+}
+
+bool TopSchedules::better(const Option& first, const Option& second) {
+  if (first.score != second.score) return first.score > second.score;
+  return first.candidate < second.candidate;
+}
+
+bool TopSchedules::admits(double score, size_t candidate) const {
+  if (capacity == 0) return false;
+  if (heap.size() < capacity) return true;
+  const Option& worst = heap.front();
+  return score > worst.score ||
+         (score == worst.score && candidate < worst.candidate);
+}
+
+bool TopSchedules::offer(Option& option) {
+  if (!admits(option.score, option.candidate)) return false;
+
+  // Identical course sets are always too similar, whatever the threshold
+  bool removedAny = false;
+  for (size_t i = 0; i < heap.size();) {
+    double distance = jaccardDistance(option.courseIds, heap[i].courseIds);
+    if (distance >= minDistance && distance > 0) {
+      i++;
+      continue;
+    }
+    if (!better(option, heap[i])) {
+      similarRejects++;
+      return false;
+    }
+    heap[i] = move(heap.back());
+    heap.pop_back();
+    removedAny = true;
+  }
+  if (removedAny) make_heap(heap.begin(), heap.end(), better);
+
+  heap.push_back(move(option));
+  push_heap(heap.begin(), heap.end(), better);
+  if (heap.size() > capacity) {
+    pop_heap(heap.begin(), heap.end(), better);
+    heap.pop_back();
+  }
+  return true;
+}
+
+vector<TopSchedules::Option> TopSchedules::sorted() const {
+  vector<Option> options = heap;
+  sort(options.begin(), options.end(), better);
+  return options;
+}
+
+double TopSchedules::jaccardDistance(const vector<int>& first,
+                                     const vector<int>& second) {
+  size_t shared = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < first.size() && j < second.size()) {
+    if (first[i] < second[j]) {
+      i++;
+    } else if (second[j] < first[i]) {
+      j++;
+    } else {
+      shared++;
+      i++;
+      j++;
+    }
+  }
+  size_t together = first.size() + second.size() - shared;
+  return together == 0 ? 0.0 : 1.0 - static_cast<double>(shared) / together;
+}
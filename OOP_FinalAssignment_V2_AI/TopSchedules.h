@@ -0,0 +1,75 @@
+#ifndef TOP_SCHEDULES_H
+#define TOP_SCHEDULES_H
+
+#include <cstddef>
+#include <vector>
+
+#include "LessonTable.h"
+
+using namespace std;
+
+/**
+ * @class TopSchedules
+ * @brief The K best schedules seen so far whose course sets differ enough
+ *
+ * A min-heap of at most K options, worst on top, so a schedule that cannot
+ * make the list is turned away with one comparison. Two options are too
+ * similar when the Jaccard distance of their course sets,
+ *   1 - |A and B| / |A or B|,
+ * is below the threshold. Of two similar options only the better one is
+ * kept: a newcomer either loses to a similar kept option or replaces every
+ * similar one. Every pair on the list is therefore at least the threshold
+ * apart, and memory stays O(K) however many schedules are offered.
+ *
+ * Not thread-safe; a parallel search offers under a lock. Which of a chain
+ * of similar options survives can depend on the order they arrive in.
+ */
+class TopSchedules {
+ public:
+  /** @brief One schedule on the list */
+  struct Option {
+    size_t candidate = 0;     // Position in the search, breaks score ties
+    vector<int> courseIds;    // Ascending
+    vector<LessonRef> lessons;
+    double credits = 0;
+    double score = 0;
+  };
+
+  /**
+   * @param capacity K
+   * @param minDistance Smallest Jaccard distance between two kept course
+   *        sets, in [0, 1]; 0 only turns away identical course sets
+   */
+  TopSchedules(size_t capacity, double minDistance);
+
+  /**
+   * @brief Consider a schedule; courseIds must be ascending
+   * @return true if it is now on the list (and option was moved there)
+   */
+  bool offer(Option& option);
+
+  /** @brief Whether a schedule with this score could still make the list */
+  bool admits(double score, size_t candidate) const;
+
+  size_t size() const { return heap.size(); }
+
+  /** @brief Offers turned away as too similar to a better kept option */
+  size_t rejectedAsSimilar() const { return similarRejects; }
+
+  /** @brief The list, best first */
+  vector<Option> sorted() const;
+
+  static double jaccardDistance(const vector<int>& first,
+                                const vector<int>& second);
+
+ private:
+  // Orders the heap worst-first: lower score, then later candidate
+  static bool better(const Option& first, const Option& second);
+
+  size_t capacity;
+  double minDistance;
+  vector<Option> heap;
+  size_t similarRejects = 0;
+};
+
+#endif  // TOP_SCHEDULES_H
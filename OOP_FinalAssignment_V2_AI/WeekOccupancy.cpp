@@ -0,0 +1,77 @@
+#include "WeekOccupancy.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace {
+
+// Bits [from, to) of one word, 0 <= from < to <= 64
+uint64_t wordMask(int from, int to) {
+  uint64_t high = to == 64 ? ~0ULL : (1ULL << to) - 1;
+  return high & ~((1ULL << from) - 1);
+}
+
+}  // namespace
+
+bool WeekOccupancy::slotRange(int day, int startMinute, int durationMinutes,
+                              int& first, int& last) {
+  if (day < 0 || day >= DAYS || durationMinutes <= 0) return false;
+  int endMinute = min(startMinute + durationMinutes, 24 * 60);
+  startMinute = max(startMinute, 0);
+  if (startMinute >= endMinute) return false;
+
+  int dayStart = day * SLOTS_PER_DAY;
+  first = dayStart + startMinute / SLOT_MINUTES;
+  last = dayStart + (endMinute + SLOT_MINUTES - 1) / SLOT_MINUTES;
+  return true;
+}
+
+void WeekOccupancy::set(int day, int startMinute, int durationMinutes) {
+  int first = 0, last = 0;
+  if (!slotRange(day, startMinute, durationMinutes, first, last)) return;
+  if (words.empty()) words.assign(WORDS, 0);
+  for (int word = first / 64; word * 64 < last; word++) {
+    words[word] |= wordMask(max(first - word * 64, 0),
+                            min(last - word * 64, 64));
+  }
+}
+
+void WeekOccupancy::clear(int day, int startMinute, int durationMinutes) {
+  int first = 0, last = 0;
+  if (words.empty() ||
+      !slotRange(day, startMinute, durationMinutes, first, last)) {
+    return;
+  }
+  for (int word = first / 64; word * 64 < last; word++) {
+    words[word] &= ~wordMask(max(first - word * 64, 0),
+                             min(last - word * 64, 64));
+  }
+}
+
+bool WeekOccupancy::hasConflict(int day, int startMinute,
+                                int durationMinutes) const {
+  int first = 0, last = 0;
+  if (words.empty() ||
+      !slotRange(day, startMinute, durationMinutes, first, last)) {
+    return false;
+  }
+  for (int word = first / 64; word * 64 < last; word++) {
+    if (words[word] & wordMask(max(first - word * 64, 0),
+                               min(last - word * 64, 64))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int WeekOccupancy::usedSlots() const {
+  int used = 0;
+  for (uint64_t word : words) {
+    used += static_cast<int>(bitset<64>(word).count());  // popcount
+  }
+  return used;
+}
+
+double WeekOccupancy::getUtilizationRatio() const {
+  return static_cast<double>(usedSlots()) / (DAYS * SLOTS_PER_DAY);
+}
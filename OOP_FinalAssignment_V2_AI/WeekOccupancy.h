@@ -0,0 +1,66 @@
+#ifndef WEEK_OCCUPANCY_H
+#define WEEK_OCCUPANCY_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class WeekOccupancy
+ * @brief Which 5-minute slots of the week are taken, one bit per slot
+ *
+ * 7 days x 288 slots = 2016 bits, packed day after day into 32 words. A
+ * lesson covers the slots from the one holding its start to the one holding
+ * its last minute, so two lessons that share a slot test as overlapping;
+ * lessons on 5-minute boundaries (all of the catalog) test exactly.
+ *
+ * set(), clear() and hasConflict() build one mask per 64-bit word the time
+ * range touches - at most 5 for a whole day - instead of looping over
+ * slots. The words are allocated by the first set(), so an empty week costs
+ * one empty vector.
+ *
+ * clear() drops the slots whatever set them; a caller that allows lessons
+ * to share a slot re-sets every remaining lesson that shares one of the
+ * cleared slots, not only those overlapping the cleared minutes (Schedule
+ * does).
+ */
+class WeekOccupancy {
+ public:
+  static const int DAYS = 7;
+  static const int SLOT_MINUTES = 5;
+  static const int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+
+  /**
+   * @brief Mark a time range as taken
+   * @param day 0 (Sunday) ... 6 (Saturday); other days are ignored
+   * @param startMinute Minutes after midnight; the range stops at midnight
+   */
+  void set(int day, int startMinute, int durationMinutes);
+
+  /** @brief Mark a time range as free */
+  void clear(int day, int startMinute, int durationMinutes);
+
+  /** @brief True if any slot of the range is taken */
+  bool hasConflict(int day, int startMinute, int durationMinutes) const;
+
+  /** @brief Taken slots over the whole week */
+  int usedSlots() const;
+
+  /** @brief Taken share of the week's 2016 slots, 0.0 ... 1.0 */
+  double getUtilizationRatio() const;
+
+  /** @brief Free every slot */
+  void reset() { words.clear(); }
+
+ private:
+  static const int WORDS = (DAYS * SLOTS_PER_DAY + 63) / 64;
+
+  // Bit range [first, last) of a time range; false if it covers nothing
+  static bool slotRange(int day, int startMinute, int durationMinutes,
+                        int& first, int& last);
+
+  vector<uint64_t> words;  // Empty until the first set()
+};
+
+#endif  // WEEK_OCCUPANCY_H
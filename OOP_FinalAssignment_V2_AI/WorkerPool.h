@@ -0,0 +1,70 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class WorkerPool
+ * @brief Fixed-size pool of worker threads for data-parallel loops
+ *
+ * The threads are started once and sleep between jobs. parallelFor() hands
+ * out loop indices one at a time from a shared counter, so uneven tasks
+ * (a large file next to a small one) still keep every core busy. The calling
+ * thread takes part in the loop, so a pool of size 1 runs it inline.
+ *
+ * Tasks must write only to their own output slot; callers merge the slots
+ * afterwards in index order to get a deterministic result.
+ */
+class WorkerPool {
+ public:
+  /**
+   * @param threadCount Total threads including the caller
+   *                    (0 = one per hardware core)
+   */
+  explicit WorkerPool(size_t threadCount = 0);
+  ~WorkerPool();
+
+  /** @brief Number of threads that run a parallelFor, including the caller */
+  size_t size() const { return workers.size() + 1; }
+
+  /**
+   * @brief Run task(0) ... task(count - 1) across the pool and wait for all
+   *
+   * The first exception thrown by a task is rethrown here once every thread
+   * has stopped. Not reentrant: a task must not call parallelFor itself.
+   */
+  void parallelFor(size_t count, const function<void(size_t)>& task);
+
+ private:
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void workerLoop();
+  void runTasks();
+
+  vector<thread> workers;
+  mutex stateMutex;
+  condition_variable jobReady;
+  condition_variable jobDone;
+
+  // Current job, guarded by stateMutex except for the index counter
+  const function<void(size_t)>* task;
+  size_t taskCount;
+  atomic<size_t> nextIndex;
+  uint64_t generation;     // Bumped once per parallelFor call
+  size_t pendingWorkers;   // Workers that have not finished this generation
+  exception_ptr firstError;
+  bool stopping;
+};
+
+#endif  // WORKER_POOL_H
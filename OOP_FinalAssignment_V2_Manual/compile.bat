@@ -10,12 +10,15 @@ g++ -std=c++14 -Wall -Wextra -Iinclude -c src/Lesson.cpp -o obj/Lesson.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/Lecture.cpp -o obj/Lecture.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/Tutorial.cpp -o obj/Tutorial.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/Lab.cpp -o obj/Lab.o
+g++ -std=c++14 -Wall -Wextra -Iinclude -c src/CsvReader.cpp -o obj/CsvReader.o
+g++ -std=c++14 -Wall -Wextra -Iinclude -c src/WorkerPool.cpp -o obj/WorkerPool.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/Schedule.cpp -o obj/Schedule.o
+g++ -std=c++14 -Wall -Wextra -Iinclude -c src/CourseGenome.cpp -o obj/CourseGenome.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/AdvancedScheduleAnalytics.cpp -o obj/AdvancedScheduleAnalytics.o
 g++ -std=c++14 -Wall -Wextra -Iinclude -c src/main.cpp -o obj/main.o
 
 REM Link all object files
-g++ obj/Course.o obj/Lesson.o obj/Lecture.o obj/Tutorial.o obj/Lab.o obj/Schedule.o obj/AdvancedScheduleAnalytics.o obj/main.o -o schedule_manager.exe
+g++ -pthread obj/Course.o obj/Lesson.o obj/Lecture.o obj/Tutorial.o obj/Lab.o obj/CsvReader.o obj/WorkerPool.o obj/Schedule.o obj/CourseGenome.o obj/AdvancedScheduleAnalytics.o obj/main.o -o schedule_manager.exe
 
 if exist schedule_manager.exe (
     echo Compilation successful! 
@@ -29,6 +29,8 @@
 #include "Lecture.h"
 #include "Tutorial.h"
 #include "Lab.h"
+#include "CsvReader.h"
+#include "WorkerPool.h"
 
 using namespace std;
 
@@ -110,6 +112,7 @@ private:
         double workloadBalance;
         double instructorDiversity;
         map<string, vector<shared_ptr<Lesson>>> scheduleMap;
+        map<int, vector<string>> courseGroups; // Course ID -> chosen group per lesson type
         vector<string> constraints;
         
         OptimizationCandidate() 
@@ -217,8 +220,8 @@ private:
     mutable unordered_map<int, Course> courseCache;
     mutable unordered_map<string, ConflictContext> conflictCache;
     
-    // Thread pool for asynchronous operations
-    mutable vector<future<void>> asyncTasks;
+    // Thread pool for building and scoring GA candidates
+    mutable WorkerPool workerPool;
     
     // =================== ALGORITHM IMPLEMENTATIONS ===================
     
@@ -246,8 +249,6 @@ private:
     int timeStringToMinutes(const string& timeStr) const;
     string minutesToTimeString(int minutes) const;
     
-    vector<string> parseCSVLine(const string& line) const;
-    
     vector<shared_ptr<Lesson>> loadLessonsForCourse(int courseId, 
                                                    const string& lessonType) const;
     
@@ -277,6 +278,7 @@ private:
     
     // Smart course scheduling with conflict-free validation
     bool tryAddCompleteCourse(int scheduleId, int courseId) const;
+    bool tryAddCourseGroups(int scheduleId, int courseId, const vector<string>& groupIds) const;
     
     double calculateRetakeImpact(const Course& course, double currentGrade, 
                                double totalCredits) const;
@@ -361,13 +363,16 @@ public:
      * 
      * @param targetCredits Target credit hours for the schedule
      * @param tolerance Acceptable deviation from target credits
+     * @param seed Seed of the genetic algorithm; 0 picks a random one, and
+     *        the same seed repeats a run exactly
      * @return true if optimal schedule generated, false otherwise
      * 
      * @complexity O(g * p * n) where g=generations, p=population, n=courses
-     * @thread_safety Uses async operations for performance
+     * @thread_safety Breeds and scores each generation on the worker pool
      */
     bool aiOptimalScheduleGeneration(double targetCredits, 
-                                   double tolerance = 1.0);
+                                   double tolerance = 1.0,
+                                   unsigned int seed = 0);
     
     /**
      * @brief Function 3: Advanced Academic Performance Analytics
@@ -0,0 +1,121 @@
+#ifndef COURSEGENOME_H
+#define COURSEGENOME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "Course.h"
+using namespace std;
+
+// Random engine of one genome slot (SplitMix64). Seeding is a few
+// multiplies, unlike mt19937's 624-word state, so every slot of every
+// generation gets its own stream: the run then depends only on the seed,
+// not on which thread bred which slot.
+class GenomeRandom {
+public:
+    typedef uint64_t result_type;
+
+    GenomeRandom(uint64_t seed, uint64_t generation, uint64_t slot)
+        : state(seed) {
+        state = mix(state ^ mix(generation + 0x9E3779B97F4A7C15ULL));
+        state = mix(state ^ mix(slot + 0xD1B54A32D192ED03ULL));
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ULL; }
+    result_type operator()() { return mix(state += 0x9E3779B97F4A7C15ULL); }
+
+private:
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state;
+};
+
+// One candidate course load for the genetic algorithm, packed into bits:
+// bit c of courseBits says whether course c is taken, and groups[c * 3 + k]
+// is the group chosen for its lesson type k (lecture, tutorial, lab). Group
+// genes are kept for courses that are not taken, so a course switched back
+// on by crossover or mutation comes back with the groups it had.
+struct CourseGenome {
+    vector<uint64_t> courseBits;
+    vector<uint8_t> groups;
+    double credits;
+    int courseCount;
+    int clashes;      // Pairs of chosen groups that overlap
+    double fitness;
+
+    CourseGenome() : credits(0), courseCount(0), clashes(0), fitness(0) {}
+};
+
+// Courses, groups and group clashes the genomes index into.
+// Built once per optimization from the course list and the lesson files,
+// then only read while the population evolves, so any number of threads
+// can breed and score genomes against it at the same time. Every operator
+// takes the caller's random engine; the catalog itself has no state that
+// changes.
+class GenomeCatalog {
+public:
+    static const int KINDS = 3;       // Lecture, tutorial, lab
+    static const int MAX_COURSES = 8; // Largest course load bred
+
+    GenomeCatalog(const vector<Course>& courses, const string& dataDirectory,
+                  double targetCredits, double tolerance);
+
+    size_t courseCount() const { return credits.size(); }
+    size_t sectionCount() const { return sectionDays.size(); }
+    int groupCount(size_t course, int kind) const;
+    const string& groupId(size_t course, int kind, int group) const;
+
+    // Random groups for every course, then courses added until the credits
+    // reach the target window
+    void randomGenome(GenomeRandom& gen, CourseGenome& genome) const;
+
+    // Uniform crossover: each course bit comes from a parent picked by one
+    // bit of a random mask. Courses taken from the first parent bring their
+    // group genes; every other gene comes from the second.
+    void crossover(const CourseGenome& first, const CourseGenome& second,
+                   GenomeRandom& gen, CourseGenome& child) const;
+
+    // Flip each course bit and redraw each group gene with probability rate
+    void mutate(CourseGenome& genome, double rate, GenomeRandom& gen) const;
+
+    // Drop random courses above the window, add random ones below it
+    void repair(CourseGenome& genome, GenomeRandom& gen) const;
+
+    // Credits, clashes and fitness. Fitness uses the weights of
+    // calculateQualityScore: credit fit 40%, no clashes 30%, balanced
+    // credits 20%, distinct lecturers 10%
+    void evaluate(CourseGenome& genome) const;
+
+    // Positions of the courses the genome takes, in course order
+    vector<size_t> takenCourses(const CourseGenome& genome) const;
+
+private:
+    bool isTaken(const CourseGenome& genome, size_t course) const;
+    void setTaken(CourseGenome& genome, size_t course, bool taken) const;
+    size_t nthTaken(const CourseGenome& genome, int n) const;  // n counts from 0
+    int section(size_t course, int kind, int group) const;
+    bool clash(int first, int second) const;
+
+    double targetCredits;
+    double tolerance;
+    size_t words;                        // uint64_t words per course bitset
+
+    vector<double> credits;              // Per course
+    vector<int> lecturers;               // Per course, interned lecturer name
+    vector<int> firstSection;            // Per course and kind
+    vector<vector<string>> groupIds;     // Per course and kind
+    vector<vector<int>> sectionDays;     // Per section, one entry per meeting
+    vector<vector<int>> sectionStarts;
+    vector<vector<int>> sectionEnds;
+    size_t rowWords;                     // uint64_t words per clash row
+    vector<uint64_t> clashBits;          // sectionCount x sectionCount bits
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+using namespace std;
+
+// Non-owning view of one field inside a mapped CSV file.
+// Valid only while the CsvReader that produced it is open. Surrounding
+// blanks, a trailing '\r' and surrounding quotes are already stripped.
+struct CsvField {
+    const char* data;
+    size_t size;
+
+    CsvField() : data(nullptr), size(0) {}
+    CsvField(const char* fieldData, size_t fieldSize) : data(fieldData), size(fieldSize) {}
+
+    bool empty() const { return size == 0; }
+    string str() const { return string(data, size); }
+
+    bool operator==(const char* text) const {
+        return strlen(text) == size && memcmp(data, text, size) == 0;
+    }
+    bool operator!=(const char* text) const { return !(*this == text); }
+
+    // Parse as a number; throws invalid_argument / out_of_range like stoi
+    int toInt() const;
+    // Parse as a floating point number; throws invalid_argument like stod
+    double toDouble() const;
+};
+
+// Memory-mapped, zero-copy CSV tokenizer shared by all loaders.
+// The file is mapped read-only and every row is split in place, so reading
+// a row does no heap allocation; callers copy only the fields they keep.
+//
+//   CsvReader reader(path);
+//   reader.nextRow(); // header
+//   while (reader.nextRow()) { int id = reader[0].toInt(); ... }
+class CsvReader {
+public:
+    // Fields beyond this count are ignored (the widest file has 10)
+    static const size_t MAX_FIELDS = 16;
+
+    explicit CsvReader(const string& path);
+    ~CsvReader();
+
+    bool isOpen() const { return opened; }
+
+    // Release the mapping early (Windows cannot rewrite a mapped file)
+    void close();
+
+    // Advance to the next non-blank row, false at end of file
+    bool nextRow();
+
+    size_t fieldCount() const { return count; }
+    const CsvField& operator[](size_t index) const { return fields[index]; }
+
+    // Raw text of the current row, for error messages
+    const CsvField& row() const { return currentRow; }
+
+private:
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    void splitRow(const char* begin, const char* end);
+
+    bool opened;
+    const char* base;   // Start of the mapping (nullptr for an empty file)
+    size_t length;
+    const char* cursor;
+    const char* limit;
+
+    CsvField fields[MAX_FIELDS];
+    size_t count;
+    CsvField currentRow;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Fixed-size pool of worker threads for data-parallel loops.
+// The threads start once and sleep between jobs. parallelFor() hands out
+// loop indices one at a time from a shared counter, so a thread that gets
+// cheap tasks keeps pulling more while another is busy with a slow one.
+// The calling thread takes part, so a pool of size 1 runs the loop inline.
+//
+// Tasks must write only to their own output slot; the caller merges the
+// slots afterwards in index order so the result does not depend on timing.
+class WorkerPool {
+public:
+    // threadCount includes the caller; 0 means one per hardware core
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+
+    size_t size() const { return workers.size() + 1; }
+
+    // Run task(0) ... task(count - 1) across the pool and wait for all.
+    // The first exception a task throws is rethrown here. Not reentrant.
+    void parallelFor(size_t count, const function<void(size_t)>& task);
+
+private:
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void workerLoop();
+    void runTasks();
+
+    vector<thread> workers;
+    mutex stateMutex;
+    condition_variable jobReady;
+    condition_variable jobDone;
+
+    // Current job, guarded by stateMutex except for the index counter
+    const function<void(size_t)>* task;
+    size_t taskCount;
+    atomic<size_t> nextIndex;
+    uint64_t generation;     // Bumped once per parallelFor call
+    size_t pendingWorkers;   // Workers still running this generation
+    exception_ptr firstError;
+    bool stopping;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "AdvancedScheduleAnalytics.h"
+#include "CourseGenome.h"
 #include <random>
 #include <numeric>
 #include <limits>
@@ -79,12 +80,7 @@ void AdvancedScheduleAnalytics::setDataReferences(
 }
 
 AdvancedScheduleAnalytics::~AdvancedScheduleAnalytics() {
-    // Wait for all async tasks to complete
-    for (future<void>& task : asyncTasks) {
-        if (task.valid()) {
-            task.wait();
-        }
-    }
+    // workerPool joins its threads in its own destructor
     
     // Clear caches
     lessonCache.clear();
@@ -158,35 +154,6 @@ string AdvancedScheduleAnalytics::minutesToTimeString(int minutes) const {
            (mins < 10 ? "0" : "") + to_string(mins);
 }
 
-vector<string> AdvancedScheduleAnalytics::parseCSVLine(const string& line) const {
-    vector<string> fields;
-    stringstream ss(line);
-    string field;
-    bool inQuotes = false;
-    string currentField = "";
-    
-    for (char c : line) {
-        if (c == '"') {
-            inQuotes = !inQuotes;
-        } else if (c == ',' && !inQuotes) {
-            // Trim whitespace
-            currentField.erase(0, currentField.find_first_not_of(" \t"));
-            currentField.erase(currentField.find_last_not_of(" \t") + 1);
-            fields.push_back(currentField);
-            currentField.clear();
-        } else {
-            currentField += c;
-        }
-    }
-    
-    // Add the last field
-    currentField.erase(0, currentField.find_first_not_of(" \t"));
-    currentField.erase(currentField.find_last_not_of(" \t") + 1);
-    fields.push_back(currentField);
-    
-    return fields;
-}
-
 vector<shared_ptr<Lesson>> AdvancedScheduleAnalytics::loadLessonsForCourse(
     int courseId, const string& lessonType) const {
     
@@ -206,29 +173,25 @@ vector<shared_ptr<Lesson>> AdvancedScheduleAnalytics::loadLessonsForCourse(
     else if (lessonType == "Lab") filename += "labs.csv";
     else return lessons;
     
-    ifstream file(filename);
-    if (!file.is_open()) {
+    CsvReader file(filename);
+    if (!file.isOpen()) {
         lessonCache[cacheKey] = lessons; // Cache empty result
         return lessons;
     }
     
-    string line;
-    getline(file, line); // Skip header
+    file.nextRow(); // Skip header
     
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-        
-        vector<string> fields = parseCSVLine(line);
-        if (fields.size() >= 8) {
+    while (file.nextRow()) {
+        if (file.fieldCount() >= 8) {
             try {
-                int course = stoi(fields[0]);
-                string day = fields[1];
-                string startTime = fields[2];
-                int duration = stoi(fields[3]);
-                string classroom = fields[4];
-                string building = fields[5];
-                string teacher = fields[6];
-                string groupId = fields[7];
+                int course = file[0].toInt();
+                string day = file[1].str();
+                string startTime = file[2].str();
+                int duration = file[3].toInt();
+                string classroom = file[4].str();
+                string building = file[5].str();
+                string teacher = file[6].str();
+                string groupId = file[7].str();
                 
                 shared_ptr<Lesson> lesson;
                 if (lessonType == "Lecture") {
@@ -287,8 +250,8 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
     
     // Load schedule data with error handling
     string scheduleFile = "data/schedule_" + to_string(scheduleId) + ".csv";
-    ifstream file(scheduleFile);
-    if (!file.is_open()) {
+    CsvReader file(scheduleFile);
+    if (!file.isOpen()) {
         cout << "ERROR: Schedule " << scheduleId << " not found or inaccessible." << endl;
         cout << "Recommendation: Create schedule using 'AddSchedule' command." << endl;
         return false;
@@ -299,26 +262,22 @@ bool AdvancedScheduleAnalytics::intelligentConflictResolution(int scheduleId) {
     vector<ConflictContext::LessonInfo> scheduledLessons;
     TimeSlotMatrix timeMatrix;
     
-    string line;
-    getline(file, line); // Skip header
+    file.nextRow(); // Skip header
     
-    while (getline(file, line)) {
-        if (line.empty()) continue;
-        
-        vector<string> fields = parseCSVLine(line);
-        if (fields.size() >= 10) {
+    while (file.nextRow()) {
+        if (file.fieldCount() >= 10) {
             try {
                 ConflictContext::LessonInfo lesson(
-                    stoi(fields[2]),  // courseId (column 3: CourseID)
+                    file[2].toInt(),  // courseId (column 3: CourseID)
                     "",               // courseName (will be loaded)
-                    fields[1],        // lessonType (column 2: LessonType)
-                    fields[9],        // groupId (column 10: GroupID)
-                    fields[3],        // day (column 4: Day)
-                    fields[4],        // startTime (column 5: StartTime)
-                    stoi(fields[5]),  // duration (column 6: Duration)
-                    fields[6],        // classroom (column 7: Classroom)
-                    fields[7],        // building (column 8: Building)
-                    fields[8]         // instructor (column 9: Teacher)
+                    file[1].str(),    // lessonType (column 2: LessonType)
+                    file[9].str(),    // groupId (column 10: GroupID)
+                    file[3].str(),    // day (column 4: Day)
+                    file[4].str(),    // startTime (column 5: StartTime)
+                    file[5].toInt(),  // duration (column 6: Duration)
+                    file[6].str(),    // classroom (column 7: Classroom)
+                    file[7].str(),    // building (column 8: Building)
+                    file[8].str()     // instructor (column 9: Teacher)
                 );
                 
                 scheduledLessons.push_back(lesson);
@@ -734,7 +693,8 @@ void AdvancedScheduleAnalytics::displayConflictReport(
 // =================== FUNCTION 2: AI-POWERED OPTIMAL SCHEDULE GENERATION ===================
 
 bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits, 
-                                                          double tolerance) {
+                                                          double tolerance,
+                                                          unsigned int seed) {
     cout << "\n";
     cout << "==========================================================================" << endl;
     cout << "|               AI-POWERED OPTIMAL SCHEDULE GENERATION                   |" << endl;
@@ -750,28 +710,24 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits
     // Load course database with async I/O
     displayProgressAnimation("Loading course database with parallel processing", 6);
     
-    ifstream coursesFile("data/courses.csv");
-    if (!coursesFile.is_open()) {
+    CsvReader coursesFile("data/courses.csv");
+    if (!coursesFile.isOpen()) {
         cout << "ERROR: Could not access course database." << endl;
         cout << "Please ensure data/courses.csv exists and is readable." << endl;
         return false;
     }
     
     vector<Course> availableCourses;
-    string line;
-    getline(coursesFile, line); // Skip header
+    coursesFile.nextRow(); // Skip header
     
-    while (getline(coursesFile, line)) {
-        if (line.empty()) continue;
-        
-        vector<string> fields = parseCSVLine(line);
-        if (fields.size() >= 10) {
+    while (coursesFile.nextRow()) {
+        if (coursesFile.fieldCount() >= 10) {
             try {
-                int id = stoi(fields[0]);
-                string name = fields[1];
-                // Skip exam date fields (fields[2] through fields[7])
-                int credits = stoi(fields[8]);  // Credits are in column 8
-                string lecturer = fields[9];   // Lecturer is in column 9
+                int id = coursesFile[0].toInt();
+                string name = coursesFile[1].str();
+                // Skip exam date fields (columns 2 through 7)
+                int credits = coursesFile[8].toInt();  // Credits are in column 8
+                string lecturer = coursesFile[9].str(); // Lecturer is in column 9
                 
                 availableCourses.emplace_back(id, name, credits, "", "", lecturer);
                 
@@ -788,77 +744,40 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits
     
     displayProgressAnimation("Generating genetic algorithm population", 10);
     
-    // Generate initial population using genetic algorithm
-    const int POPULATION_SIZE = 100;  // Increased for better coverage
-    const int GENERATIONS = 30;       // Increased for better evolution
-    
-    vector<OptimizationCandidate> population;
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> courseDist(0, availableCourses.size() - 1);
-    
-    cout << "Generating " << POPULATION_SIZE << " schedule candidates..." << endl;
-    
-    // Create initial population with better logic
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        OptimizationCandidate candidate;
-        
-        // Calculate target number of courses based on credits
-        double avgCredits = 0;
-        for (const Course& course : availableCourses) {
-            avgCredits += course.getCredits();
-        }
-        avgCredits /= availableCourses.size();
-        
-        int targetCourses = max(2, min(8, (int)(targetCredits / avgCredits)));
-        int numCourses = targetCourses + (i % 3) - 1; // Vary around target
-        numCourses = max(2, min(8, numCourses));
-        
-        set<int> selectedIndices;
-        int attempts = 0;
-        
-        // Smart course selection to hit target credits
-        while (selectedIndices.size() < static_cast<size_t>(numCourses) && attempts < 50) {
-            int idx = courseDist(gen);
-            if (selectedIndices.find(idx) == selectedIndices.end()) {
-                double projectedCredits = candidate.totalCredits + availableCourses[idx].getCredits();
-                
-                // Accept if within reasonable range
-                if (projectedCredits <= targetCredits + tolerance + 3) {
-                    selectedIndices.insert(idx);
-                    candidate.courses.push_back(availableCourses[idx]);
-                    candidate.totalCredits += availableCourses[idx].getCredits();
-                }
-            }
-            attempts++;
-        }
-        
-        // Check if credits are in acceptable range (wider for initial population)
-        if (candidate.totalCredits >= targetCredits - tolerance - 2 && 
-            candidate.totalCredits <= targetCredits + tolerance + 2 &&
-            candidate.courses.size() >= 2) {
-            
-            // Calculate quality metrics
-            candidate.qualityScore = calculateQualityScore(candidate);
-            candidate.conflictProbability = calculateConflictProbability(candidate.courses);
-            candidate.workloadBalance = calculateWorkloadBalance(candidate.courses);
-            candidate.instructorDiversity = calculateInstructorDiversity(candidate.courses);
-            
-            population.push_back(candidate);
-        }
-    }
+    // Genomes index into the catalog: a course bitset plus a group per
+    // lesson type, so breeding and scoring never copy a Course
+    const int POPULATION_SIZE = 2000;
+    const int GENERATIONS = 300;
+    const double MUTATION_RATE = 0.02;  // Per course bit and group gene
+    GenomeCatalog catalog(availableCourses, "data/", targetCredits, tolerance);
+    
+    // Every genome slot draws from its own stream, seeded from the run
+    // seed, the generation and the slot, so the threads never share an
+    // engine and a seed gives the same run on any number of threads
+    if (seed == 0) seed = random_device()();
+    
+    cout << "Random seed: " << seed << " (OptimalGeneration " << targetCredits << " " << tolerance
+         << " " << seed << " repeats this run)" << endl;
+    cout << "Generating " << POPULATION_SIZE << " genomes over " << catalog.courseCount() << " courses and "
+         << catalog.sectionCount() << " groups on " << workerPool.size() << " threads..." << endl;
+    
+    vector<CourseGenome> population(POPULATION_SIZE);
+    workerPool.parallelFor(POPULATION_SIZE, [&](size_t slot) {
+        GenomeRandom gen(seed, 0, slot);
+        catalog.randomGenome(gen, population[slot]);
+        catalog.evaluate(population[slot]);
+    });
     
-    cout << "Generated " << population.size() << " valid candidates from " << POPULATION_SIZE << " attempts" << endl;
+    auto inWindow = [targetCredits, tolerance](const CourseGenome& genome) {
+        return genome.courseCount >= 2 && fabs(genome.credits - targetCredits) <= tolerance;
+    };
+    int validCount = (int)count_if(population.begin(), population.end(), inWindow);
+    cout << "Generated " << validCount << " candidates within the credit window from "
+         << POPULATION_SIZE << " genomes" << endl;
     
     displayProgressAnimation("Evolving optimal solutions through genetic operations", 12);
     
-    // Genetic algorithm evolution with proper optimization
-    OptimizationCandidate bestCandidate;
-    double bestScore = 0;
-    
-    cout << "Starting optimization with " << population.size() << " candidates..." << endl;
-    
-    if (population.empty()) {
+    if (validCount == 0) {
         cout << "\n";
         cout << "================ OPTIMIZATION FAILED ================" << endl;
         cout << "|  No valid candidates generated                      |" << endl;
@@ -868,91 +787,98 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits
         return false;
     }
     
-    // Convert to vector for easier manipulation
-    vector<OptimizationCandidate> candidates;
-    for (const OptimizationCandidate& candidate : population) {
-        candidates.push_back(candidate);
-    }
-    
-    // Sort by quality score
-    sort(candidates.begin(), candidates.end(), [](const OptimizationCandidate& a, const OptimizationCandidate& b) {
-        return a.qualityScore > b.qualityScore;
-    });
-    
-    // Evolve through generations
-    for (int generation = 0; generation < GENERATIONS && !candidates.empty(); generation++) {
-        // Find best candidate in current generation
-        for (const auto& candidate : candidates) {
-            if (candidate.qualityScore > bestScore) {
-                bestScore = candidate.qualityScore;
-                bestCandidate = candidate;
+    // Genome slots ranked best first; ties keep slot order so the run
+    // stays reproducible. Only the ranks move, never the genomes.
+    vector<size_t> ranked(population.size());
+    auto byFitness = [&population](size_t a, size_t b) {
+        return population[a].fitness > population[b].fitness;
+    };
+    
+    // Two generations' worth of genomes, swapped each round so breeding
+    // refills existing buffers
+    vector<CourseGenome> nextGen(population.size());
+    CourseGenome bestGenome;
+    bool haveBest = false;
+    int generationsRun = 0;
+    auto evolveStart = chrono::steady_clock::now();
+    
+    for (int generation = 0; generation < GENERATIONS; generation++) {
+        iota(ranked.begin(), ranked.end(), 0);
+        stable_sort(ranked.begin(), ranked.end(), byFitness);
+        generationsRun = generation + 1;
+        
+        // Best in-window genome so far (strictly better replaces it)
+        for (size_t slot : ranked) {
+            const CourseGenome& genome = population[slot];
+            if (inWindow(genome) && (!haveBest || genome.fitness > bestGenome.fitness)) {
+                bestGenome = genome;
+                haveBest = true;
+                break;
             }
         }
         
-        // Early termination if excellent solution found
-        if (bestScore > 0.95) {
+        if (generation % 50 == 0) {
+            cout << "Generation " << generation << ": Best score = " << (haveBest ? bestGenome.fitness : 0.0)
+                 << ", Population = " << population.size() << endl;
+        }
+        
+        // Early termination if excellent, conflict-free solution found
+        if (haveBest && bestGenome.clashes == 0 && bestGenome.fitness > 0.95) {
             cout << "Excellent solution found in generation " << generation << endl;
             break;
         }
         
-        // Create next generation (elitism + crossover)
-        vector<OptimizationCandidate> nextGen;
-        
-        // Keep best 20% (elitism)
-        int eliteCount = max(1, (int)(candidates.size() * 0.2));
-        for (int i = 0; i < min(eliteCount, (int)candidates.size()); i++) {
-            nextGen.push_back(candidates[i]);
+        // Keep best 20% (elitism); the rest are children of binary
+        // tournaments, bred in parallel, one slot each
+        size_t eliteCount = max<size_t>(1, population.size() / 5);
+        for (size_t rank = 0; rank < eliteCount; rank++) {
+            nextGen[rank] = population[ranked[rank]];
         }
         
-        // Generate rest through crossover and mutation
-        while (nextGen.size() < candidates.size() && nextGen.size() < static_cast<size_t>(POPULATION_SIZE)) {
-            if (candidates.size() >= 2) {
-                // Tournament selection for parents
-                int p1 = uniform_int_distribution<>(0, min(10, (int)candidates.size() - 1))(gen);
-                int p2 = uniform_int_distribution<>(0, min(10, (int)candidates.size() - 1))(gen);
-                
-                OptimizationCandidate child;
-                set<int> usedCourses;
-                
-                // Crossover: smart combination
-                vector<Course> parentCourses = candidates[p1].courses;
-                parentCourses.insert(parentCourses.end(), 
-                                   candidates[p2].courses.begin(), 
-                                   candidates[p2].courses.end());
-                
-                // Smart selection based on credits
-                for (const auto& course : parentCourses) {
-                    if (usedCourses.find(course.getCourseId()) == usedCourses.end() &&
-                        child.totalCredits + course.getCredits() <= targetCredits + tolerance) {
-                        child.courses.push_back(course);
-                        child.totalCredits += course.getCredits();
-                        usedCourses.insert(course.getCourseId());
-                    }
-                }
-                
-                // Validate child
-                if (child.courses.size() >= 2 && 
-                    child.totalCredits >= targetCredits - tolerance &&
-                    child.totalCredits <= targetCredits + tolerance) {
-                    
-                    child.qualityScore = calculateQualityScore(child);
-                    child.conflictProbability = calculateConflictProbability(child.courses);
-                    child.workloadBalance = calculateWorkloadBalance(child.courses);
-                    child.instructorDiversity = calculateInstructorDiversity(child.courses);
-                    
-                    nextGen.push_back(child);
+        workerPool.parallelFor(population.size() - eliteCount, [&](size_t slot) {
+            GenomeRandom gen(seed, generation + 1, slot);
+            uniform_int_distribution<size_t> pick(0, population.size() - 1);
+            // The lower rank of each pair is the fitter genome
+            size_t first = ranked[min(pick(gen), pick(gen))];
+            size_t second = ranked[min(pick(gen), pick(gen))];
+            
+            CourseGenome& child = nextGen[eliteCount + slot];
+            catalog.crossover(population[first], population[second], gen, child);
+            catalog.mutate(child, MUTATION_RATE, gen);
+            catalog.repair(child, gen);
+            catalog.evaluate(child);
+        });
+        
+        population.swap(nextGen);
+    }
+    
+    double evolveMs = chrono::duration<double, milli>(chrono::steady_clock::now() - evolveStart).count();
+    cout << "Evolved " << generationsRun << " generations of " << POPULATION_SIZE << " genomes in "
+         << fixed << setprecision(1) << evolveMs << " ms ("
+         << setprecision(0) << (evolveMs > 0 ? generationsRun * 1000.0 / evolveMs : 0.0)
+         << " generations/sec)" << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    
+    // Unpack the winner for display and scheduling
+    OptimizationCandidate bestCandidate;
+    if (haveBest) {
+        for (size_t course : catalog.takenCourses(bestGenome)) {
+            bestCandidate.courses.push_back(availableCourses[course]);
+            bestCandidate.totalCredits += availableCourses[course].getCredits();
+            
+            vector<string> groups;
+            for (int kind = 0; kind < GenomeCatalog::KINDS; kind++) {
+                if (catalog.groupCount(course, kind) > 0) {
+                    groups.push_back(catalog.groupId(course, kind, bestGenome.groups[course * GenomeCatalog::KINDS + kind]));
                 }
-            } else {
-                break;
             }
+            bestCandidate.courseGroups[availableCourses[course].getCourseId()] = groups;
         }
-        
-        candidates = nextGen;
-        
-        if (generation % 5 == 0) {
-            cout << "Generation " << generation << ": Best score = " << bestScore 
-                 << ", Population = " << candidates.size() << endl;
-        }
+        bestCandidate.qualityScore = bestGenome.fitness;
+        bestCandidate.conflictProbability = 1.0 - 1.0 / (1.0 + bestGenome.clashes);
+        bestCandidate.workloadBalance = calculateWorkloadBalance(bestCandidate.courses);
+        bestCandidate.instructorDiversity = calculateInstructorDiversity(bestCandidate.courses);
     }
     
     if (bestCandidate.courses.empty()) {
@@ -982,18 +908,15 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits
     int newScheduleId = 1;
     
     // Find next available schedule ID
-    ifstream existingSchedules("data/schedules.csv");
-    if (existingSchedules.is_open()) {
-        string line;
-        getline(existingSchedules, line); // Skip header
+    CsvReader existingSchedules("data/schedules.csv");
+    if (existingSchedules.isOpen()) {
+        existingSchedules.nextRow(); // Skip header
         int maxId = 0;
-        while (getline(existingSchedules, line)) {
-            if (!line.empty()) {
-                try {
-                    int id = stoi(line);
-                    if (id > maxId) maxId = id;
-                } catch (...) {}
-            }
+        while (existingSchedules.nextRow()) {
+            try {
+                int id = existingSchedules[0].toInt();
+                if (id > maxId) maxId = id;
+            } catch (...) {}
         }
         newScheduleId = maxId + 1;
         existingSchedules.close();
@@ -1060,7 +983,9 @@ bool AdvancedScheduleAnalytics::aiOptimalScheduleGeneration(double targetCredits
         cout << "Attempting Course " << courseId << " (" << course.getName() 
              << ", " << course.getCredits() << " credits)..." << endl;
         
-        bool courseSuccessful = tryAddCompleteCourse(newScheduleId, courseId);
+        // The genome's own groups first, then any conflict-free ones
+        bool courseSuccessful = tryAddCourseGroups(newScheduleId, courseId, bestCandidate.courseGroups[courseId]) ||
+                                tryAddCompleteCourse(newScheduleId, courseId);
         
         if (courseSuccessful) {
             successfulCourses.push_back(courseId);
@@ -1408,29 +1333,25 @@ bool AdvancedScheduleAnalytics::advancedAcademicAnalytics(int scheduleId) {
     
     // Load schedule data
     string scheduleFile = "data/schedule_" + to_string(scheduleId) + ".csv";
-    ifstream file(scheduleFile);
-    if (!file.is_open()) {
+    CsvReader file(scheduleFile);
+    if (!file.isOpen()) {
         cout << "ERROR: Schedule " << scheduleId << " not found." << endl;
         return false;
     }
     
     // Load course database
     map<int, Course> courseDatabase;
-    ifstream coursesFile("data/courses.csv");
-    if (coursesFile.is_open()) {
-        string line;
-        getline(coursesFile, line); // Skip header
+    CsvReader coursesFile("data/courses.csv");
+    if (coursesFile.isOpen()) {
+        coursesFile.nextRow(); // Skip header
         
-        while (getline(coursesFile, line)) {
-            if (line.empty()) continue;
-            
-            vector<string> fields = parseCSVLine(line);
-            if (fields.size() >= 10) {
+        while (coursesFile.nextRow()) {
+            if (coursesFile.fieldCount() >= 10) {
                 try {
-                    int id = stoi(fields[0]);
-                    string name = fields[1];
-                    int credits = stoi(fields[8]);
-                    string lecturer = fields[9];
+                    int id = coursesFile[0].toInt();
+                    string name = coursesFile[1].str();
+                    int credits = coursesFile[8].toInt();
+                    string lecturer = coursesFile[9].str();
                     courseDatabase[id] = Course(id, name, credits, "", "", lecturer);
                 } catch (...) { continue; }
             }
@@ -1440,14 +1361,10 @@ bool AdvancedScheduleAnalytics::advancedAcademicAnalytics(int scheduleId) {
     
     // Extract unique courses from schedule
     set<int> uniqueCourseIds;
-    string line;
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        if (!line.empty()) {
-            vector<string> fields = parseCSVLine(line);
-            if (fields.size() >= 3) {
-                try { uniqueCourseIds.insert(stoi(fields[2])); } catch (...) {}
-            }
+    file.nextRow(); // Skip header
+    while (file.nextRow()) {
+        if (file.fieldCount() >= 3) {
+            try { uniqueCourseIds.insert(file[2].toInt()); } catch (...) {}
         }
     }
     file.close();
@@ -1818,6 +1735,26 @@ void AdvancedScheduleAnalytics::displayAcademicReport(
  * 3. Only accepts the course if ALL lesson types can be scheduled conflict-free
  * 4. If course cannot be completed, removes any partially added lessons
  */
+bool AdvancedScheduleAnalytics::tryAddCourseGroups(int scheduleId, int courseId,
+                                                   const vector<string>& groupIds) const {
+    if (groupIds.empty() || !addLessonCallback) return false;
+    
+    // All of the groups or none of them
+    vector<string> addedGroups;
+    for (const string& groupId : groupIds) {
+        if (!addLessonCallback(scheduleId, courseId, groupId)) {
+            for (const string& rollbackGroup : addedGroups) {
+                if (removeLessonCallback) {
+                    removeLessonCallback(scheduleId, courseId, rollbackGroup);
+                }
+            }
+            return false;
+        }
+        addedGroups.push_back(groupId);
+    }
+    return true;
+}
+
 bool AdvancedScheduleAnalytics::tryAddCompleteCourse(int scheduleId, int courseId) const {
     vector<string> lessonTypes = {"lectures", "tutorials", "labs"};
     vector<string> addedGroups; // Track what we've added for potential rollback
@@ -1825,33 +1762,22 @@ bool AdvancedScheduleAnalytics::tryAddCompleteCourse(int scheduleId, int courseI
     // For each lesson type, try to find a conflict-free group
     for (const string& lessonType : lessonTypes) {
         string filename = "data/" + to_string(courseId) + "_" + lessonType + ".csv";
-        ifstream lessonFile(filename);
+        CsvReader lessonFile(filename);
         
-        if (!lessonFile.is_open()) {
+        if (!lessonFile.isOpen()) {
             continue; // Some courses might not have all lesson types
         }
         
-        string line;
-        getline(lessonFile, line); // Skip header
+        lessonFile.nextRow(); // Skip header
         
         // Collect all available groups for this lesson type
         vector<string> availableGroups;
-        while (getline(lessonFile, line)) {
-            if (!line.empty()) {
-                vector<string> tokens;
-                stringstream ss(line);
-                string token;
-                
-                while (getline(ss, token, ',')) {
-                    tokens.push_back(token);
-                }
-                
-                if (tokens.size() >= 8) {
-                    string groupId = tokens[7];
-                    // Only add unique groups
-                    if (find(availableGroups.begin(), availableGroups.end(), groupId) == availableGroups.end()) {
-                        availableGroups.push_back(groupId);
-                    }
+        while (lessonFile.nextRow()) {
+            if (lessonFile.fieldCount() >= 8) {
+                string groupId = lessonFile[7].str();
+                // Only add unique groups
+                if (find(availableGroups.begin(), availableGroups.end(), groupId) == availableGroups.end()) {
+                    availableGroups.push_back(groupId);
                 }
             }
         }
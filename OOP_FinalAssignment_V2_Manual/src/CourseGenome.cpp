@@ -0,0 +1,289 @@
+#include "CourseGenome.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include "CsvReader.h"
+
+const int GenomeCatalog::KINDS;
+const int GenomeCatalog::MAX_COURSES;
+
+namespace {
+
+int dayIndex(const string& day) {
+    static const char* days[] = {"Sunday", "Monday", "Tuesday", "Wednesday",
+                                 "Thursday", "Friday", "Saturday"};
+    for (int i = 0; i < 7; i++) {
+        if (day == days[i]) return i;
+    }
+    return -1;
+}
+
+// "HH:MM" to minutes after midnight, -1 if malformed
+int startMinutes(const string& time) {
+    size_t colon = time.find(':');
+    if (colon == string::npos) return -1;
+    try {
+        return stoi(time.substr(0, colon)) * 60 + stoi(time.substr(colon + 1));
+    } catch (...) {
+        return -1;
+    }
+}
+
+}
+
+GenomeCatalog::GenomeCatalog(const vector<Course>& courses, const string& dataDirectory,
+                             double targetCredits, double tolerance)
+    : targetCredits(targetCredits), tolerance(tolerance),
+      words((courses.size() + 63) / 64), rowWords(0) {
+    static const char* lessonFiles[KINDS] = {"lectures", "tutorials", "labs"};
+    map<string, int> lecturerIds;
+
+    for (const Course& course : courses) {
+        credits.push_back(course.getCredits());
+        lecturers.push_back(lecturerIds.emplace(course.getLecturer(), (int)lecturerIds.size()).first->second);
+
+        for (int kind = 0; kind < KINDS; kind++) {
+            firstSection.push_back((int)sectionDays.size());
+            groupIds.emplace_back();
+
+            // Group every meeting of the file by its group ID, keeping the
+            // file's group order
+            CsvReader file(dataDirectory + to_string(course.getCourseId()) + "_" + lessonFiles[kind] + ".csv");
+            if (!file.isOpen()) continue;
+            file.nextRow(); // Skip header
+            map<string, int> groupSections;
+            while (file.nextRow()) {
+                if (file.fieldCount() < 8) continue;
+                try {
+                    if (file[0].toInt() != course.getCourseId()) continue;
+                    int day = dayIndex(file[1].str());
+                    int start = startMinutes(file[2].str());
+                    int duration = file[3].toInt() * 60;
+                    if (day < 0 || start < 0) continue;
+
+                    string groupId = file[7].str();
+                    auto found = groupSections.find(groupId);
+                    if (found == groupSections.end()) {
+                        // Group genes are one byte
+                        if (groupIds.back().size() == 255) continue;
+                        found = groupSections.emplace(groupId, (int)sectionDays.size()).first;
+                        groupIds.back().push_back(groupId);
+                        sectionDays.emplace_back();
+                        sectionStarts.emplace_back();
+                        sectionEnds.emplace_back();
+                    }
+                    sectionDays[found->second].push_back(day);
+                    sectionStarts[found->second].push_back(start);
+                    sectionEnds[found->second].push_back(start + duration);
+                } catch (const exception& e) {
+                    continue; // Skip malformed entries
+                }
+            }
+            file.close();
+        }
+    }
+
+    // One bit per pair of sections that share a minute of the same day
+    size_t sections = sectionDays.size();
+    rowWords = (sections + 63) / 64;
+    clashBits.assign(sections * rowWords, 0);
+    for (size_t a = 0; a < sections; a++) {
+        for (size_t b = a + 1; b < sections; b++) {
+            bool overlap = false;
+            for (size_t i = 0; i < sectionDays[a].size() && !overlap; i++) {
+                for (size_t j = 0; j < sectionDays[b].size() && !overlap; j++) {
+                    overlap = sectionDays[a][i] == sectionDays[b][j] &&
+                              sectionStarts[a][i] < sectionEnds[b][j] &&
+                              sectionStarts[b][j] < sectionEnds[a][i];
+                }
+            }
+            if (overlap) {
+                clashBits[a * rowWords + b / 64] |= 1ULL << (b % 64);
+                clashBits[b * rowWords + a / 64] |= 1ULL << (a % 64);
+            }
+        }
+    }
+}
+
+int GenomeCatalog::groupCount(size_t course, int kind) const {
+    return (int)groupIds[course * KINDS + kind].size();
+}
+
+const string& GenomeCatalog::groupId(size_t course, int kind, int group) const {
+    return groupIds[course * KINDS + kind][group];
+}
+
+bool GenomeCatalog::isTaken(const CourseGenome& genome, size_t course) const {
+    return (genome.courseBits[course / 64] >> (course % 64)) & 1;
+}
+
+void GenomeCatalog::setTaken(CourseGenome& genome, size_t course, bool taken) const {
+    if (taken) {
+        genome.courseBits[course / 64] |= 1ULL << (course % 64);
+    } else {
+        genome.courseBits[course / 64] &= ~(1ULL << (course % 64));
+    }
+}
+
+int GenomeCatalog::section(size_t course, int kind, int group) const {
+    return firstSection[course * KINDS + kind] + group;
+}
+
+bool GenomeCatalog::clash(int first, int second) const {
+    return (clashBits[first * rowWords + second / 64] >> (second % 64)) & 1;
+}
+
+void GenomeCatalog::randomGenome(GenomeRandom& gen, CourseGenome& genome) const {
+    genome = CourseGenome();
+    genome.courseBits.assign(words, 0);
+    genome.groups.assign(courseCount() * KINDS, 0);
+    for (size_t course = 0; course < courseCount(); course++) {
+        for (int kind = 0; kind < KINDS; kind++) {
+            int groups = groupCount(course, kind);
+            if (groups > 1) {
+                genome.groups[course * KINDS + kind] = (uint8_t)uniform_int_distribution<int>(0, groups - 1)(gen);
+            }
+        }
+    }
+    repair(genome, gen);
+}
+
+void GenomeCatalog::crossover(const CourseGenome& first, const CourseGenome& second,
+                              GenomeRandom& gen, CourseGenome& child) const {
+    // Reuses the child's buffers when it already has them
+    child.courseBits.resize(words);
+    child.groups = second.groups;
+    uniform_int_distribution<uint64_t> maskDist;
+    for (size_t word = 0; word < words; word++) {
+        uint64_t mask = maskDist(gen);
+        child.courseBits[word] = (first.courseBits[word] & mask) | (second.courseBits[word] & ~mask);
+
+        // Courses the child takes from the first parent bring its groups
+        for (uint64_t bits = first.courseBits[word] & mask; bits; bits &= bits - 1) {
+            size_t course = word * 64 + __builtin_ctzll(bits);
+            copy_n(first.groups.begin() + course * KINDS, KINDS, child.groups.begin() + course * KINDS);
+        }
+    }
+}
+
+void GenomeCatalog::mutate(CourseGenome& genome, double rate, GenomeRandom& gen) const {
+    // Draw the gap to the next mutated gene instead of one coin per gene
+    geometric_distribution<size_t> gap(rate);
+    size_t genes = courseCount() * (KINDS + 1);
+    for (size_t gene = gap(gen); gene < genes; gene += 1 + gap(gen)) {
+        if (gene < courseCount()) {
+            genome.courseBits[gene / 64] ^= 1ULL << (gene % 64);
+            continue;
+        }
+        size_t groupGene = gene - courseCount();
+        int groups = groupCount(groupGene / KINDS, (int)(groupGene % KINDS));
+        if (groups > 1) {
+            genome.groups[groupGene] = (uint8_t)uniform_int_distribution<int>(0, groups - 1)(gen);
+        }
+    }
+}
+
+void GenomeCatalog::repair(CourseGenome& genome, GenomeRandom& gen) const {
+    int count = 0;
+    double total = 0;
+    for (size_t word = 0; word < words; word++) {
+        for (uint64_t bits = genome.courseBits[word]; bits; bits &= bits - 1) {
+            count++;
+            total += credits[word * 64 + __builtin_ctzll(bits)];
+        }
+    }
+
+    // Too many courses or credits: drop random ones
+    while (count > 0 && (count > MAX_COURSES || total > targetCredits + tolerance)) {
+        size_t course = nthTaken(genome, uniform_int_distribution<int>(0, count - 1)(gen));
+        setTaken(genome, course, false);
+        total -= credits[course];
+        count--;
+    }
+
+    // Too few: add random courses that still fit under the window's top
+    for (int attempt = 0; attempt < 50 && count < MAX_COURSES &&
+         (count < 2 || total < targetCredits - tolerance); attempt++) {
+        size_t course = uniform_int_distribution<size_t>(0, courseCount() - 1)(gen);
+        if (isTaken(genome, course) || total + credits[course] > targetCredits + tolerance) continue;
+        setTaken(genome, course, true);
+        total += credits[course];
+        count++;
+    }
+}
+
+void GenomeCatalog::evaluate(CourseGenome& genome) const {
+    // Repaired genomes take at most MAX_COURSES courses; scoring works on
+    // fixed arrays so it allocates nothing
+    int chosen[MAX_COURSES * KINDS];
+    int chosenCount = 0;
+    int names[MAX_COURSES];
+    int nameCount = 0;
+    double squares = 0;
+
+    genome.courseCount = 0;
+    genome.credits = 0;
+    genome.clashes = 0;
+    genome.fitness = 0;
+    for (size_t word = 0; word < words; word++) {
+        for (uint64_t bits = genome.courseBits[word]; bits && genome.courseCount < MAX_COURSES; bits &= bits - 1) {
+            size_t course = word * 64 + __builtin_ctzll(bits);
+            genome.courseCount++;
+            genome.credits += credits[course];
+            squares += credits[course] * credits[course];
+
+            if (find(names, names + nameCount, lecturers[course]) == names + nameCount) {
+                names[nameCount++] = lecturers[course];
+            }
+            for (int kind = 0; kind < KINDS; kind++) {
+                if (groupCount(course, kind) == 0) continue;
+                int sectionIndex = section(course, kind, genome.groups[course * KINDS + kind]);
+                for (int i = 0; i < chosenCount; i++) {
+                    if (clash(chosen[i], sectionIndex)) genome.clashes++;
+                }
+                chosen[chosenCount++] = sectionIndex;
+            }
+        }
+    }
+    if (genome.courseCount == 0) return;
+
+    // Credit fit: full inside the window, falling off outside it
+    double outside = max(0.0, fabs(genome.credits - targetCredits) - tolerance);
+    double creditFit = genome.courseCount >= 2 ? 1.0 / (1.0 + outside) : 0.0;
+
+    double mean = genome.credits / genome.courseCount;
+    double variance = max(0.0, squares / genome.courseCount - mean * mean);
+    double balance = 1.0 / (1.0 + sqrt(variance));
+
+    double diversity = (double)nameCount / genome.courseCount;
+
+    genome.fitness = creditFit * 0.4 + (1.0 / (1.0 + genome.clashes)) * 0.3 + balance * 0.2 + diversity * 0.1;
+}
+
+size_t GenomeCatalog::nthTaken(const CourseGenome& genome, int n) const {
+    for (size_t word = 0; word < words; word++) {
+        uint64_t bits = genome.courseBits[word];
+        int inWord = __builtin_popcountll(bits);
+        if (n >= inWord) {
+            n -= inWord;
+            continue;
+        }
+        while (n-- > 0) bits &= bits - 1;
+        return word * 64 + __builtin_ctzll(bits);
+    }
+    return courseCount();
+}
+
+vector<size_t> GenomeCatalog::takenCourses(const CourseGenome& genome) const {
+    vector<size_t> taken;
+    for (size_t word = 0; word < words; word++) {
+        uint64_t bits = genome.courseBits[word];
+        while (bits) {
+            size_t course = word * 64 + __builtin_ctzll(bits);
+            if (course < courseCount()) taken.push_back(course);
+            bits &= bits - 1;
+        }
+    }
+    return taken;
+}
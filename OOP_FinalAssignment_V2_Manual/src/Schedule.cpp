@@ -2,6 +2,7 @@
 #include "Lecture.h"
 #include "Tutorial.h"
 #include "Lab.h"
+#include "CsvReader.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -359,35 +360,24 @@ void Schedule::saveToCSV(const string& filename) const {
 
 // Load schedule from CSV
 void Schedule::loadFromCSV(const string& filename) {
-    ifstream file(filename);
-    if (file.is_open()) {
-        string line;
-        getline(file, line); // Skip header
+    CsvReader reader(filename);
+    if (reader.isOpen()) {
+        reader.nextRow(); // Skip header
         
-        while (getline(file, line)) {
-            if (line.empty()) continue;
-            
-            stringstream ss(line);
-            string item;
-            vector<string> tokens;
-            
-            while (getline(ss, item, ',')) {
-                tokens.push_back(item);
-            }
-            
-            if (tokens.size() >= 10) {
+        while (reader.nextRow()) {
+            if (reader.fieldCount() >= 10) {
                 try {
                     // Parse with correct field order: ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,GroupID
-                    int schedId = stoi(tokens[0]);          // ScheduleID
-                    string lessonType = tokens[1];          // LessonType  
-                    int courseId = stoi(tokens[2]);         // CourseID
-                    string day = tokens[3];                 // Day
-                    string startTime = tokens[4];           // StartTime
-                    int duration = stoi(tokens[5]);         // Duration
-                    string classroom = tokens[6];           // Classroom
-                    string building = tokens[7];            // Building
-                    string teacher = tokens[8];             // Teacher
-                    string groupId = tokens[9];             // GroupID
+                    int schedId = reader[0].toInt();        // ScheduleID
+                    const CsvField& lessonType = reader[1]; // LessonType
+                    int courseId = reader[2].toInt();       // CourseID
+                    string day = reader[3].str();           // Day
+                    string startTime = reader[4].str();     // StartTime
+                    int duration = reader[5].toInt();       // Duration
+                    string classroom = reader[6].str();     // Classroom
+                    string building = reader[7].str();      // Building
+                    string teacher = reader[8].str();       // Teacher
+                    string groupId = reader[9].str();       // GroupID
                     
                     // Create appropriate lesson objects based on type
                     shared_ptr<Lesson> lesson;
@@ -408,6 +398,6 @@ void Schedule::loadFromCSV(const string& filename) {
                 }
             }
         }
-        file.close();
+        reader.close();
     }
 }
@@ -0,0 +1,91 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threadCount)
+    : task(nullptr), taskCount(0), nextIndex(0), generation(0),
+      pendingWorkers(0), stopping(false) {
+    if (threadCount == 0) threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (size_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, const function<void(size_t)>& job) {
+    if (count == 0) return;
+
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) job(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(stateMutex);
+        task = &job;
+        taskCount = count;
+        nextIndex.store(0);
+        firstError = nullptr;
+        pendingWorkers = workers.size();
+        generation++;
+    }
+    jobReady.notify_all();
+
+    runTasks();
+
+    exception_ptr error;
+    {
+        unique_lock<mutex> lock(stateMutex);
+        jobDone.wait(lock, [this] { return pendingWorkers == 0; });
+        task = nullptr;
+        error = firstError;
+        firstError = nullptr;
+    }
+    if (error) rethrow_exception(error);
+}
+
+void WorkerPool::runTasks() {
+    while (true) {
+        size_t index = nextIndex.fetch_add(1);
+        if (index >= taskCount) return;
+        try {
+            (*task)(index);
+        } catch (...) {
+            lock_guard<mutex> lock(stateMutex);
+            if (!firstError) firstError = current_exception();
+            nextIndex.store(taskCount);  // Stop handing out more work
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(stateMutex);
+            jobReady.wait(lock, [this, seenGeneration] {
+                return stopping || generation != seenGeneration;
+            });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runTasks();
+
+        {
+            lock_guard<mutex> lock(stateMutex);
+            pendingWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
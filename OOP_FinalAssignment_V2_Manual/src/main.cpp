@@ -15,6 +15,7 @@
 #include "Tutorial.h"
 #include "Lab.h"
 #include "AdvancedScheduleAnalytics.h"
+#include "CsvReader.h"
 
 using namespace std;
 
@@ -53,102 +54,71 @@ public:
     }
 
     void loadCourses() {
-        ifstream file("data/courses.csv");
-        if (!file.is_open()) {
+        CsvReader reader("data/courses.csv");
+        if (!reader.isOpen()) {
             cout << "Error: Could not open courses.csv" << endl;
             return;
         }
 
-        string line;
-        getline(file, line); // Skip header
+        reader.nextRow(); // Skip header
 
-        while (getline(file, line)) {
-            if (line.empty()) continue;
-            
-            stringstream ss(line);
-            string item;
-            vector<string> tokens;
-
-            // Simple CSV parser that handles quoted fields
-            bool inQuotes = false;
-            string currentToken = "";
-            
-            for (char c : line) {
-                if (c == '"') {
-                    inQuotes = !inQuotes;
-                } else if (c == ',' && !inQuotes) {
-                    tokens.push_back(currentToken);
-                    currentToken = "";
-                } else {
-                    currentToken += c;
-                }
-            }
-            tokens.push_back(currentToken); // Add the last token
-
-            if (tokens.size() >= 10) {
+        while (reader.nextRow()) {
+            // The reader already handles quoted fields
+            if (reader.fieldCount() >= 10) {
                 try {
-                    int id = stoi(tokens[0]);
-                    string name = tokens[1];
+                    int id = reader[0].toInt();
+                    string name = reader[1].str();
                     
                     // Parse exam dates from separate day/month/year fields
                     string examDateA = "";
                     string examDateB = "";
                     
                     // Construct Exam Date A (DD/MM/YYYY format)
-                    if (!tokens[2].empty() && !tokens[3].empty() && !tokens[4].empty()) {
-                        examDateA = tokens[2] + "/" + tokens[3] + "/" + tokens[4];
+                    if (!reader[2].empty() && !reader[3].empty() && !reader[4].empty()) {
+                        examDateA = reader[2].str() + "/" + reader[3].str() + "/" + reader[4].str();
                     }
                     
                     // Construct Exam Date B (DD/MM/YYYY format)
-                    if (!tokens[5].empty() && !tokens[6].empty() && !tokens[7].empty()) {
-                        examDateB = tokens[5] + "/" + tokens[6] + "/" + tokens[7];
+                    if (!reader[5].empty() && !reader[6].empty() && !reader[7].empty()) {
+                        examDateB = reader[5].str() + "/" + reader[6].str() + "/" + reader[7].str();
                     }
                     
-                    int credits = stoi(tokens[8]);  // Credits are in column 8
-                    string lecturer = tokens[9];   // Lecturer is in column 9
+                    int credits = reader[8].toInt();      // Credits are in column 8
+                    string lecturer = reader[9].str();    // Lecturer is in column 9
 
                     courses.emplace_back(id, name, credits, examDateA, examDateB, lecturer);
                 } catch (const invalid_argument& e) {
-                    cout << "Error parsing course data: " << line << endl;
+                    cout << "Error parsing course data: " << reader.row().str() << endl;
                     continue;
                 } catch (const out_of_range& e) {
-                    cout << "Number out of range in course data: " << line << endl;
+                    cout << "Number out of range in course data: " << reader.row().str() << endl;
                     continue;
                 }
             }
         }
-        file.close();
+        reader.close();
         cout << "Loaded " << courses.size() << " courses." << endl;
     }
 
     void loadLessonsFromFile(const string& filename, const string& type) {
-        ifstream file(filename);
-        if (!file.is_open()) {
+        CsvReader reader(filename);
+        if (!reader.isOpen()) {
             return; // File doesn't exist, skip
         }
 
-        string line;
-        getline(file, line); // Skip header
-
-        while (getline(file, line)) {
-            stringstream ss(line);
-            string item;
-            vector<string> tokens;
-
-            while (getline(ss, item, ',')) {
-                tokens.push_back(item);
-            }
+        reader.nextRow(); // Skip header
 
-            if (tokens.size() >= 8) {
+        while (reader.nextRow()) {
+            if (reader.fieldCount() >= 8) {
                 try {
-                    int courseId = stoi(tokens[0]);
-                    string day = tokens[1];
-                    string startTime = tokens[2];
-                    int duration = stoi(tokens[3]);
-                    string classroom = tokens[4];
-                    string building = tokens[5];
-                    string teacher = tokens[6];
-                    string groupId = tokens[7]; // Keep the original group ID as string
+                    int courseId = reader[0].toInt();
+                    string day = reader[1].str();
+                    string startTime = reader[2].str();
+                    int duration = reader[3].toInt();
+                    string classroom = reader[4].str();
+                    string building = reader[5].str();
+                    string teacher = reader[6].str();
+                    string groupId = reader[7].str(); // Keep the original group ID as string
 
                     shared_ptr<Lesson> lesson;
                     if (type == "lecture") {
@@ -163,15 +133,15 @@ public:
                         courseLessons[courseId].push_back(lesson);
                     }
                 } catch (const invalid_argument& e) {
-                    cout << "Error parsing lesson data in " << filename << ": " << line << endl;
+                    cout << "Error parsing lesson data in " << filename << ": " << reader.row().str() << endl;
                     continue;
                 } catch (const out_of_range& e) {
-                    cout << "Number out of range in lesson data in " << filename << ": " << line << endl;
+                    cout << "Number out of range in lesson data in " << filename << ": " << reader.row().str() << endl;
                     continue;
                 }
             }
         }
-        file.close();
+        reader.close();
     }
 
     void loadLessons() {
@@ -187,29 +157,26 @@ public:
     }
 
     void loadSchedules() {
-        ifstream file("data/schedules.csv");
-        if (!file.is_open()) {
+        CsvReader reader("data/schedules.csv");
+        if (!reader.isOpen()) {
             return;
         }
 
-        string line;
-        getline(file, line); // Skip header
+        reader.nextRow(); // Skip header
 
-        while (getline(file, line)) {
-            if (!line.empty()) {
-                try {
-                    int id = stoi(line);
-                    schedules.emplace_back(id);
-                } catch (const invalid_argument& e) {
-                    cout << "Error parsing schedule ID: " << line << endl;
-                    continue;
-                } catch (const out_of_range& e) {
-                    cout << "Schedule ID out of range: " << line << endl;
-                    continue;
-                }
+        while (reader.nextRow()) {
+            try {
+                int id = reader[0].toInt();
+                schedules.emplace_back(id);
+            } catch (const invalid_argument& e) {
+                cout << "Error parsing schedule ID: " << reader.row().str() << endl;
+                continue;
+            } catch (const out_of_range& e) {
+                cout << "Schedule ID out of range: " << reader.row().str() << endl;
+                continue;
             }
         }
-        file.close();
+        reader.close();
     }
 
     void saveSchedules() {
@@ -229,42 +196,19 @@ public:
             int scheduleId = schedule.getScheduleId();
             string scheduleFilename = "data/schedule_" + to_string(scheduleId) + ".csv";
             
-            ifstream file(scheduleFilename);
-            if (!file.is_open()) {
+            CsvReader reader(scheduleFilename);
+            if (!reader.isOpen()) {
                 continue; // File doesn't exist, schedule is empty
             }
 
-            string line;
-            getline(file, line); // Skip header
-
-            while (getline(file, line)) {
-                if (line.empty()) continue;
-                
-                stringstream ss(line);
-                string item;
-                vector<string> tokens;
-
-                // Simple CSV parser
-                bool inQuotes = false;
-                string currentToken = "";
-                
-                for (char c : line) {
-                    if (c == '"') {
-                        inQuotes = !inQuotes;
-                    } else if (c == ',' && !inQuotes) {
-                        tokens.push_back(currentToken);
-                        currentToken = "";
-                    } else {
-                        currentToken += c;
-                    }
-                }
-                tokens.push_back(currentToken); // Add the last token
+            reader.nextRow(); // Skip header
 
-                if (tokens.size() >= 10) {
+            while (reader.nextRow()) {
+                if (reader.fieldCount() >= 10) {
                     try {
                         // Parse with correct field order: ScheduleID,LessonType,CourseID,Day,StartTime,Duration,Classroom,Building,Teacher,GroupID
-                        int courseId = stoi(tokens[2]);     // CourseID (index 2)
-                        string groupId = tokens[9];         // GroupID (index 9)
+                        int courseId = reader[2].toInt();   // CourseID (index 2)
+                        string groupId = reader[9].str();   // GroupID (index 9)
                         
                         // Find the lesson in our loaded lessons
                         if (courseLessons.find(courseId) != courseLessons.end()) {
@@ -283,7 +227,7 @@ public:
                     }
                 }
             }
-            file.close();
+            reader.close();
         }
         cout << "Loaded schedule data for existing schedules." << endl;
     }
@@ -877,7 +821,7 @@ public:
         cout << "                          ADVANCED ANALYTICS                              " << endl;
         cout << "===========================================================================" << endl;
         cout << "  [12] ConflictAnalysis <sched_id> - AI-powered conflict detection       " << endl;
-        cout << "  [13] OptimalGeneration <credits> [tolerance] - AI schedule optimization" << endl;
+        cout << "  [13] OptimalGeneration <credits> [tol] [seed] - AI schedule optimization" << endl;
         cout << "  [14] AcademicAnalytics <sched>   - ML-based performance analysis       " << endl;
         cout << "===========================================================================" << endl;
         cout << "                          SYSTEM TESTING SUITE                            " << endl;
@@ -1006,11 +950,12 @@ public:
             }
             else if (command == "13") {
                 double targetCredits, tolerance = 1.0;
+                unsigned int seed = 0;
                 if (ss >> targetCredits) {
-                    ss >> tolerance; // Optional parameter
-                    analytics.aiOptimalScheduleGeneration(targetCredits, tolerance);
+                    ss >> tolerance >> seed; // Optional parameters
+                    analytics.aiOptimalScheduleGeneration(targetCredits, tolerance, seed);
                 } else {
-                    cout << "Usage: OptimalGeneration <target_credits> [tolerance]" << endl;
+                    cout << "Usage: OptimalGeneration <target_credits> [tolerance] [seed]" << endl;
                     cout << "Example: OptimalGeneration 15 1.0" << endl;
                 }
             }
@@ -1114,12 +1059,13 @@ public:
             }
             else if (command == "OptimalGeneration") {
                 double targetCredits, tolerance = 1.0;
+                unsigned int seed = 0;
                 if (ss >> targetCredits) {
-                    ss >> tolerance; // Optional parameter
+                    ss >> tolerance >> seed; // Optional parameters
                     AdvancedScheduleAnalytics analytics;
-                    analytics.aiOptimalScheduleGeneration(targetCredits, tolerance);
+                    analytics.aiOptimalScheduleGeneration(targetCredits, tolerance, seed);
                 } else {
-                    cout << "Usage: OptimalGeneration <target_credits> [tolerance]" << endl;
+                    cout << "Usage: OptimalGeneration <target_credits> [tolerance] [seed]" << endl;
                     cout << "Example: OptimalGeneration 15 1.0" << endl;
                 }
             }